@@ -0,0 +1,37 @@
+#ifndef MISO_COOKED_TEXTURE_H
+#define MISO_COOKED_TEXTURE_H
+
+// Layout of cooked texture blobs (.mtex), shared by the cooker (tools/asset_cook.c) and the renderer's loader
+// (renderer/cooked_texture.c). Plain C, no SDL.
+//
+// A blob is this header followed, at data_offset, by the pixels exactly as the GPU texture wants them: the loader maps
+// the file and uploads straight from the mapping, with no decode and no conversion. All fields are little-endian.
+// Bump COOKED_TEXTURE_VERSION on any layout change.
+
+#include <stdint.h>
+
+#define COOKED_TEXTURE_MAGIC 0x5845544Du // "MTEX"
+#define COOKED_TEXTURE_VERSION 1u
+#define COOKED_TEXTURE_EXTENSION ".mtex"
+#define COOKED_TEXTURE_DATA_ALIGN 4096u // pixels start on a page boundary of the mapping
+
+typedef enum CookedTextureFormat {
+    COOKED_TEXTURE_FORMAT_RGBA8 = 1, // bytes R, G, B, A: SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM
+} CookedTextureFormat;
+
+typedef struct CookedTextureHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format; // CookedTextureFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;       // bytes between rows
+    uint32_t tile_width;  // tile grid the image was cooked for, 0 if it is not a tileset
+    uint32_t tile_height;
+    uint64_t data_offset; // from the start of the file
+    uint64_t data_size;
+} CookedTextureHeader;
+
+static_assert(sizeof(CookedTextureHeader) == 48, "CookedTextureHeader is a file format, keep it packed");
+
+#endif // MISO_COOKED_TEXTURE_H
@@ -9,6 +9,7 @@
 #define NK_INCLUDE_FONT_BAKING
 #define NK_INCLUDE_DEFAULT_FONT
 #define NK_INCLUDE_COMMAND_USERDATA
+#define NK_ZERO_COMMAND_MEMORY // the backend memcmp's the command buffer, padding bytes must not differ between frames
 #define NK_IMPLEMENTATION
 #include "vendored/nuklear/nuklear.h"
 
@@ -145,21 +146,6 @@ void DebugUI_Render(void) {
     if (!initialized || !nk_ctx)
         return;
 
-    SDL_GPUCommandBuffer *const cmd = Renderer_GetCommandBuffer();
-    SDL_GPUTexture *const swapchain = Renderer_GetSwapchainTexture();
-
-    if (!cmd || !swapchain) {
-        // Still need to clear Nuklear state even if we can't render
-        nk_clear(nk_ctx);
-        return;
-    }
-
-    // End any active render pass before Nuklear renders
-    Renderer_EndRenderPass();
-
-    // Render Nuklear UI
-    nk_sdl_gpu_render(nk_ctx, cmd, swapchain, NK_ANTI_ALIASING_ON);
-
-    // Resume render pass for any subsequent rendering
-    Renderer_ResumeRenderPass();
+    // Queued into the renderer's UI pass; outside of a frame it is dropped and Nuklear state still gets cleared
+    nk_sdl_gpu_render(nk_ctx, NK_ANTI_ALIASING_ON);
 }
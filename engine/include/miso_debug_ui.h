@@ -14,7 +14,6 @@ void miso_debug_ui_shutdown(void);
 void miso_debug_ui_begin_input(void);
 void miso_debug_ui_end_input(void);
 bool miso_debug_ui_feed_event(const MisoEvent *event);
-void miso_debug_ui_prepare_render(const MisoEngine *engine);
 
 struct nk_context *miso_debug_ui_get_context(void);
 float miso_debug_ui_get_scale(void);
@@ -17,6 +17,11 @@ typedef struct MisoConfig {
     bool enable_vsync;
     int sim_tick_hz;
     int max_sim_steps_per_frame;
+    // Wall-clock budget for all sim steps in one frame. <= 0 only limits by max_sim_steps_per_frame.
+    float sim_frame_budget_ms;
+    // Publish live frame, renderer and sim stats to this POSIX shared-memory segment (e.g. "/miso_stats") for
+    // tools/miso_stats_reader. NULL disables the export.
+    const char *stats_shm_name;
 } MisoConfig;
 
 typedef enum MisoResult {
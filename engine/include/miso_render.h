@@ -13,8 +13,11 @@ typedef enum MisoRenderStatsQueueKind {
     MISO_RENDER_STATS_QUEUE_SPRITE = 0,
     MISO_RENDER_STATS_QUEUE_WORLD_GEOMETRY,
     MISO_RENDER_STATS_QUEUE_LINE,
+    MISO_RENDER_STATS_QUEUE_WIREFRAME,
+    MISO_RENDER_STATS_QUEUE_SDF_TEXT,
     MISO_RENDER_STATS_QUEUE_UI_GEOMETRY,
     MISO_RENDER_STATS_QUEUE_UI_TEXT,
+    MISO_RENDER_STATS_QUEUE_DEBUG_UI,
     MISO_RENDER_STATS_QUEUE_COUNT
 } MisoRenderStatsQueueKind;
 
@@ -22,9 +25,14 @@ typedef enum MisoRenderStatsStreamKind {
     MISO_RENDER_STATS_STREAM_SPRITE = 0,
     MISO_RENDER_STATS_STREAM_WORLD_GEOMETRY,
     MISO_RENDER_STATS_STREAM_LINE,
+    MISO_RENDER_STATS_STREAM_WIREFRAME,
+    MISO_RENDER_STATS_STREAM_SDF_TEXT,
     MISO_RENDER_STATS_STREAM_UI_GEOMETRY,
     MISO_RENDER_STATS_STREAM_UI_TEXT_VERT,
     MISO_RENDER_STATS_STREAM_UI_TEXT_INDEX,
+    MISO_RENDER_STATS_STREAM_DEBUG_UI_VERT,
+    MISO_RENDER_STATS_STREAM_DEBUG_UI_INDEX,
+    MISO_RENDER_STATS_STREAM_UI_BLOCK,
     MISO_RENDER_STATS_STREAM_COUNT
 } MisoRenderStatsStreamKind;
 
@@ -73,6 +81,18 @@ typedef struct MisoSpriteInstance {
     float vh;
 } MisoSpriteInstance;
 
+// A sprite packed into one of the engine's shared atlas pages. Sprites on the same page share `texture`, so
+// consecutive miso_render_submit_sprites calls for them merge into a single draw. Copy u/v/uw/vh into the instances.
+typedef struct MisoSpriteRegion {
+    MisoTextureHandle texture;
+    float u;
+    float v;
+    float uw;
+    float vh;
+    float width; // pixels
+    float height;
+} MisoSpriteRegion;
+
 typedef struct MisoWorldVertex {
     float x;
     float y;
@@ -82,8 +102,22 @@ typedef struct MisoWorldVertex {
     float a;
 } MisoWorldVertex;
 
+// Same layout as the renderer's line vertex: position plus an 8-bit RGBA color.
+typedef struct MisoLineVertex {
+    float x;
+    float y;
+    float z;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+} MisoLineVertex;
+
 MisoResult miso_render_load_texture(const MisoEngine *engine, const char *path, MisoTextureHandle *out_texture);
 void miso_render_destroy_texture(const MisoEngine *engine, MisoTextureHandle texture);
+// Packs the image into the sprite atlas instead of giving it a texture of its own. Atlas pages are not destroyed by
+// miso_render_destroy_texture, they are released with the engine.
+MisoResult miso_render_load_sprite(const MisoEngine *engine, const char *path, MisoSpriteRegion *out_region);
 MisoResult miso_render_load_font(
     const MisoEngine *engine, const char *path, float point_size, MisoFontHandle *out_font);
 void miso_render_destroy_font(const MisoEngine *engine, MisoFontHandle font);
@@ -96,6 +130,8 @@ void miso_render_submit_sprites(const MisoEngine *engine,
                                 const MisoSpriteInstance *instances,
                                 int count);
 void miso_render_submit_world_geometry(const MisoEngine *engine, const MisoWorldVertex *vertices, int count);
+// Line segments (vertices 2n, 2n+1), batched into as few draws as possible.
+void miso_render_submit_world_lines(const MisoEngine *engine, const MisoLineVertex *vertices, int count);
 void miso_render_end_world(const MisoEngine *engine);
 
 void miso_render_begin_ui(const MisoEngine *engine);
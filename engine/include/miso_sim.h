@@ -0,0 +1,55 @@
+#ifndef MISO_SIM_H
+#define MISO_SIM_H
+
+#include "miso_engine.h"
+
+#include <stdint.h>
+
+typedef uint32_t MisoSimSystemId;
+
+typedef uint32_t (*MisoSimSystemCountFn)(void *user);
+// Processes items [first, first + count). elapsed_seconds is the sim time covered by the last full pass over all
+// items, i.e. roughly how long ago these items were last visited.
+typedef void (*MisoSimSystemSliceFn)(void *user, uint32_t first, uint32_t count, float elapsed_seconds);
+
+typedef struct MisoSimSystemDesc {
+    const char *name;
+    MisoSimSystemCountFn get_item_count;
+    MisoSimSystemSliceFn run_slice;
+    void *user;
+    // Per-tick time budget. <= 0 runs every item on every tick.
+    float budget_ms;
+    uint32_t min_items_per_tick;
+} MisoSimSystemDesc;
+
+typedef struct MisoSimSystemStats {
+    const char *name;
+    uint32_t item_count;
+    uint32_t items_per_tick;
+    uint32_t cursor;
+    float last_tick_ms;
+    float ms_per_item;
+    float last_pass_seconds;
+    uint32_t last_pass_ticks;
+    uint64_t passes_completed;
+} MisoSimSystemStats;
+
+typedef struct MisoSimStats {
+    uint64_t tick_count;
+    uint32_t steps_last_frame;
+    float sim_ms_last_frame;
+    float dropped_ms_last_frame;
+    double dropped_seconds_total;
+    uint32_t frames_dropped;
+    bool budget_limited;
+    bool behind;
+} MisoSimStats;
+
+MisoSimSystemId miso_sim_system_register(MisoEngine *engine, const MisoSimSystemDesc *desc);
+void miso_sim_system_unregister(MisoEngine *engine, MisoSimSystemId system_id);
+void miso_sim_system_set_budget(MisoEngine *engine, MisoSimSystemId system_id, float budget_ms);
+bool miso_sim_system_get_stats(const MisoEngine *engine, MisoSimSystemId system_id, MisoSimSystemStats *out_stats);
+
+void miso_get_sim_stats(const MisoEngine *engine, MisoSimStats *out_stats);
+
+#endif
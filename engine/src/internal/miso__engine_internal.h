@@ -3,6 +3,7 @@
 
 #include "miso_camera.h"
 #include "miso_engine.h"
+#include "miso_sim.h"
 
 #include <SDL3/SDL.h>
 
@@ -15,6 +16,19 @@ typedef struct MisoCameraState {
     bool pixel_snap;
 } MisoCameraState;
 
+typedef struct MisoSimSystemState {
+    bool used;
+    uint32_t generation; // bumped on unregister, part of the system's id
+    MisoSimSystemDesc desc;
+    uint32_t items_per_tick;
+    uint32_t cursor;
+    float last_tick_ms;
+    float ms_per_item;
+    uint64_t pass_start_tick;
+    uint32_t last_pass_ticks;
+    uint64_t passes_completed;
+} MisoSimSystemState;
+
 struct MisoEngine {
     MisoConfig config;
     SDL_Window *window;
@@ -24,6 +38,12 @@ struct MisoEngine {
     uint64_t last_counter;
     float real_dt_seconds;
     double sim_accumulator;
+    MisoSimStats sim_stats;
+
+    MisoSimSystemState *sim_systems;
+    uint32_t sim_system_capacity;
+    uint32_t sim_system_count;
+    bool sim_systems_ticking; // free slots are not reused while run_slice callbacks may still hold their ids
 
     MisoGameHooks game_hooks;
     void *game_ctx;
@@ -39,5 +59,6 @@ MisoCameraState *miso__camera_get(MisoEngine *engine, MisoCameraId id);
 const MisoCameraState *miso__camera_get_const(const MisoEngine *engine, MisoCameraId id);
 void miso__camera_get_view_projection(const MisoEngine *engine, MisoCameraId id, float out_matrix[16]);
 void miso__render_shutdown(void);
+void miso__sim_systems_tick(MisoEngine *engine, float fixed_dt_seconds);
 
 #endif
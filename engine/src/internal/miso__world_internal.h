@@ -2,6 +2,7 @@
 #define MISO__WORLD_INTERNAL_H
 
 #include "miso_buildings.h"
+#include "miso_sim.h"
 
 typedef struct MisoBuildingRecord {
     MisoBuildingId id;
@@ -22,6 +23,8 @@ struct MisoWorld {
     uint32_t building_count;
     uint32_t building_capacity;
     uint32_t next_building_id;
+
+    MisoSimSystemId footprint_audit;
 };
 
 #endif
@@ -204,11 +204,6 @@ bool miso_debug_ui_feed_event(const MisoEvent *event) {
     return nk_item_is_any_active(ctx) || nk_window_is_any_hovered(ctx);
 }
 
-void miso_debug_ui_prepare_render(const MisoEngine *engine) {
-    (void)engine;
-    Renderer_EndRenderPass();
-}
-
 struct nk_context *miso_debug_ui_get_context(void) {
     return DebugUI_GetContext();
 }
@@ -4,8 +4,10 @@
 #include "logger.h"
 #include "miso_events.h"
 #include "miso_render.h"
+#include "profiler.h"
 #include "renderer/renderer.h"
 #include "renderer/ui.h"
+#include "stats_export.h"
 
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
@@ -20,6 +22,8 @@ static MisoConfig miso__default_config(void) {
         .enable_vsync = true,
         .sim_tick_hz = 20,
         .max_sim_steps_per_frame = 8,
+        .sim_frame_budget_ms = 0.0f,
+        .stats_shm_name = NULL,
     };
     return cfg;
 }
@@ -135,6 +139,7 @@ MisoResult miso_create(const MisoConfig *cfg, MisoEngine **out_engine) {
         SDL_free(engine);
         return MISO_ERR_INIT;
     }
+    PROF_init(); // before Renderer_Init starts the texture loader threads
 
     engine->window = SDL_CreateWindow(engine->config.window_title,
                                       engine->config.window_width,
@@ -169,6 +174,10 @@ MisoResult miso_create(const MisoConfig *cfg, MisoEngine **out_engine) {
         return MISO_ERR_OUT_OF_MEMORY;
     }
 
+    if (engine->config.stats_shm_name) {
+        STATS_exportOpen(engine->config.stats_shm_name); // optional, logs and carries on if unavailable
+    }
+
     *out_engine = engine;
     return MISO_OK;
 }
@@ -178,14 +187,17 @@ void miso_destroy(MisoEngine *engine) {
         return;
     }
 
+    STATS_exportClose();
     UI_Shutdown();
     miso__render_shutdown();
     Renderer_Shutdown();
+    PROF_shutdown();
 
     if (engine->window) {
         SDL_DestroyWindow(engine->window);
     }
 
+    SDL_free(engine->sim_systems);
     SDL_free(engine->cameras);
     SDL_Quit();
     SDL_free(engine);
@@ -196,6 +208,9 @@ bool miso_begin_frame(MisoEngine *engine) {
         return false;
     }
 
+    // the profiler frame spans the game's update and the render in miso_end_frame, as in the main.c loop
+    PROF_frameStart();
+
     const uint64_t now = SDL_GetPerformanceCounter();
     const uint64_t delta = now - engine->last_counter;
     engine->last_counter = now;
@@ -223,7 +238,25 @@ void miso_end_frame(MisoEngine *engine) {
         engine->game_hooks.on_render_debug(engine->game_ctx, engine);
     }
 
+    PROF_start(PROFILER_GPU);
     Renderer_EndFrame();
+    PROF_stop(PROFILER_GPU);
+    PROF_frameEnd();
+
+    if (STATS_exportIsOpen()) {
+        const MisoSimStats *const sim = &engine->sim_stats;
+        const StatsShmSim sim_export = {
+            .steps_last_frame = sim->steps_last_frame,
+            .tick_count = sim->tick_count,
+            .sim_ms_last_frame = sim->sim_ms_last_frame,
+            .dropped_ms_last_frame = sim->dropped_ms_last_frame,
+            .dropped_seconds_total = sim->dropped_seconds_total,
+            .frames_dropped = sim->frames_dropped,
+            .behind = sim->behind ? 1U : 0U,
+        };
+        STATS_exportSetSim(&sim_export);
+        STATS_exportPublish();
+    }
 }
 
 void miso_get_window_size_pixels(const MisoEngine *engine, int *out_width, int *out_height) {
@@ -246,9 +279,21 @@ void miso_run_simulation_ticks(MisoEngine *engine, MisoSimTickFn tick_fn, void *
     }
 
     const double fixed_step = 1.0 / (double)engine->config.sim_tick_hz;
+    const uint64_t budget_counts =
+        engine->config.sim_frame_budget_ms > 0.0f
+            ? (uint64_t)((double)engine->config.sim_frame_budget_ms * (double)engine->perf_frequency / 1000.0)
+            : 0;
+    const uint64_t start = SDL_GetPerformanceCounter();
+    uint64_t now = start;
     int steps = 0;
+    bool budget_limited = false;
 
     while (engine->sim_accumulator >= fixed_step && steps < engine->config.max_sim_steps_per_frame) {
+        if (budget_counts > 0 && steps > 0 && now - start >= budget_counts) {
+            budget_limited = true;
+            break;
+        }
+
         const float fixed_dt = (float)fixed_step;
         if (tick_fn) {
             tick_fn(user, fixed_dt);
@@ -256,14 +301,49 @@ void miso_run_simulation_ticks(MisoEngine *engine, MisoSimTickFn tick_fn, void *
         if (engine->game_registered && engine->game_hooks.on_sim_tick) {
             engine->game_hooks.on_sim_tick(engine->game_ctx, fixed_dt);
         }
+        miso__sim_systems_tick(engine, fixed_dt);
 
         engine->sim_accumulator -= fixed_step;
+        engine->sim_stats.tick_count++;
         steps++;
+        now = SDL_GetPerformanceCounter();
     }
 
+    // Whatever could not be simulated this frame is dropped rather than carried over, otherwise a slow tick keeps the
+    // next frame at the step cap too and the sim never catches up. The sub-step remainder stays for interpolation.
+    double dropped = 0.0;
+    if (engine->sim_accumulator >= fixed_step) {
+        const double remainder = SDL_fmod(engine->sim_accumulator, fixed_step);
+        dropped = engine->sim_accumulator - remainder;
+        engine->sim_accumulator = remainder;
+    }
     if (engine->sim_accumulator < 0.0) {
         engine->sim_accumulator = 0.0;
     }
+
+    MisoSimStats *stats = &engine->sim_stats;
+    stats->steps_last_frame = (uint32_t)steps;
+    stats->sim_ms_last_frame = (float)((double)(now - start) * 1000.0 / (double)engine->perf_frequency);
+    stats->dropped_ms_last_frame = (float)(dropped * 1000.0);
+    stats->budget_limited = budget_limited;
+
+    const bool behind = dropped > 0.0;
+    if (behind) {
+        stats->dropped_seconds_total += dropped;
+        stats->frames_dropped++;
+        if (!stats->behind) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                        "Simulation falling behind: dropped %.2f ms after %d steps (%s)",
+                        dropped * 1000.0,
+                        steps,
+                        budget_limited ? "frame budget" : "step cap");
+        }
+    } else if (stats->behind) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+                    "Simulation caught up, %.2f s dropped in total",
+                    stats->dropped_seconds_total);
+    }
+    stats->behind = behind;
 }
 
 float miso_get_real_delta_seconds(const MisoEngine *engine) {
@@ -2,6 +2,7 @@
 
 #include "internal/miso__engine_internal.h"
 #include "renderer/renderer.h"
+#include "renderer/sprite_atlas.h"
 #include "renderer/ui.h"
 
 #include <SDL3/SDL.h>
@@ -9,14 +10,45 @@
 
 #define MISO_TEXTURE_TABLE_MAX 4096U
 #define MISO_FONT_TABLE_MAX 256U
+#define MISO_TEXT_CACHE_CAPACITY 1024U
+#define MISO_TEXT_CACHE_BUCKETS 2048U // power of two
+#define MISO_SPRITE_ATLAS_PAGE_SIZE 2048
+
+typedef struct MisoTextureEntry {
+    SDL_GPUTexture *texture;
+    bool atlas_page; // owned by g_sprite_atlas, shared by every sprite packed into it
+} MisoTextureEntry;
 
 typedef struct MisoFontEntry {
     TTF_Font *font;
-    TTF_Text *text;
 } MisoFontEntry;
 
-static SDL_GPUTexture *g_texture_table[MISO_TEXTURE_TABLE_MAX] = {0};
+// Shaped labels keyed by (font, string). A TTF_Text keeps its glyph layout until its string changes, so a label
+// submitted with the same text every frame is shaped once and only its cached draw data is read afterwards.
+// Links are entry index + 1, 0 ends a list.
+typedef struct MisoTextCacheEntry {
+    TTF_Text *text;
+    char *string;
+    uint64_t hash;
+    MisoFontHandle font;
+    uint32_t bucket_next; // hash chain, or free list while unused
+    uint32_t lru_prev;    // towards the most recently used entry
+    uint32_t lru_next;
+} MisoTextCacheEntry;
+
+typedef struct MisoTextCache {
+    MisoTextCacheEntry entries[MISO_TEXT_CACHE_CAPACITY];
+    uint32_t buckets[MISO_TEXT_CACHE_BUCKETS];
+    uint32_t used;      // entries ever handed out, the rest were never touched
+    uint32_t free_head; // entries released by miso_render_destroy_font
+    uint32_t lru_head;
+    uint32_t lru_tail;
+} MisoTextCache;
+
+static MisoTextureEntry g_texture_table[MISO_TEXTURE_TABLE_MAX] = {0};
+static SpriteAtlas *g_sprite_atlas = NULL;
 static MisoFontEntry g_font_table[MISO_FONT_TABLE_MAX] = {0};
+static MisoTextCache g_text_cache = {0};
 static SDL_Vertex *g_world_geometry_scratch = NULL;
 static int g_world_geometry_scratch_capacity = 0;
 
@@ -28,6 +60,137 @@ static SDL_FColor miso__color_from_rgba8(const uint32_t rgba8) {
     return (SDL_FColor){r, g, b, a};
 }
 
+static uint64_t miso__text_hash(const MisoFontHandle font, const char *text) {
+    // FNV-1a, seeded with the font so equal strings in different fonts land in different buckets
+    uint64_t hash = 14695981039346656037ULL ^ font;
+    for (; *text; text++) {
+        hash ^= (uint8_t)*text;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void miso__text_lru_unlink(const uint32_t link) {
+    MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+    if (entry->lru_prev) {
+        g_text_cache.entries[entry->lru_prev - 1].lru_next = entry->lru_next;
+    } else {
+        g_text_cache.lru_head = entry->lru_next;
+    }
+    if (entry->lru_next) {
+        g_text_cache.entries[entry->lru_next - 1].lru_prev = entry->lru_prev;
+    } else {
+        g_text_cache.lru_tail = entry->lru_prev;
+    }
+    entry->lru_prev = 0;
+    entry->lru_next = 0;
+}
+
+static void miso__text_lru_push_front(const uint32_t link) {
+    MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+    entry->lru_prev = 0;
+    entry->lru_next = g_text_cache.lru_head;
+    if (g_text_cache.lru_head) {
+        g_text_cache.entries[g_text_cache.lru_head - 1].lru_prev = link;
+    } else {
+        g_text_cache.lru_tail = link;
+    }
+    g_text_cache.lru_head = link;
+}
+
+static void miso__text_bucket_unlink(const uint32_t link) {
+    const MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+    uint32_t *cursor = &g_text_cache.buckets[entry->hash & (MISO_TEXT_CACHE_BUCKETS - 1)];
+    while (*cursor && *cursor != link) {
+        cursor = &g_text_cache.entries[*cursor - 1].bucket_next;
+    }
+    if (*cursor) {
+        *cursor = entry->bucket_next;
+    }
+}
+
+static void miso__text_cache_release(const uint32_t link) {
+    MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+    miso__text_bucket_unlink(link);
+    miso__text_lru_unlink(link);
+    TTF_DestroyText(entry->text);
+    SDL_free(entry->string);
+    *entry = (MisoTextCacheEntry){.bucket_next = g_text_cache.free_head};
+    g_text_cache.free_head = link;
+}
+
+static TTF_Text *miso__text_cache_get(const MisoFontHandle font, const char *text) {
+    const uint64_t hash = miso__text_hash(font, text);
+    uint32_t *bucket = &g_text_cache.buckets[hash & (MISO_TEXT_CACHE_BUCKETS - 1)];
+
+    for (uint32_t link = *bucket; link; link = g_text_cache.entries[link - 1].bucket_next) {
+        MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+        if (entry->hash == hash && entry->font == font && SDL_strcmp(entry->string, text) == 0) {
+            if (g_text_cache.lru_head != link) {
+                miso__text_lru_unlink(link);
+                miso__text_lru_push_front(link);
+            }
+            return entry->text;
+        }
+    }
+
+    char *string = SDL_strdup(text);
+    if (!string) {
+        return NULL;
+    }
+
+    // miss: take a released entry, then a fresh one, then recycle the least recently used label's TTF_Text
+    uint32_t link = g_text_cache.free_head;
+    if (link) {
+        g_text_cache.free_head = g_text_cache.entries[link - 1].bucket_next;
+    } else if (g_text_cache.used < MISO_TEXT_CACHE_CAPACITY) {
+        link = ++g_text_cache.used;
+    } else {
+        link = g_text_cache.lru_tail;
+        miso__text_bucket_unlink(link);
+        miso__text_lru_unlink(link);
+        SDL_free(g_text_cache.entries[link - 1].string);
+        g_text_cache.entries[link - 1].string = NULL;
+    }
+
+    MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+    TTF_Font *ttf_font = g_font_table[font].font;
+    bool ready;
+    if (entry->text) {
+        ready = (entry->font == font || TTF_SetTextFont(entry->text, ttf_font)) &&
+                TTF_SetTextString(entry->text, string, 0);
+    } else {
+        entry->text = TTF_CreateText(Renderer_GetTextEngine(), ttf_font, string, 0);
+        ready = entry->text != NULL;
+    }
+    if (!ready) {
+        if (entry->text) {
+            TTF_DestroyText(entry->text);
+        }
+        SDL_free(string);
+        *entry = (MisoTextCacheEntry){.bucket_next = g_text_cache.free_head};
+        g_text_cache.free_head = link;
+        return NULL;
+    }
+
+    entry->string = string;
+    entry->hash = hash;
+    entry->font = font;
+    entry->bucket_next = *bucket;
+    *bucket = link;
+    miso__text_lru_push_front(link);
+    return entry->text;
+}
+
+static void miso__text_cache_purge_font(const MisoFontHandle font) {
+    for (uint32_t link = 1; link <= g_text_cache.used; link++) {
+        const MisoTextCacheEntry *entry = &g_text_cache.entries[link - 1];
+        if (entry->string && (font == 0 || entry->font == font)) {
+            miso__text_cache_release(link);
+        }
+    }
+}
+
 static bool miso__ensure_world_geometry_scratch(const int vertex_count) {
     if (vertex_count <= 0) {
         return false;
@@ -51,6 +214,17 @@ static bool miso__ensure_world_geometry_scratch(const int vertex_count) {
     return true;
 }
 
+static bool miso__texture_register(SDL_GPUTexture *texture, const bool atlas_page, MisoTextureHandle *out_texture) {
+    for (uint32_t i = 1; i < MISO_TEXTURE_TABLE_MAX; i++) {
+        if (!g_texture_table[i].texture) {
+            g_texture_table[i] = (MisoTextureEntry){.texture = texture, .atlas_page = atlas_page};
+            *out_texture = i;
+            return true;
+        }
+    }
+    return false;
+}
+
 MisoResult miso_render_load_texture(const MisoEngine *engine, const char *path, MisoTextureHandle *out_texture) {
     (void)engine;
 
@@ -63,27 +237,67 @@ MisoResult miso_render_load_texture(const MisoEngine *engine, const char *path,
         return MISO_ERR_IO;
     }
 
-    for (uint32_t i = 1; i < MISO_TEXTURE_TABLE_MAX; i++) {
-        if (!g_texture_table[i]) {
-            g_texture_table[i] = texture;
-            *out_texture = i;
-            return MISO_OK;
-        }
+    if (!miso__texture_register(texture, false, out_texture)) {
+        Renderer_DestroyTexture(texture);
+        return MISO_ERR_OUT_OF_MEMORY;
     }
-
-    Renderer_DestroyTexture(texture);
-    return MISO_ERR_OUT_OF_MEMORY;
+    return MISO_OK;
 }
 
 void miso_render_destroy_texture(const MisoEngine *engine, const MisoTextureHandle texture) {
     (void)engine;
 
-    if (texture == 0 || texture >= MISO_TEXTURE_TABLE_MAX || !g_texture_table[texture]) {
+    // atlas pages live as long as the engine, the sprites packed into them keep using them
+    if (texture == 0 || texture >= MISO_TEXTURE_TABLE_MAX || !g_texture_table[texture].texture ||
+        g_texture_table[texture].atlas_page) {
         return;
     }
 
-    Renderer_DestroyTexture(g_texture_table[texture]);
-    g_texture_table[texture] = NULL;
+    Renderer_DestroyTexture(g_texture_table[texture].texture);
+    g_texture_table[texture] = (MisoTextureEntry){0};
+}
+
+MisoResult miso_render_load_sprite(const MisoEngine *engine, const char *path, MisoSpriteRegion *out_region) {
+    (void)engine;
+
+    if (!path || !out_region) {
+        return MISO_ERR_INVALID_ARG;
+    }
+
+    if (!g_sprite_atlas) {
+        g_sprite_atlas = SpriteAtlas_Create(MISO_SPRITE_ATLAS_PAGE_SIZE);
+        if (!g_sprite_atlas) {
+            return MISO_ERR_GPU;
+        }
+    }
+
+    const SpriteAtlasSprite sprite = SpriteAtlas_AddImage(g_sprite_atlas, path);
+    SpriteAtlasRegion region;
+    if (!sprite || !SpriteAtlas_GetRegion(g_sprite_atlas, sprite, &region)) {
+        return MISO_ERR_IO;
+    }
+
+    // a new page gets its own handle, later sprites on it reuse that handle
+    MisoTextureHandle page = 0;
+    for (uint32_t i = 1; i < MISO_TEXTURE_TABLE_MAX && !page; i++) {
+        if (g_texture_table[i].texture == region.texture) {
+            page = i;
+        }
+    }
+    if (!page && !miso__texture_register(region.texture, true, &page)) {
+        return MISO_ERR_OUT_OF_MEMORY;
+    }
+
+    *out_region = (MisoSpriteRegion){
+        .texture = page,
+        .u = region.u,
+        .v = region.v,
+        .uw = region.uw,
+        .vh = region.vh,
+        .width = (float)region.width,
+        .height = (float)region.height,
+    };
+    return MISO_OK;
 }
 
 MisoResult
@@ -94,8 +308,7 @@ miso_render_load_font(const MisoEngine *engine, const char *path, float point_si
         return MISO_ERR_INVALID_ARG;
     }
 
-    TTF_TextEngine *text_engine = Renderer_GetTextEngine();
-    if (!text_engine) {
+    if (!Renderer_GetTextEngine()) {
         return MISO_ERR_GPU;
     }
 
@@ -104,22 +317,14 @@ miso_render_load_font(const MisoEngine *engine, const char *path, float point_si
         return MISO_ERR_IO;
     }
 
-    TTF_Text *text = TTF_CreateText(text_engine, font, "", 0);
-    if (!text) {
-        TTF_CloseFont(font);
-        return MISO_ERR_GPU;
-    }
-
     for (uint32_t i = 1; i < MISO_FONT_TABLE_MAX; i++) {
         if (!g_font_table[i].font) {
             g_font_table[i].font = font;
-            g_font_table[i].text = text;
             *out_font = i;
             return MISO_OK;
         }
     }
 
-    TTF_DestroyText(text);
     TTF_CloseFont(font);
     return MISO_ERR_OUT_OF_MEMORY;
 }
@@ -131,12 +336,10 @@ void miso_render_destroy_font(const MisoEngine *engine, const MisoFontHandle fon
         return;
     }
 
-    if (g_font_table[font].text) {
-        TTF_DestroyText(g_font_table[font].text);
-    }
+    // cached labels reference the font
+    miso__text_cache_purge_font(font);
     TTF_CloseFont(g_font_table[font].font);
 
-    g_font_table[font].text = NULL;
     g_font_table[font].font = NULL;
 }
 
@@ -180,6 +383,9 @@ void miso_render_begin_world(MisoEngine *engine, const MisoCameraId camera_id) {
         return;
     }
 
+    // sprites loaded since the last frame are uploaded before anything samples their page
+    SpriteAtlas_Commit(g_sprite_atlas);
+
     float view_projection[16] = {0};
     miso__camera_get_view_projection(engine, camera_id, view_projection);
     Renderer_SetViewProjection(view_projection);
@@ -197,11 +403,12 @@ void miso_render_submit_sprites(const MisoEngine *engine,
                                 const int count) {
     (void)engine;
 
-    if (texture == 0 || texture >= MISO_TEXTURE_TABLE_MAX || !instances || count <= 0 || !g_texture_table[texture]) {
+    if (texture == 0 || texture >= MISO_TEXTURE_TABLE_MAX || !instances || count <= 0 ||
+        !g_texture_table[texture].texture) {
         return;
     }
 
-    Renderer_DrawSprites(g_texture_table[texture], (const SpriteInstance *)instances, count);
+    Renderer_DrawSprites(g_texture_table[texture].texture, (const SpriteInstance *)instances, count);
 }
 
 void miso_render_submit_world_geometry(const MisoEngine *engine, const MisoWorldVertex *vertices, int count) {
@@ -226,6 +433,17 @@ void miso_render_submit_world_geometry(const MisoEngine *engine, const MisoWorld
     Renderer_DrawGeometry(g_world_geometry_scratch, count);
 }
 
+static_assert(sizeof(MisoLineVertex) == sizeof(RendererLineVertex), "MisoLineVertex must match RendererLineVertex");
+
+void miso_render_submit_world_lines(const MisoEngine *engine, const MisoLineVertex *vertices, const int count) {
+    (void)engine;
+
+    if (!vertices || count < 2) {
+        return;
+    }
+    Renderer_DrawLines((const RendererLineVertex *)vertices, count);
+}
+
 void miso_render_end_world(const MisoEngine *engine) {
     (void)engine;
 }
@@ -247,17 +465,18 @@ void miso_render_submit_ui_text(const MisoEngine *engine,
                                 const float y,
                                 const uint32_t rgba8) {
     (void)engine;
-    (void)rgba8;
 
-    if (font == 0 || font >= MISO_FONT_TABLE_MAX || !text || !g_font_table[font].text) {
+    if (font == 0 || font >= MISO_FONT_TABLE_MAX || !text || !g_font_table[font].font) {
         return;
     }
     if (text[0] == '\0') {
         return;
     }
 
-    TTF_SetTextString(g_font_table[font].text, text, 0);
-    UI_Text(g_font_table[font].text, x, y);
+    TTF_Text *shaped = miso__text_cache_get(font, text);
+    if (shaped) {
+        UI_TextColored(shaped, x, y, miso__color_from_rgba8(rgba8));
+    }
 }
 
 void miso_render_end_ui(const MisoEngine *engine) {
@@ -267,20 +486,21 @@ void miso_render_end_ui(const MisoEngine *engine) {
 
 void miso__render_shutdown(void) {
     for (uint32_t i = 1; i < MISO_TEXTURE_TABLE_MAX; i++) {
-        if (g_texture_table[i]) {
-            Renderer_DestroyTexture(g_texture_table[i]);
-            g_texture_table[i] = NULL;
+        if (g_texture_table[i].texture && !g_texture_table[i].atlas_page) {
+            Renderer_DestroyTexture(g_texture_table[i].texture);
         }
+        g_texture_table[i] = (MisoTextureEntry){0};
     }
+    SpriteAtlas_Destroy(g_sprite_atlas);
+    g_sprite_atlas = NULL;
+
+    miso__text_cache_purge_font(0);
+    SDL_memset(&g_text_cache, 0, sizeof(g_text_cache));
 
     for (uint32_t i = 1; i < MISO_FONT_TABLE_MAX; i++) {
-        if (g_font_table[i].text) {
-            TTF_DestroyText(g_font_table[i].text);
-        }
         if (g_font_table[i].font) {
             TTF_CloseFont(g_font_table[i].font);
         }
-        g_font_table[i].text = NULL;
         g_font_table[i].font = NULL;
     }
 
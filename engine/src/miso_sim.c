@@ -0,0 +1,227 @@
+#include "miso_sim.h"
+
+#include "internal/miso__engine_internal.h"
+
+#include <SDL3/SDL.h>
+
+// Weight of the newest sample in the per-item cost estimate.
+static constexpr float MISO_SIM_COST_SMOOTHING = 0.2f;
+
+// System id: generation above, slot index + 1 below. Slots are reused, the generation makes stale ids miss.
+static constexpr uint32_t MISO_SIM_SYSTEM_SLOT_BITS = 16U;
+static constexpr uint32_t MISO_SIM_SYSTEM_SLOT_MASK = (1U << MISO_SIM_SYSTEM_SLOT_BITS) - 1U;
+static constexpr uint32_t MISO_SIM_SYSTEM_GENERATION_MASK = UINT32_MAX >> MISO_SIM_SYSTEM_SLOT_BITS;
+
+static bool miso__ensure_sim_system_capacity(MisoEngine *engine) {
+    if (engine->sim_system_count < engine->sim_system_capacity) {
+        return true;
+    }
+    if (engine->sim_system_capacity >= MISO_SIM_SYSTEM_SLOT_MASK) {
+        return false;
+    }
+
+    const uint32_t new_capacity =
+        engine->sim_system_capacity == 0 ? 4U : SDL_min(engine->sim_system_capacity * 2U, MISO_SIM_SYSTEM_SLOT_MASK);
+    MisoSimSystemState *new_systems = SDL_realloc(engine->sim_systems, sizeof(MisoSimSystemState) * new_capacity);
+    if (!new_systems) {
+        return false;
+    }
+
+    SDL_memset(new_systems + engine->sim_system_capacity,
+               0,
+               sizeof(MisoSimSystemState) * (new_capacity - engine->sim_system_capacity));
+    engine->sim_systems = new_systems;
+    engine->sim_system_capacity = new_capacity;
+    return true;
+}
+
+static MisoSimSystemState *miso__sim_system_get(MisoEngine *engine, const MisoSimSystemId id) {
+    if (!engine || (id & MISO_SIM_SYSTEM_SLOT_MASK) == 0) {
+        return NULL;
+    }
+    const uint32_t idx = (id & MISO_SIM_SYSTEM_SLOT_MASK) - 1U;
+    if (idx >= engine->sim_system_count) {
+        return NULL;
+    }
+    MisoSimSystemState *system = &engine->sim_systems[idx];
+    return system->used && system->generation == id >> MISO_SIM_SYSTEM_SLOT_BITS ? system : NULL;
+}
+
+static const MisoSimSystemState *miso__sim_system_get_const(const MisoEngine *engine, const MisoSimSystemId id) {
+    if (!engine || (id & MISO_SIM_SYSTEM_SLOT_MASK) == 0) {
+        return NULL;
+    }
+    const uint32_t idx = (id & MISO_SIM_SYSTEM_SLOT_MASK) - 1U;
+    if (idx >= engine->sim_system_count) {
+        return NULL;
+    }
+    const MisoSimSystemState *system = &engine->sim_systems[idx];
+    return system->used && system->generation == id >> MISO_SIM_SYSTEM_SLOT_BITS ? system : NULL;
+}
+
+MisoSimSystemId miso_sim_system_register(MisoEngine *engine, const MisoSimSystemDesc *desc) {
+    if (!engine || !desc || !desc->get_item_count || !desc->run_slice) {
+        return 0;
+    }
+
+    // A system registered from a run_slice callback gets a new slot at the end, so the slot of one unregistered in the
+    // same tick is not handed out while the dispatch loop may still be looking at it.
+    uint32_t idx = engine->sim_system_count;
+    if (!engine->sim_systems_ticking) {
+        for (uint32_t i = 0; i < engine->sim_system_count; ++i) {
+            if (!engine->sim_systems[i].used) {
+                idx = i;
+                break;
+            }
+        }
+    }
+    if (idx == engine->sim_system_count) {
+        if (!miso__ensure_sim_system_capacity(engine)) {
+            return 0;
+        }
+        engine->sim_system_count++;
+    }
+
+    MisoSimSystemState *system = &engine->sim_systems[idx];
+    const uint32_t generation = system->generation;
+    SDL_memset(system, 0, sizeof(*system));
+    system->used = true;
+    system->generation = generation;
+    system->desc = *desc;
+    if (!system->desc.name) {
+        system->desc.name = "system";
+    }
+    system->items_per_tick = desc->min_items_per_tick > 0 ? desc->min_items_per_tick : 1U;
+    system->pass_start_tick = engine->sim_stats.tick_count;
+    return system->generation << MISO_SIM_SYSTEM_SLOT_BITS | (idx + 1U);
+}
+
+void miso_sim_system_unregister(MisoEngine *engine, const MisoSimSystemId system_id) {
+    MisoSimSystemState *system = miso__sim_system_get(engine, system_id);
+    if (!system) {
+        return;
+    }
+    system->used = false;
+    system->generation = (system->generation + 1U) & MISO_SIM_SYSTEM_GENERATION_MASK;
+}
+
+void miso_sim_system_set_budget(MisoEngine *engine, const MisoSimSystemId system_id, const float budget_ms) {
+    MisoSimSystemState *system = miso__sim_system_get(engine, system_id);
+    if (!system) {
+        return;
+    }
+    system->desc.budget_ms = budget_ms;
+}
+
+bool miso_sim_system_get_stats(const MisoEngine *engine,
+                               const MisoSimSystemId system_id,
+                               MisoSimSystemStats *out_stats) {
+    const MisoSimSystemState *system = miso__sim_system_get_const(engine, system_id);
+    if (!system || !out_stats) {
+        return false;
+    }
+
+    const float fixed_dt = 1.0f / (float)engine->config.sim_tick_hz;
+    out_stats->name = system->desc.name;
+    out_stats->item_count = system->desc.get_item_count(system->desc.user);
+    out_stats->items_per_tick = system->items_per_tick;
+    out_stats->cursor = system->cursor;
+    out_stats->last_tick_ms = system->last_tick_ms;
+    out_stats->ms_per_item = system->ms_per_item;
+    out_stats->last_pass_ticks = system->last_pass_ticks;
+    out_stats->last_pass_seconds = (float)system->last_pass_ticks * fixed_dt;
+    out_stats->passes_completed = system->passes_completed;
+    return true;
+}
+
+void miso_get_sim_stats(const MisoEngine *engine, MisoSimStats *out_stats) {
+    if (!engine || !out_stats) {
+        return;
+    }
+    *out_stats = engine->sim_stats;
+}
+
+// Picks how many items fit in the budget from the smoothed per-item cost. Growth is capped at 2x per tick so a single
+// cheap sample cannot blow the next tick's budget; systems too cheap to measure just keep doubling.
+static uint32_t miso__sim_system_slice_size(const MisoSimSystemState *system, const uint32_t item_count) {
+    if (system->desc.budget_ms <= 0.0f) {
+        return item_count;
+    }
+
+    const uint32_t min_items = system->desc.min_items_per_tick > 0 ? system->desc.min_items_per_tick : 1U;
+    const uint32_t grow_limit = system->items_per_tick > UINT32_MAX / 2U ? UINT32_MAX : system->items_per_tick * 2U;
+
+    uint32_t items = grow_limit;
+    if (system->ms_per_item > 0.0f) {
+        const float fit = system->desc.budget_ms / system->ms_per_item;
+        items = fit >= (float)grow_limit ? grow_limit : (uint32_t)fit;
+    }
+    items = SDL_max(items, min_items);
+    return SDL_min(items, item_count);
+}
+
+// Runs one slice of the system in slot idx. The callbacks may register or unregister systems, which can move the
+// slot array, so the state is looked up again after them instead of being held across the calls.
+static void miso__sim_system_tick(MisoEngine *engine, const uint32_t idx, const float fixed_dt_seconds) {
+    const MisoSimSystemState *const before = &engine->sim_systems[idx];
+    const MisoSimSystemDesc desc = before->desc;
+    const uint32_t generation = before->generation;
+    const uint64_t tick = engine->sim_stats.tick_count;
+
+    const uint32_t item_count = desc.get_item_count(desc.user);
+    MisoSimSystemState *system = &engine->sim_systems[idx];
+    if (!system->used || system->generation != generation) {
+        return;
+    }
+    if (item_count == 0) {
+        system->cursor = 0;
+        system->last_tick_ms = 0.0f;
+        return;
+    }
+
+    if (system->cursor >= item_count) {
+        system->cursor = 0;
+    }
+
+    const uint32_t slice = miso__sim_system_slice_size(system, item_count);
+    const uint32_t cursor = system->cursor;
+    const uint32_t count = SDL_min(slice, item_count - cursor);
+    const uint32_t pass_ticks = system->last_pass_ticks > 0 ? system->last_pass_ticks : 1U;
+
+    const uint64_t start = SDL_GetPerformanceCounter();
+    desc.run_slice(desc.user, cursor, count, (float)pass_ticks * fixed_dt_seconds);
+    const uint64_t end = SDL_GetPerformanceCounter();
+
+    system = &engine->sim_systems[idx];
+    if (!system->used || system->generation != generation) {
+        return; // unregistered by its own slice
+    }
+
+    system->last_tick_ms = (float)(end - start) * 1000.0f / (float)SDL_GetPerformanceFrequency();
+    const float sample = system->last_tick_ms / (float)count;
+    system->ms_per_item = system->ms_per_item <= 0.0f
+                              ? sample
+                              : system->ms_per_item + (sample - system->ms_per_item) * MISO_SIM_COST_SMOOTHING;
+    system->items_per_tick = slice;
+
+    system->cursor = cursor + count;
+    if (system->cursor >= item_count) {
+        system->cursor = 0;
+        system->last_pass_ticks = (uint32_t)(tick + 1U - system->pass_start_tick);
+        system->pass_start_tick = tick + 1U;
+        system->passes_completed++;
+    }
+}
+
+void miso__sim_systems_tick(MisoEngine *engine, const float fixed_dt_seconds) {
+    // systems registered during the loop start on the next tick
+    const uint32_t system_count = engine->sim_system_count;
+    engine->sim_systems_ticking = true;
+    for (uint32_t i = 0; i < system_count; ++i) {
+        if (!engine->sim_systems[i].used) {
+            continue;
+        }
+        miso__sim_system_tick(engine, i, fixed_dt_seconds);
+    }
+    engine->sim_systems_ticking = false;
+}
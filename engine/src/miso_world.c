@@ -14,6 +14,40 @@ static int miso__tile_index(const MisoWorld *world, int tx, int ty) {
     return ty * world->map.width_tiles + tx;
 }
 
+// Per-tick budget of the footprint audit, a large city is covered over several ticks.
+static constexpr float MISO_WORLD_AUDIT_BUDGET_MS = 0.05f;
+
+static uint32_t miso__world_audit_count(void *user) {
+    const MisoWorld *world = user;
+    return world->building_count;
+}
+
+// miso_world_set_tile_occupied() can free tiles under a building, which would let another one be placed on top of it.
+// The audit marks the footprint of every active building as occupied again.
+static void miso__world_audit_slice(void *user, uint32_t first, uint32_t count, float elapsed_seconds) {
+    (void)elapsed_seconds;
+    MisoWorld *world = user;
+    uint32_t repaired = 0;
+    for (uint32_t i = first; i < first + count; ++i) {
+        const MisoBuildingRecord *record = &world->buildings[i];
+        if (!record->active) {
+            continue;
+        }
+        for (int y = 0; y < record->footprint_h; ++y) {
+            for (int x = 0; x < record->footprint_w; ++x) {
+                if (miso__in_bounds(world, record->tx + x, record->ty + y)) {
+                    bool *tile = &world->occupied[miso__tile_index(world, record->tx + x, record->ty + y)];
+                    repaired += *tile ? 0U : 1U;
+                    *tile = true;
+                }
+            }
+        }
+    }
+    if (repaired > 0) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Re-occupied %u freed tiles under buildings", repaired);
+    }
+}
+
 MisoWorld *miso_world_create(MisoEngine *engine, const MisoIsoMapDesc *desc) {
     if (!engine || !desc || desc->width_tiles <= 0 || desc->height_tiles <= 0 || desc->tile_w_px <= 0 ||
         desc->tile_h_px <= 0) {
@@ -36,6 +70,16 @@ MisoWorld *miso_world_create(MisoEngine *engine, const MisoIsoMapDesc *desc) {
     }
 
     world->next_building_id = 1;
+
+    const MisoSimSystemDesc audit = {
+        .name = "world_footprints",
+        .get_item_count = miso__world_audit_count,
+        .run_slice = miso__world_audit_slice,
+        .user = world,
+        .budget_ms = MISO_WORLD_AUDIT_BUDGET_MS,
+        .min_items_per_tick = 16U,
+    };
+    world->footprint_audit = miso_sim_system_register(engine, &audit);
     return world;
 }
 
@@ -44,6 +88,7 @@ void miso_world_destroy(MisoWorld *world) {
         return;
     }
 
+    miso_sim_system_unregister(world->engine, world->footprint_audit);
     SDL_free(world->occupied);
     SDL_free(world->buildings);
     SDL_free(world);
@@ -16,8 +16,11 @@
 #include "camera/camera.h"
 #include "debug_ui.h"
 #include "game_clock.h"
+#include "memtrack.h"
 #include "profiler.h"
+#include "stats_export.h"
 #include "renderer/renderer.h"
+#include "renderer/sdf_text.h"
 #include "renderer/ui.h"
 #include "tilemap/tilemap.h"
 
@@ -25,6 +28,7 @@
 
 #define WINDOW_WIDTH 1920
 #define WINDOW_HEIGHT 1080
+#define TRACE_CAPTURE_FRAMES 300 // F9
 static int screen_width = WINDOW_WIDTH;
 static int screen_height = WINDOW_HEIGHT;
 static float pixel_ratio = 0.0f;
@@ -129,179 +133,89 @@ void render_tile_highlight(const Tilemap *tilemap, int tile_x, int tile_y, SDL_F
     // Depth for the tile
     const float depth = Tilemap_GetTileDepth(tilemap, tile_x, tile_y) - 0.002f;
 
-    // Draw perimeter (4 lines forming diamond)
-    Renderer_DrawLine(top_x, top_y, depth, right_x, right_y, depth, color);
-    Renderer_DrawLine(right_x, right_y, depth, bottom_x, bottom_y, depth, color);
-    Renderer_DrawLine(bottom_x, bottom_y, depth, left_x, left_y, depth, color);
-    Renderer_DrawLine(left_x, left_y, depth, top_x, top_y, depth, color);
-
-    // Draw beacon (vertical ray going up from top of tile)
+    // Perimeter (4 segments forming the diamond) plus a beacon (vertical ray going up from the top), one batch
     constexpr float beacon_height = 200.0f;
-    Renderer_DrawLine(top_x, top_y, depth, top_x, top_y - beacon_height, depth, color);
+    const RendererLineVertex top = Renderer_LineVertex(top_x, top_y, depth, color);
+    const RendererLineVertex right = Renderer_LineVertex(right_x, right_y, depth, color);
+    const RendererLineVertex bottom = Renderer_LineVertex(bottom_x, bottom_y, depth, color);
+    const RendererLineVertex left = Renderer_LineVertex(left_x, left_y, depth, color);
+    const RendererLineVertex beacon = Renderer_LineVertex(top_x, top_y - beacon_height, depth, color);
+    const RendererLineVertex segments[] = {top, right, right, bottom, bottom, left, left, top, top, beacon};
+    Renderer_DrawLines(segments, (int)SDL_arraysize(segments));
 }
 
+static SDFFont *label_font = nullptr; // world-space labels, sharp at any zoom
+#define LABEL_SIZE 14.0f              // world units
+static const SDL_FColor label_outline = {0.0f, 0.0f, 0.0f, 0.8f};
+
+// Label centred horizontally on x, its bottom edge at y
+static void render_world_label(const char *const text, const float x, const float y, const SDL_FColor color) {
+    if (!label_font) {
+        return;
+    }
+    const float w = SDFText_MeasureWidth(label_font, text, LABEL_SIZE);
+    const float h = SDFText_MeasureHeight(label_font, text, LABEL_SIZE);
+    SDFText_DrawLabel(label_font, text, x - w * 0.5f, y - h, LABEL_SIZE, color, label_outline);
+}
+
+// Hovered tile coordinates on top of its highlight beacon
+static void render_tile_label(const Tilemap *const tilemap, const int tile_x, const int tile_y, const SDL_FColor color) {
+    if (tile_x < 0 || tile_y < 0 || tile_x >= tilemap->width || tile_y >= tilemap->height)
+        return;
+
+    float world_x, world_y;
+    Tilemap_TileToWorld(tilemap, tile_x, tile_y, &world_x, &world_y);
+    float iso_w, iso_h;
+    Tileset_GetIsoDimensions(tilemap->tileset, &iso_w, &iso_h);
 
-typedef struct WireframeMesh_ {
-    SDL_Vertex *verts;
-    int vert_count;
-} WireframeMesh;
+    char text[32];
+    snprintf(text, sizeof(text), "%d, %d", tile_x, tile_y);
+    constexpr float beacon_height = 200.0f; // matches render_tile_highlight
+    render_world_label(text, world_x + iso_w / 2.0f, world_y - beacon_height, color);
+}
 
-static WireframeMesh wireframe_meshes[MAX_BUILDINGS];
 
-// --- helper to build and cache a mesh ---
-static WireframeMesh build_wireframe_mesh(
+static RendererWireframeInstance wireframe_instances[MAX_BUILDINGS];
+
+// --- helper to describe a building's wireframe, the vertex shader expands it into edges ---
+static RendererWireframeInstance make_wireframe(
     const float iso_x, const float iso_y,
     const float iso_w, const float iso_h,
-    const int bw, const int bl,
-    const int sw, const int sh)
+    const int bw, const int bl, const int sh)
 {
-    const float half_w = iso_w*0.5f;
-    const float half_h = iso_h*0.5f;
     const float tile_h = iso_h*2.0f;
     const float base_y = iso_y + tile_h*(float)sh;
-    const SDL_FColor col = {0,255,255,255};
-    WireframeMesh thin_mesh;
-
-    {
-        // estimate max lines and allocate twice as many vertices, aligned to a multiple of 3, for rendering constraints
-        const int max_lines = (bw + bl) + bw*(sh+1) + bl*(sh+1) + (bw+1) * (bl+1);
-        const int num_vertices = max_lines * 2 + (3 - ((max_lines * 2) % 3));
-        SDL_Vertex *v = SDL_malloc(sizeof(SDL_Vertex) * (unsigned int)num_vertices);
-        int idx = 0;
-
-        // width-wise lines
-        for (int x = 0; x < bw; x++) {
-            const float vx = iso_x + half_w * (float)x;
-            const float vb = base_y - half_h * (float)(bw-x);
-            const float vt = vb - iso_h*(float)sh;
-            // vertical
-            v[idx++] = (SDL_Vertex){{vx,vb}, col,{0,0}};
-            v[idx++] = (SDL_Vertex){{vx,vt}, col,{0,0}};
-            // top faces
-            for (int y = 0; y <= sh; y++) {
-                const float dy = vb - iso_h*(float)y;
-                v[idx++] = (SDL_Vertex){{vx,         dy},      col,{0,0}};
-                v[idx++] = (SDL_Vertex){{vx+half_w,  dy+half_h},col,{0,0}};
-            }
-        }
-        // length-wise lines
-        for (int x = 0; x <= bl; x++) {
-            const float vx = iso_x + iso_w * (float)(bw+x) * 0.5f;
-            const float vb = base_y - iso_h * 0.5f * (float)x;
-            const float vt = vb - iso_h * (float)sh;
-            v[idx++] = (SDL_Vertex){{vx,vb}, col,{0,0}};
-            v[idx++] = (SDL_Vertex){{vx,vt}, col,{0,0}};
-            if (x < bl) {
-                for (int y = 0; y <= sh; y++) {
-                    const float dy = vb - iso_h*(float)y;
-                    v[idx++] = (SDL_Vertex){{vx,           dy},         col,{0,0}};
-                    v[idx++] = (SDL_Vertex){{vx+half_w,    dy-half_h},   col,{0,0}};
-                }
-            }
-        }
-
-        //roof side
-        const SDL_FPoint roof_fl = {
-            iso_x,
-            base_y - half_h*(float)bw - iso_h*(float)sh
-        }; // front-left
-        const SDL_FPoint roof_fr = {
-            iso_x + half_w*(float)bw,
-            base_y - half_h*(float)bw - iso_h*(float)sh + half_h*(float)bw
-        }; // front-right
-        const SDL_FPoint roof_bl = {
-            iso_x + half_w*(float)bl,
-            roof_fl.y - half_h*(float)bl
-        }; // back-left
-        const SDL_FPoint roof_br = {
-            iso_x + half_w*(bw+bl),
-            roof_fr.y - half_h*bl
-        }; // back-right
-
-        const SDL_FPoint dv_len   = { half_w, -half_h };  // length direction
-        const SDL_FPoint dv_width = { half_w,  half_h };  // width direction
-
-        // lines parallel to length (splitting width units on the roof)
-        for (int i = 1; i <= bl; i++) {
-            SDL_FPoint p0 = {
-                roof_fl.x + dv_len.x * (float) i,
-                roof_fl.y + dv_len.y * (float) i
-            };
-            SDL_FPoint p1 = {
-                roof_fr.x + dv_len.x * (float) i,
-                roof_fr.y + dv_len.y * (float) i
-            };
-            v[idx++] = (SDL_Vertex){p0, col, {0, 0}};
-            v[idx++] = (SDL_Vertex){p1, col, {0, 0}};
-        }
-
-        // lines parallel to width (splitting length units on the roof)
-        for (int j = 0; j < bw; j++) {
-            SDL_FPoint p0 = {
-                roof_fl.x + dv_width.x * (float) j,
-                roof_fl.y + dv_width.y * (float) j
-            };
-            SDL_FPoint p1 = {
-                roof_bl.x + dv_width.x * (float) j,
-                roof_bl.y + dv_width.y * (float) j
-            };
-            v[idx++] = (SDL_Vertex){p0, col, {0, 0}};
-            v[idx++] = (SDL_Vertex){p1, col, {0, 0}};
-        }
-
-        const int remaining = num_vertices - idx;
-        for (int i = 0; i < remaining; i++) {
-            const SDL_Vertex last = v[idx - 1];
-            v[idx++] = last;
-        }
-
-        thin_mesh = (WireframeMesh){.verts = v, .vert_count = idx};
-    }
+    return (RendererWireframeInstance){
+        .x = iso_x,
+        .y = base_y - iso_h*0.5f*(float)bw, // left corner of the footprint
+        .tile_w = iso_w,
+        .tile_h = iso_h,
+        .width = (float)bw,
+        .length = (float)bl,
+        .levels = (float)sh,
+        .color = 0xFFFFFF00u, // cyan
+    };
+}
 
-    // Each segment is two consecutive vertices in thin.verts
-    const int segments = thin_mesh.vert_count / 2;
-    const int max_verts = segments * 6;
-    SDL_Vertex *v = SDL_malloc(sizeof(SDL_Vertex) * (unsigned int) max_verts);
-    int idx = 0;
-
-    for (int i = 0; i < segments; ++i) {
-        constexpr float thickness = 1.0f;
-        // endpoints
-        SDL_FPoint p1 = thin_mesh.verts[2 * i].position;
-        SDL_FPoint p2 = thin_mesh.verts[2 * i + 1].position;
-        // direction & perpendicular
-        float dx = p2.x - p1.x;
-        float dy = p2.y - p1.y;
-        const float len = SDL_sqrtf(dx * dx + dy * dy);
-        if (len < 1e-6f)
-            continue;
-        dx /= len;
-        dy /= len;
-        const float nx = -dy * (thickness * 0.5f);
-        const float ny = dx * (thickness * 0.5f);
-        // quad corners
-        const SDL_FPoint q1 = {p1.x + nx, p1.y + ny};
-        const SDL_FPoint q2 = {p2.x + nx, p2.y + ny};
-        const SDL_FPoint q3 = {p2.x - nx, p2.y - ny};
-        const SDL_FPoint q4 = {p1.x - nx, p1.y - ny};
-        // two triangles
-        v[idx++] = (SDL_Vertex){q1, col, {0, 0}};
-        v[idx++] = (SDL_Vertex){q2, col, {0, 0}};
-        v[idx++] = (SDL_Vertex){q3, col, {0, 0}};
-        v[idx++] = (SDL_Vertex){q3, col, {0, 0}};
-        v[idx++] = (SDL_Vertex){q4, col, {0, 0}};
-        v[idx++] = (SDL_Vertex){q1, col, {0, 0}};
+// "#i" above the topmost corner of each building's roof, same geometry as vertex_wireframe's box
+static void render_wireframe_labels(const RendererWireframeInstance *const instances, const int count) {
+    for (int i = 0; i < count; i++) {
+        const RendererWireframeInstance *const b = &instances[i];
+        const float roof_y = b->y - b->tile_h * b->levels;
+        const float top_y = roof_y - b->tile_h * 0.5f * b->length;
+        const float center_x = b->x + b->tile_w * 0.25f * (b->width + b->length);
+        char text[16];
+        snprintf(text, sizeof(text), "#%d", i);
+        render_world_label(text, center_x, top_y - 4.0f, (SDL_FColor){0.0f, 1.0f, 1.0f, 1.0f});
     }
-
-    // free the thin mesh
-    SDL_free(thin_mesh.verts);
-    return (WireframeMesh){.verts = v, .vert_count = idx};
 }
 
 void render_buildings(const Tilemap *const map, const TransformComponent *const ts,
                       const RenderableComponent *const rs, const int b_count,
                       const float offset_x, const float offset_y) {
     PROF_start(PROFILER_RENDER_BUILDINGS);
+    PROF_ZONE("render_buildings");
+    MEM_TAG(MEM_TAG_GAME);
 
     const int tile_w = (int) map->tileset->tile_width;
     const int tile_h = (int) map->tileset->tile_height;
@@ -310,13 +224,21 @@ void render_buildings(const Tilemap *const map, const TransformComponent *const
     const float start_x = offset_x + (float) (map->height - 1) * iso_w / 2.0f;
     const float start_y = offset_y;
 
-    SpriteInstance *instances =
-            SDL_malloc(sizeof(SpriteInstance) * (size_t)(b_count + 1));
+    // An array tileset has to go through the layered pipeline, its texture cannot be bound as a plain 2D texture
+    const bool layered = map->tileset->in_array;
+    const float layer = (float) map->tileset->layer;
+    const size_t instance_size = layered ? sizeof(SpriteLayerInstance) : sizeof(SpriteInstance);
+    void *instances = SDL_malloc(instance_size * (size_t)(b_count + 1));
+    if (!instances) {
+        PROF_stop(PROFILER_RENDER_BUILDINGS);
+        return;
+    }
     int instance_count = 0;
 
-    const float tex_w = (float) (map->tileset->columns * map->tileset->tile_width);
-    const float tex_h = (float) (map->tileset->rows * map->tileset->tile_height);
+    const float tex_w = (float) map->tileset->texture_width;
+    const float tex_h = (float) map->tileset->texture_height;
 
+    PROF_ZONE_BEGIN("build_instances");
     for (int entity = 0; entity < b_count; entity++) {
         const int bw = rs[entity].sprite_w;
         const int bh = rs[entity].sprite_h;
@@ -342,7 +264,7 @@ void render_buildings(const Tilemap *const map, const TransformComponent *const
         const float depth =
                 1.0f - (float) (mx + my) / (float) (map->width + map->height) - 0.001f;
 
-        instances[instance_count++] = (SpriteInstance){
+        const SpriteInstance instance = {
             .x = iso_x,
             .y = iso_y,
             .z = depth,
@@ -356,9 +278,25 @@ void render_buildings(const Tilemap *const map, const TransformComponent *const
             .uw = uw,
             .vh = vh
         };
+        if (layered) {
+            ((SpriteLayerInstance *)instances)[instance_count++] =
+                    (SpriteLayerInstance){.sprite = instance, .layer = layer};
+        } else {
+            ((SpriteInstance *)instances)[instance_count++] = instance;
+        }
     }
 
-    Renderer_DrawSprites(map->tileset->texture, instances, instance_count);
+    PROF_ZONE_END();
+    PROF_counter("buildings_iterated", b_count);
+    PROF_counterAdd("instances_built", instance_count);
+
+    PROF_ZONE_BEGIN("submit");
+    if (layered) {
+        Renderer_DrawLayeredSprites(map->tileset->texture, instances, instance_count);
+    } else {
+        Renderer_DrawSprites(map->tileset->texture, instances, instance_count);
+    }
+    PROF_ZONE_END();
     SDL_free(instances);
 
     PROF_stop(PROFILER_RENDER_BUILDINGS);
@@ -377,11 +315,28 @@ SDL_Renderer *renderer = nullptr;
 
 TTF_Font *font = nullptr;
 TTF_Text *fps_text = nullptr;
+static UIPanel *hud_panel = nullptr;      // tile/camera lines, rebuilt only when their text changes
+static UIPanel *fps_panel = nullptr;      // stats change every frame, rebuilt every HUD_STATS_REFRESH_MS instead
+static UIPanel *profiler_panel = nullptr; // same refresh as fps_panel
+#define HUD_STATS_REFRESH_MS 250
 
 #define MAP_SIZE_X 70
 #define MAP_SIZE_Y 40
 static Tileset *tileset = nullptr;
+static TilesetArray *tileset_array = nullptr; // owns tileset when MISO_TILESET_ARRAY is set
 static Tilemap *tilemap = nullptr;
+
+// Also cancels a pending Tileset_LoadAsync()
+static void destroy_tileset(void) {
+    if (tileset_array) {
+        TilesetArray_Destroy(tileset_array);
+        tileset_array = nullptr;
+    } else {
+        Tileset_Destroy(tileset);
+    }
+    tileset = nullptr;
+}
+
 Entity main_camera;
 ECSWorld ecs;
 
@@ -399,6 +354,7 @@ int initialize(void) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_Init failed: %s\n", SDL_GetError());
         return false;
     }
+    PROF_init(); // before Renderer_Init starts the texture loader threads
 
     if (TTF_Init() == false) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TTF_Init failed: %s\n", SDL_GetError());
@@ -427,6 +383,26 @@ int initialize(void) {
     pixel_ratio = display_mode->pixel_density;
 
 
+    // Decoded on the loader threads while the rest of the initialization runs. The blob cooked by cook_assets skips the
+    // PNG decode, the PNG is the fallback when it was not built.
+    char resource_path[512] = {0};
+    const char *tileset_path = getCookedAssetPath(resource_path, "isometric-sheet.mtex");
+    if (!SDL_GetPathInfo(tileset_path, nullptr)) {
+        tileset_path = getResourcePath(resource_path, "isometric-sheet.png");
+    }
+    // MISO_TILESET_ARRAY=1 loads it as a texture array layer instead, drawn by the layered sprite pipeline
+    const char *const tileset_array_env = SDL_getenv("MISO_TILESET_ARRAY");
+    if (tileset_array_env && tileset_array_env[0] != '\0') {
+        tileset_array = TilesetArray_Load(&tileset_path, 1, TILE_SIZE, TILE_SIZE);
+        tileset = tileset_array ? &tileset_array->tilesets[0] : nullptr;
+    } else {
+        tileset = Tileset_LoadAsync(tileset_path, TILE_SIZE, TILE_SIZE);
+    }
+    if (tileset == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load tileset");
+        return false;
+    }
+
     SDL_Surface *icon_surface = IMG_Load("icon.png");
     if (icon_surface) {
         SDL_SetWindowIcon(window, icon_surface);
@@ -440,6 +416,7 @@ int initialize(void) {
     if (!font) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TTF_OpenFont failed: %s\n", SDL_GetError());
         SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "TTF_OpenFont failed", SDL_GetError(), window);
+        destroy_tileset();
         SDL_DestroyWindow(window);
         return false;
     }
@@ -451,22 +428,43 @@ int initialize(void) {
     }
 
     UI_Init();
+    hud_panel = UI_CreatePanel();
+    fps_panel = UI_CreatePanel();
+    profiler_panel = UI_CreatePanel();
+
+    // Baked once, labels scale with the camera instead of being re-rasterized per zoom level
+    label_font = SDFText_LoadFont("/Users/arnau/Library/Fonts/JetBrainsMono-Regular.ttf", 48.0f);
+    if (!label_font) {
+        SDL_Log("Warning: Failed to load the label font, world labels disabled");
+    }
+
+    // MISO_SPIKE_CAPTURE=miso_spike dumps the frames around each hitch to miso_spike_<n>.json
+    const char *const spike_prefix = SDL_getenv("MISO_SPIKE_CAPTURE");
+    if (spike_prefix && spike_prefix[0] != '\0') {
+        PROF_setSpikeCapture(true, 0.0f, spike_prefix);
+    }
+
+    // MISO_STATS_SHM=/miso_stats publishes live stats for tools/miso_stats_reader
+    const char *const stats_shm_name = SDL_getenv("MISO_STATS_SHM");
+    if (stats_shm_name && stats_shm_name[0] != '\0') {
+        STATS_exportOpen(stats_shm_name);
+    }
 
     // Initialize Nuklear debug UI with same font
     if (!DebugUI_Init("/Users/arnau/Library/Fonts/JetBrainsMono-Regular.ttf", 14.0f)) {
         SDL_Log("Warning: Failed to initialize debug UI");
     }
 
-    char resource_path[512] = {0};
-    tileset = Tileset_Load(getResourcePath(resource_path, "isometric-sheet.png"), TILE_SIZE, TILE_SIZE);
-    if (tileset == nullptr) {
+    if (!Tileset_WaitReady(tileset)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load tileset");
+        destroy_tileset();
         return false;
     }
 
     tilemap = Tilemap_Create(MAP_SIZE_X, MAP_SIZE_Y, tileset);
     if (tilemap == nullptr) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create tilemap");
+        destroy_tileset();
         return false;
     }
 
@@ -515,20 +513,22 @@ void clean(void) {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_WARNING, "Bye!", "see you!", window);
     SDL_Log("Application quit.\n");
 
-    for (int i = 0; i < building_count; i++) {
-        SDL_free(wireframe_meshes[i].verts);
-    }
-
     // Clean up tilemap (before renderer shutdown)
     Tilemap_Destroy(tilemap);
-    Tileset_Destroy(tileset);
+    destroy_tileset();
 
     if (fps_text)
         TTF_DestroyText(fps_text);
 
     DebugUI_Shutdown();
+    STATS_exportClose();
+    PROF_shutdown();
     PROF_deinitUI();
+    UI_DestroyPanel(hud_panel);
+    UI_DestroyPanel(fps_panel);
+    UI_DestroyPanel(profiler_panel);
     UI_Shutdown();
+    SDFText_DestroyFont(label_font);
     Renderer_Shutdown();
     SDL_DestroyWindow(window);
     TTF_Quit();
@@ -573,7 +573,7 @@ void spawn_boat(const int x, const int y) {
     constexpr float start_y = 0.0f;
     const float iso_x = start_x + (float) (x - y) * iso_w * 0.5f - (b_w_ - 1) * iso_w * 0.5f;
     const float iso_y = start_y + (float) (x + y) * iso_h * 0.5f - tile_h - b_h_ * iso_h;
-    wireframe_meshes[building_count] = build_wireframe_mesh(iso_x, iso_y, iso_w, iso_h, 1, 3, 2, 3);
+    wireframe_instances[building_count] = make_wireframe(iso_x, iso_y, iso_w, iso_h, 1, 3, 3);
 
     building_count++;
 }
@@ -620,7 +620,7 @@ void spawn_boats(const int amount) {
                 constexpr float start_y = 0.0f;
                 const float iso_x = start_x + (float) (x - y) * iso_w * 0.5f - (b_w_ - 1) * iso_w * 0.5f;
                 const float iso_y = start_y + (float) (x + y) * iso_h * 0.5f - tile_h - b_h_ * iso_h;
-                wireframe_meshes[building_count] = build_wireframe_mesh(iso_x, iso_y, iso_w, iso_h, 1, 3, 2, 3);
+                wireframe_instances[building_count] = make_wireframe(iso_x, iso_y, iso_w, iso_h, 1, 3, 3);
 
                 building_count++;
                 count++;
@@ -671,6 +671,13 @@ int mainLoop(void) {
                         case SDLK_P:
                             debug_mode = !debug_mode;
                             break;
+                        case SDLK_F9:
+                            if (PROF_isCapturing()) {
+                                PROF_captureStop();
+                            } else {
+                                PROF_captureStart(TRACE_CAPTURE_FRAMES, "miso_trace.json");
+                            }
+                            break;
                         case SDLK_PLUS:
                             spawn_boats(50);
                             break;
@@ -790,6 +797,7 @@ int mainLoop(void) {
         // Debug tile highlight (perimeter + beacon on hovered tile)
         render_tile_highlight(tilemap, hover_tile.x, hover_tile.y,
                               (SDL_FColor){0.0f, 1.0f, 1.0f, 1.0f});
+        render_tile_label(tilemap, hover_tile.x, hover_tile.y, (SDL_FColor){0.0f, 1.0f, 1.0f, 1.0f});
 
         // DEBUG: Draw the tileset texture in the corner to verify sprite pipeline
         Renderer_DrawTextureDebug(tilemap->tileset->texture, 50,
@@ -797,20 +805,8 @@ int mainLoop(void) {
 
         if (wireframe_mode) {
             PROF_start(PROFILER_RENDER_WIREFRAMES);
-            // FIX: Calculate total vertex count across all meshes (they may differ)
-            size_t total_vert_count = 0;
-            for (int i = 0; i < building_count; i++) {
-                total_vert_count += wireframe_meshes[i].vert_count;
-            }
-            SDL_Vertex *combined = SDL_malloc(sizeof(SDL_Vertex) * total_vert_count);
-            size_t offset = 0;
-            for (int i = 0; i < building_count; i++) {
-                SDL_memcpy(combined + offset, wireframe_meshes[i].verts,
-                           sizeof(SDL_Vertex) * wireframe_meshes[i].vert_count);
-                offset += wireframe_meshes[i].vert_count;
-            }
-            Renderer_DrawGeometry(combined, (int)offset);
-            SDL_free(combined);
+            Renderer_DrawWireframes(wireframe_instances, building_count);
+            render_wireframe_labels(wireframe_instances, building_count);
             PROF_stop(PROFILER_RENDER_WIREFRAMES);
         }
 
@@ -821,9 +817,6 @@ int mainLoop(void) {
         char hover_tile_info[64];
         snprintf(hover_tile_info, sizeof(hover_tile_info), "Tile: (%d, %d)",
                  hover_tile.x, hover_tile.y);
-        TTF_SetTextString(fps_text, hover_tile_info, 0);
-        UI_TextWithBackground(fps_text, 10, ui_y_pos);
-        ui_y_pos += 40.0f;
 
         char camera_info[128];
         snprintf(camera_info, sizeof(camera_info),
@@ -831,24 +824,52 @@ int mainLoop(void) {
                  main_camera_component->camera.position.x,
                  main_camera_component->camera.position.y,
                  main_camera_component->camera.zoom);
-        TTF_SetTextString(fps_text, camera_info, 0);
-        UI_TextWithBackground(fps_text, 10, ui_y_pos);
-        ui_y_pos += 40.0f;
 
-        char fps_str[64];
-        if (debug_mode) {
-            float min, max, avg;
-            PROF_getFPS(&min, &avg, &max);
-            snprintf(fps_str, sizeof(fps_str), "FPS: min %4.0f  |  avg %4.0f  |  max %4.0f ", min, avg, max);
-        } else {
-            snprintf(fps_str, sizeof(fps_str), "FPS %4.0f ", 1.0f / real_dt);
+        // formatting is cheap, shaping and batching the lines is not: redo those only when a line changed
+        Uint64 hud_hash = UI_HashBytes(0, hover_tile_info, SDL_strlen(hover_tile_info) + 1);
+        hud_hash = UI_HashBytes(hud_hash, camera_info, SDL_strlen(camera_info) + 1);
+        if (UI_BeginPanel(hud_panel, hud_hash)) {
+            const char *const hud_lines[] = {hover_tile_info, camera_info};
+            for (int i = 0; i < 2; i++) {
+                TTF_SetTextString(fps_text, hud_lines[i], 0);
+                UI_TextWithBackground(fps_text, 10, ui_y_pos + 40.0f * (float)i);
+            }
+            UI_EndPanel(hud_panel);
+        }
+        ui_y_pos += 2.0f * 40.0f;
+
+        // frame stats differ every frame, a readable refresh rate keeps them off the per-frame rebuild path
+        const Uint64 stats_refresh = SDL_GetTicks() / HUD_STATS_REFRESH_MS;
+        const Uint64 fps_hash = UI_HashBytes(stats_refresh + 1U, &debug_mode, sizeof(debug_mode));
+        if (UI_BeginPanel(fps_panel, fps_hash)) {
+            char fps_str[96];
+            if (debug_mode) {
+                float min, max, avg;
+                PROF_getFPS(&min, &avg, &max);
+                ProfilerPercentiles frame_percentiles;
+                float low_1 = 0.0f;
+                if (PROF_getPercentiles(PROFILER_FRAME_TOTAL, &frame_percentiles) && frame_percentiles.p99 > 0.0f) {
+                    low_1 = 1000.0f / frame_percentiles.p99;
+                }
+                snprintf(fps_str,
+                         sizeof(fps_str),
+                         "FPS: min %4.0f  |  avg %4.0f  |  max %4.0f  |  1%% low %4.0f ",
+                         min,
+                         avg,
+                         max,
+                         low_1);
+            } else {
+                snprintf(fps_str, sizeof(fps_str), "FPS %4.0f ", 1.0f / real_dt);
+            }
+            TTF_SetTextString(fps_text, fps_str, 0);
+            UI_TextWithBackground(fps_text, 10, ui_y_pos);
+            UI_EndPanel(fps_panel);
         }
-        TTF_SetTextString(fps_text, fps_str, 0);
-        UI_TextWithBackground(fps_text, 10, ui_y_pos);
         ui_y_pos += 40.0f;
 
-        if (debug_mode) {
+        if (debug_mode && UI_BeginPanel(profiler_panel, stats_refresh + 1U)) {
             PROF_render((SDL_FPoint){10.0f, ui_y_pos});
+            UI_EndPanel(profiler_panel);
         }
 
         //mouse pos next to mouse
@@ -910,6 +931,7 @@ int mainLoop(void) {
 
         PROF_stop(PROFILER_WAIT_FRAME);
         PROF_frameEnd();
+        STATS_exportPublish();
     }
     return 0;
 }
@@ -942,6 +964,9 @@ void logLibraryVersions(void) {
 }
 
 int main(void) {
+#ifdef MISO_MEMTRACK
+    MEM_installTracker(); // before anything allocates through SDL
+#endif
 
     LOG_init();
 
@@ -0,0 +1,254 @@
+#include "memtrack.h"
+
+#include "SDL3/SDL.h"
+
+#include <stdatomic.h>
+
+static const char *const mem_tag_names[] = {[MEM_TAG_UNTAGGED] = "untagged",
+                                            [MEM_TAG_RENDERER] = "renderer",
+                                            [MEM_TAG_UI] = "ui",
+                                            [MEM_TAG_TILEMAP] = "tilemap",
+                                            [MEM_TAG_GAME] = "game",
+                                            [MEM_TAG_PROFILER] = "profiler"};
+static_assert(sizeof(mem_tag_names) / sizeof(mem_tag_names[0]) == MEM_TAG_COUNT,
+              SDL_FILE ": All memory tags must have a declared name.");
+
+#define MEM_HEADER_MAGIC 0x4D454D54u // "MEMT"
+#define MEM_TAG_STACK_DEPTH 16
+#define MEM_WARNING_INTERVAL_FRAMES 300 // steady-state warnings at most once every this many frames
+
+// Prepended to every block. 16 bytes keeps the user pointer as aligned as the underlying malloc's.
+typedef struct MemHeader {
+    size_t size;
+    Uint32 tag;
+    Uint32 magic;
+} MemHeader;
+static_assert(sizeof(MemHeader) == 16, SDL_FILE ": MemHeader must preserve malloc alignment.");
+
+typedef struct MemTagCounters {
+    _Atomic Uint64 live_bytes;
+    _Atomic Uint64 live_count;
+    _Atomic Uint64 peak_bytes;
+    _Atomic Uint32 frame_alloc_count;
+    _Atomic Uint32 frame_free_count;
+    _Atomic Uint64 frame_alloc_bytes;
+} MemTagCounters;
+
+static SDL_malloc_func orig_malloc = nullptr;
+static SDL_calloc_func orig_calloc = nullptr;
+static SDL_realloc_func orig_realloc = nullptr;
+static SDL_free_func orig_free = nullptr;
+static bool installed = false;
+
+static MemTagCounters counters[MEM_TAG_COUNT];
+static _Atomic Uint64 total_live_bytes;
+static _Atomic Uint64 total_peak_bytes;
+
+// main thread only, written by MEM_frameEnd()
+static MemTagStats last_frame[MEM_TAG_COUNT];
+static Uint64 frames_since_warmup_reset = 0;
+static Uint64 frames_since_warning = MEM_WARNING_INTERVAL_FRAMES;
+
+static thread_local Uint8 tls_tags[MEM_TAG_STACK_DEPTH];
+static thread_local int tls_tag_depth = 0;
+
+static MemTag current_tag(void) {
+    if (tls_tag_depth <= 0) {
+        return MEM_TAG_UNTAGGED;
+    }
+    const int top = tls_tag_depth <= MEM_TAG_STACK_DEPTH ? tls_tag_depth - 1 : MEM_TAG_STACK_DEPTH - 1;
+    return (MemTag)tls_tags[top];
+}
+
+static void update_peak(_Atomic Uint64 *const peak, const Uint64 value) {
+    Uint64 current = atomic_load_explicit(peak, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(peak, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// Fills the header of a fresh block and returns the user pointer.
+static void *track_alloc(MemHeader *const header, const size_t size) {
+    const MemTag tag = current_tag();
+    header->size = size;
+    header->tag = (Uint32)tag;
+    header->magic = MEM_HEADER_MAGIC;
+
+    MemTagCounters *const tag_counters = &counters[tag];
+    const Uint64 live = atomic_fetch_add_explicit(&tag_counters->live_bytes, size, memory_order_relaxed) + size;
+    atomic_fetch_add_explicit(&tag_counters->live_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tag_counters->frame_alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tag_counters->frame_alloc_bytes, size, memory_order_relaxed);
+    update_peak(&tag_counters->peak_bytes, live);
+
+    const Uint64 total = atomic_fetch_add_explicit(&total_live_bytes, size, memory_order_relaxed) + size;
+    update_peak(&total_peak_bytes, total);
+
+    return header + 1;
+}
+
+static void track_free(const MemHeader *const header) {
+    SDL_assert(header->magic == MEM_HEADER_MAGIC && "Block not allocated by the tracker");
+    MemTagCounters *const tag_counters = &counters[header->tag < MEM_TAG_COUNT ? header->tag : MEM_TAG_UNTAGGED];
+    atomic_fetch_sub_explicit(&tag_counters->live_bytes, header->size, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&tag_counters->live_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tag_counters->frame_free_count, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&total_live_bytes, header->size, memory_order_relaxed);
+}
+
+static void *SDLCALL tracked_malloc(const size_t size) {
+    if (size > SIZE_MAX - sizeof(MemHeader)) {
+        return nullptr;
+    }
+    MemHeader *const header = orig_malloc(sizeof(MemHeader) + size);
+    return header ? track_alloc(header, size) : nullptr;
+}
+
+static void *SDLCALL tracked_calloc(const size_t count, const size_t size) {
+    if (size != 0 && count > (SIZE_MAX - sizeof(MemHeader)) / size) {
+        return nullptr;
+    }
+    MemHeader *const header = orig_calloc(1, sizeof(MemHeader) + count * size);
+    return header ? track_alloc(header, count * size) : nullptr;
+}
+
+static void *SDLCALL tracked_realloc(void *const mem, const size_t size) {
+    if (!mem) {
+        return tracked_malloc(size);
+    }
+    if (size > SIZE_MAX - sizeof(MemHeader)) {
+        return nullptr;
+    }
+
+    MemHeader *const old_header = (MemHeader *)mem - 1;
+    const MemHeader old = *old_header;
+    MemHeader *const header = orig_realloc(old_header, sizeof(MemHeader) + size);
+    if (!header) {
+        return nullptr; // the old block is untouched and still counted
+    }
+    track_free(&old);
+    return track_alloc(header, size);
+}
+
+static void SDLCALL tracked_free(void *const mem) {
+    if (!mem) {
+        return;
+    }
+    MemHeader *const header = (MemHeader *)mem - 1;
+    track_free(header);
+    orig_free(header);
+}
+
+bool MEM_installTracker(void) {
+    if (installed) {
+        return true;
+    }
+    if (SDL_GetNumAllocations() > 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "MemTrack: %d SDL allocations already made, the tracker must be installed first",
+                     SDL_GetNumAllocations());
+        return false;
+    }
+
+    SDL_GetOriginalMemoryFunctions(&orig_malloc, &orig_calloc, &orig_realloc, &orig_free);
+    if (!SDL_SetMemoryFunctions(tracked_malloc, tracked_calloc, tracked_realloc, tracked_free)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MemTrack: SDL_SetMemoryFunctions failed: %s", SDL_GetError());
+        return false;
+    }
+    installed = true;
+    return true;
+}
+
+bool MEM_isTrackerInstalled(void) {
+    return installed;
+}
+
+void MEM_pushTag(const MemTag tag) {
+    if (tls_tag_depth < MEM_TAG_STACK_DEPTH) {
+        tls_tags[tls_tag_depth] = (Uint8)(tag < MEM_TAG_COUNT ? tag : MEM_TAG_UNTAGGED);
+    }
+    tls_tag_depth++; // past the stack depth the innermost stored tag stays in effect
+}
+
+void MEM_popTag(void) {
+    SDL_assert(tls_tag_depth > 0 && "MEM_popTag without MEM_pushTag");
+    if (tls_tag_depth > 0) {
+        tls_tag_depth--;
+    }
+}
+
+void MEM_resetWarmup(void) {
+    frames_since_warmup_reset = 0;
+}
+
+void MEM_frameEnd(void) {
+    if (!installed) {
+        return;
+    }
+
+    Uint32 alloc_count = 0;
+    Uint64 alloc_bytes = 0;
+    MemTag worst_tag = MEM_TAG_UNTAGGED;
+    for (MemTag tag = 0; tag < MEM_TAG_COUNT; tag++) {
+        MemTagCounters *const tag_counters = &counters[tag];
+        MemTagStats *const stats = &last_frame[tag];
+        stats->frame_alloc_count = atomic_exchange_explicit(&tag_counters->frame_alloc_count, 0, memory_order_relaxed);
+        stats->frame_free_count = atomic_exchange_explicit(&tag_counters->frame_free_count, 0, memory_order_relaxed);
+        stats->frame_alloc_bytes = atomic_exchange_explicit(&tag_counters->frame_alloc_bytes, 0, memory_order_relaxed);
+
+        alloc_count += stats->frame_alloc_count;
+        alloc_bytes += stats->frame_alloc_bytes;
+        if (stats->frame_alloc_count > last_frame[worst_tag].frame_alloc_count) {
+            worst_tag = tag;
+        }
+    }
+
+    frames_since_warmup_reset++;
+    frames_since_warning++;
+    if (alloc_count > 0 && frames_since_warmup_reset > MEM_WARMUP_FRAMES &&
+        frames_since_warning >= MEM_WARNING_INTERVAL_FRAMES) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "MemTrack: steady-state allocation, %u allocs (%" SDL_PRIu64 " bytes) this frame, most in '%s'",
+                    alloc_count,
+                    alloc_bytes,
+                    mem_tag_names[worst_tag]);
+        frames_since_warning = 0;
+    }
+}
+
+const char *MEM_tagName(const MemTag tag) {
+    return tag < MEM_TAG_COUNT ? mem_tag_names[tag] : "unknown";
+}
+
+void MEM_getTagStats(const MemTag tag, MemTagStats *const out_stats) {
+    if (!out_stats) {
+        return;
+    }
+    *out_stats = (MemTagStats){0};
+    if (!installed || tag >= MEM_TAG_COUNT) {
+        return;
+    }
+
+    const MemTagCounters *const tag_counters = &counters[tag];
+    *out_stats = last_frame[tag];
+    out_stats->live_bytes = atomic_load_explicit(&tag_counters->live_bytes, memory_order_relaxed);
+    out_stats->live_count = atomic_load_explicit(&tag_counters->live_count, memory_order_relaxed);
+    out_stats->peak_bytes = atomic_load_explicit(&tag_counters->peak_bytes, memory_order_relaxed);
+}
+
+void MEM_getTotalStats(MemTagStats *const out_stats) {
+    if (!out_stats) {
+        return;
+    }
+    *out_stats = (MemTagStats){0};
+    for (MemTag tag = 0; tag < MEM_TAG_COUNT; tag++) {
+        MemTagStats stats;
+        MEM_getTagStats(tag, &stats);
+        out_stats->live_bytes += stats.live_bytes;
+        out_stats->live_count += stats.live_count;
+        out_stats->frame_alloc_count += stats.frame_alloc_count;
+        out_stats->frame_free_count += stats.frame_free_count;
+        out_stats->frame_alloc_bytes += stats.frame_alloc_bytes;
+    }
+    out_stats->peak_bytes = installed ? atomic_load_explicit(&total_peak_bytes, memory_order_relaxed) : 0;
+}
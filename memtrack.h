@@ -0,0 +1,86 @@
+#ifndef MISO_MEMTRACK_H
+#define MISO_MEMTRACK_H
+
+#include "SDL3/SDL_stdinc.h"
+
+// Allocation tracker built on SDL_SetMemoryFunctions: every SDL_malloc/calloc/realloc/free (ours, SDL's, SDL_ttf's and
+// SDL_image's) is counted per frame and per subsystem tag. The engine's rule is zero allocations per frame once warmed
+// up; MEM_frameEnd() warns when that is broken.
+
+typedef enum MemTag {
+    MEM_TAG_UNTAGGED,
+    MEM_TAG_RENDERER,
+    MEM_TAG_UI,
+    MEM_TAG_TILEMAP,
+    MEM_TAG_GAME,
+    MEM_TAG_PROFILER,
+    MEM_TAG_COUNT //enum counter
+} MemTag;
+
+typedef struct MemTagStats {
+    Uint64 live_bytes;
+    Uint64 live_count;
+    Uint64 peak_bytes;
+    // during the last finished frame, reallocs count as one alloc of the new size
+    Uint32 frame_alloc_count;
+    Uint32 frame_free_count;
+    Uint64 frame_alloc_bytes;
+} MemTagStats;
+
+/**
+ * Routes SDL's allocator through the tracker.
+ * Must be the first thing main() does: memory allocated before the swap would be freed with the wrong header.
+ * @return false if SDL already made allocations or the hooks could not be set.
+ */
+bool MEM_installTracker(void);
+
+bool MEM_isTrackerInstalled(void);
+
+/**
+ * Tags the allocations made by the calling thread until the matching MEM_popTag(). Tags nest.
+ */
+void MEM_pushTag(MemTag tag);
+void MEM_popTag(void);
+
+static inline void MEM_tagScopeEnd(const char *const unused) {
+    (void)unused;
+    MEM_popTag();
+}
+
+#define MEM_CONCAT_(a, b) a##b
+#define MEM_CONCAT(a, b) MEM_CONCAT_(a, b)
+
+#ifdef MISO_MEMTRACK
+// Tag that is popped automatically when the enclosing scope ends.
+#define MEM_TAG(tag)                                                                                                   \
+    __attribute__((cleanup(MEM_tagScopeEnd))) const char MEM_CONCAT(mem_tag_, __LINE__) = (MEM_pushTag(tag), 0)
+#else
+#define MEM_TAG(tag) ((void)0)
+#endif
+
+/**
+ * Closes the frame's counters. Called by PROF_frameEnd().
+ * After MEM_WARMUP_FRAMES frames any allocation inside a frame is logged as a steady-state allocation (rate limited).
+ */
+void MEM_frameEnd(void);
+
+#define MEM_WARMUP_FRAMES 300
+
+/**
+ * Starts a new warm-up period, e.g. after loading a map, so the loading allocations are not reported.
+ */
+void MEM_resetWarmup(void);
+
+const char *MEM_tagName(MemTag tag);
+
+/**
+ * Stats of one tag, all zero if the tracker is not installed.
+ */
+void MEM_getTagStats(MemTag tag, MemTagStats *out_stats);
+
+/**
+ * Sum over all tags. peak_bytes is the peak of the total, not the sum of the peaks.
+ */
+void MEM_getTotalStats(MemTagStats *out_stats);
+
+#endif //MISO_MEMTRACK_H
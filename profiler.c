@@ -6,9 +6,15 @@
 
 #include "SDL3/SDL_assert.h"
 #include "SDL3/SDL_timer.h"
+#include "profiler_clock.h"
+#include "profiler_internal.h"
 #include "renderer/ui.h"
 
 #include <assert.h>
+#include <stdatomic.h>
+#if defined(PROF_CLOCK_TSC)
+#include <cpuid.h>
+#endif
 
 static const char *const PROF_category_names[] = {[PROFILER_EVENT_HANDLING] = "event_handling",
                                                   [PROFILER_RENDER_MAP] = "render_map",
@@ -24,9 +30,17 @@ static const char *const PROF_category_names[] = {[PROFILER_EVENT_HANDLING] = "e
 static_assert(sizeof(PROF_category_names) / sizeof(PROF_category_names[0]) == PROFILER_CATEGORY_COUNT,
               SDL_FILE ": All profiler categories must have a declared name.");
 
+const char *PROF_getCategoryName(const ProfilerSampleCategory category) {
+    return category < PROFILER_CATEGORY_COUNT ? PROF_category_names[category] : "unknown";
+}
+
 #define MAX_FRAMES 60
 static constexpr float goal_frame_time = 1.0f * 1000.0f / MAX_FRAMES; // 1.0f / 70.0f = 14.2857 ms per frame
 
+float prof_goal_frame_ms(void) {
+    return goal_frame_time;
+}
+
 #define GRAPH_COUNT 60
 
 typedef struct ProfilerCircularBuffer {
@@ -38,6 +52,78 @@ typedef struct ProfilerCircularBuffer {
 
 ProfilerCircularBuffer prof_samples = {0};
 ProfilerSample measuring_samples[PROFILER_CATEGORY_COUNT] = {0};
+// raw prof_clock_now() ticks of the running frame, added to duration_ms at frame end
+static Uint64 measuring_ticks[PROFILER_CATEGORY_COUNT] = {0};
+
+/* ------------ CLOCK ------------ */
+#define CLOCK_CALIBRATION_MS 5      // startup busy wait against SDL's counter, refined every frame afterwards
+#define CLOCK_REFINE_MIN_MS 250.0   // no refinement until the calibration window is at least this long
+
+static double clock_ms_per_tick = 0.0;
+static Uint64 clock_anchor_ticks = 0;
+static Uint64 clock_anchor_counter = 0; // 0 when the clock has a known frequency and needs no calibration
+
+static void clock_init(void) {
+    if (clock_ms_per_tick > 0.0) {
+        return;
+    }
+
+#if defined(PROF_CLOCK_CNTVCT)
+    Uint64 frequency;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    if (frequency > 0) {
+        clock_ms_per_tick = 1000.0 / (double)frequency;
+        return;
+    }
+#elif defined(PROF_CLOCK_TSC)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Profiler: TSC is not invariant, timings may drift with CPU clocks");
+    }
+#else
+    clock_ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    return;
+#endif
+
+    const Uint64 counter_frequency = SDL_GetPerformanceFrequency();
+    const Uint64 wait = counter_frequency * CLOCK_CALIBRATION_MS / 1000u;
+    clock_anchor_counter = SDL_GetPerformanceCounter();
+    clock_anchor_ticks = prof_clock_now();
+    Uint64 counter;
+    do {
+        counter = SDL_GetPerformanceCounter();
+    } while (counter - clock_anchor_counter < wait);
+    const Uint64 ticks = prof_clock_now();
+
+    const double elapsed_ms = (double)(counter - clock_anchor_counter) * 1000.0 / (double)counter_frequency;
+    clock_ms_per_tick = elapsed_ms / (double)(ticks - clock_anchor_ticks);
+}
+
+// Calibrates over everything since startup, so the error keeps shrinking. Two counter reads, once per frame.
+static void clock_refine(void) {
+    if (clock_anchor_counter == 0) {
+        return;
+    }
+    const Uint64 ticks = prof_clock_now();
+    const Uint64 counter = SDL_GetPerformanceCounter();
+    const double elapsed_ms = (double)(counter - clock_anchor_counter) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    if (elapsed_ms >= CLOCK_REFINE_MIN_MS && ticks > clock_anchor_ticks) {
+        clock_ms_per_tick = elapsed_ms / (double)(ticks - clock_anchor_ticks);
+    }
+}
+
+double prof_clock_ms_per_tick(void) {
+    clock_init();
+    return clock_ms_per_tick;
+}
+
+// Turns the frame's raw category ticks into milliseconds.
+static void convert_measuring_ticks(void) {
+    for (ProfilerSampleCategory category = 0; category < PROFILER_CATEGORY_COUNT; category++) {
+        measuring_samples[category].duration_ms += (float)((double)measuring_ticks[category] * clock_ms_per_tick);
+        measuring_ticks[category] = 0;
+    }
+}
 
 static inline void swap_sample_buffers() {
 
@@ -67,71 +153,678 @@ typedef struct FramesPerSecond {
     float avg;
     float max;
 } FramesPerSecond_t;
-static FramesPerSecond_t frames_per_second = {.min = 1e9f, .avg = 0.0f, .max = -1e9f};
-static float fps_buffer[MAX_FRAMES] = {0};
+static FramesPerSecond_t frames_per_second = {.min = 0.0f, .avg = 0.0f, .max = 0.0f};
 
+// FPS over the frames in the graph window, from the measured frame totals.
 void calculate_FPS() {
-    // Calculate FPS based on the last finished frame sample.
-    //TODO: check if using total_times or samples[PROFILER_FRAME_TOTAL] is better.
-    const float last_frame_fps = 1000.0f / prof_samples.total_times[prof_samples.newest];
-    fps_buffer[prof_samples.newest] = last_frame_fps;
-
-    if (prof_samples.newest == 0) {
-        //reset FPS stats if we are at the beginning of the buffer (full lap, at least GRAPH_COUNT frames have passed)
-        frames_per_second.min = last_frame_fps;
-        // frames_per_second.avg = last_frame_fps;
-        frames_per_second.max = last_frame_fps;
-
-        // SDL_LogDebug(SDL_LOG_CATEGORY_TEST, "Profiler: FPS stats reset. New FPS: %.2f", last_frame_fps);
-        // SDL_LogDebug(SDL_LOG_CATEGORY_TEST, "\tFormula: 1 / %.2f", prof_samples.total_times[prof_samples.newest]);
+    float min_ms = 0.0f;
+    float max_ms = 0.0f;
+    float sum_ms = 0.0f;
+    for (int i = 0; i < prof_samples.count; i++) {
+        const float frame_ms = prof_samples.samples[i][PROFILER_FRAME_TOTAL].duration_ms;
+        min_ms = i == 0 || frame_ms < min_ms ? frame_ms : min_ms;
+        max_ms = frame_ms > max_ms ? frame_ms : max_ms;
+        sum_ms += frame_ms;
+    }
+
+    frames_per_second.min = max_ms > 0.0f ? 1000.0f / max_ms : 0.0f;
+    frames_per_second.max = min_ms > 0.0f ? 1000.0f / min_ms : 0.0f;
+    frames_per_second.avg = sum_ms > 0.0f ? 1000.0f * (float)prof_samples.count / sum_ms : 0.0f;
+}
+
+/* ------------ HISTORY / PERCENTILES ------------ */
+// Log-linear (HDR style) histogram over the last PROF_HISTORY_FRAMES frames, per category. Values are bucketed in
+// microseconds: exact below 2 * HISTO_HALF, then HISTO_HALF buckets per power of two (~3% relative error).
+#define HISTO_SUB_BITS 6
+#define HISTO_HALF (1u << (HISTO_SUB_BITS - 1))
+#define HISTO_MAX_US ((1u << 24) - 1u) // ~16.7 s, longer frames are clamped
+#define HISTO_MAX_SHIFT (23 - (HISTO_SUB_BITS - 1)) // shift of the highest bit of HISTO_MAX_US
+#define HISTO_BUCKETS (2 * HISTO_HALF + HISTO_MAX_SHIFT * HISTO_HALF)
+
+typedef struct ProfilerHistory {
+    float values_ms[PROF_HISTORY_FRAMES][PROFILER_CATEGORY_COUNT]; // ring, oldest value is removed from the histogram
+    Uint16 buckets[PROFILER_CATEGORY_COUNT][HISTO_BUCKETS];
+    double sum_ms[PROFILER_CATEGORY_COUNT];
+    float max_ms[PROFILER_CATEGORY_COUNT];
+    bool max_stale[PROFILER_CATEGORY_COUNT]; // the max left the window, rescanned on the next query
+    int newest;
+    int count;
+} ProfilerHistory;
+static_assert(PROF_HISTORY_FRAMES <= 65535, SDL_FILE ": histogram counts are 16 bit.");
+
+static ProfilerHistory prof_history = {0};
+
+static Uint32 histo_bucket(const float value_ms) {
+    const float value_us = value_ms * 1000.0f;
+    const Uint32 v = value_us <= 0.0f ? 0u : value_us >= (float)HISTO_MAX_US ? HISTO_MAX_US : (Uint32)value_us;
+    if (v < 2 * HISTO_HALF) {
+        return v;
+    }
+    const Uint32 msb = 31u - (Uint32)__builtin_clz(v);
+    const Uint32 shift = msb - (HISTO_SUB_BITS - 1);
+    return 2 * HISTO_HALF + (shift - 1) * HISTO_HALF + ((v >> shift) - HISTO_HALF);
+}
+
+// Upper bound (exclusive, in ms) of the values that land in the bucket.
+static float histo_bucket_upper_ms(const Uint32 bucket) {
+    if (bucket < 2 * HISTO_HALF) {
+        return (float)(bucket + 1) / 1000.0f;
+    }
+    const Uint32 shift = (bucket - 2 * HISTO_HALF) / HISTO_HALF + 1;
+    const Uint32 lower = ((bucket - 2 * HISTO_HALF) % HISTO_HALF + HISTO_HALF) << shift;
+    return (float)(lower + (1u << shift)) / 1000.0f;
+}
+
+static void record_history(void) {
+    ProfilerHistory *const h = &prof_history;
+    if (h->count > 0) {
+        h->newest = (h->newest + 1) % PROF_HISTORY_FRAMES;
+    }
+
+    const bool full = h->count == PROF_HISTORY_FRAMES;
+    for (ProfilerSampleCategory category = 0; category < PROFILER_CATEGORY_COUNT; category++) {
+        if (full) {
+            const float old_ms = h->values_ms[h->newest][category];
+            h->buckets[category][histo_bucket(old_ms)]--;
+            h->sum_ms[category] -= old_ms;
+            h->max_stale[category] |= old_ms >= h->max_ms[category];
+        }
+        const float value_ms = measuring_samples[category].duration_ms;
+        h->values_ms[h->newest][category] = value_ms;
+        h->buckets[category][histo_bucket(value_ms)]++;
+        h->sum_ms[category] += value_ms;
+        if (value_ms >= h->max_ms[category]) {
+            h->max_ms[category] = value_ms;
+            h->max_stale[category] = false;
+        }
+    }
+
+    if (!full) {
+        h->count++;
+    }
+}
+
+// Only needed when the max is the value that just left the window, so the full scan is rare
+static float history_max(const ProfilerSampleCategory category) {
+    ProfilerHistory *const h = &prof_history;
+    if (h->max_stale[category]) {
+        float max_ms = 0.0f;
+        for (int i = 0; i < h->count; i++) {
+            const float value_ms = h->values_ms[i][category];
+            max_ms = value_ms > max_ms ? value_ms : max_ms;
+        }
+        h->max_ms[category] = max_ms;
+        h->max_stale[category] = false;
+    }
+    return h->max_ms[category];
+}
+
+// Fills the percentiles from one walk over the category's histogram, `out->max` must already be set
+static void histo_percentiles(const ProfilerSampleCategory category, ProfilerPercentiles *const out) {
+    static constexpr float fractions[] = {0.50f, 0.95f, 0.99f, 0.999f};
+    float *const results[] = {&out->p50, &out->p95, &out->p99, &out->p999};
+    constexpr int result_count = (int)(sizeof(fractions) / sizeof(fractions[0]));
+
+    const ProfilerHistory *const h = &prof_history;
+    int next = 0;
+    int seen = 0;
+    for (Uint32 bucket = 0; bucket < HISTO_BUCKETS && next < result_count; bucket++) {
+        seen += h->buckets[category][bucket];
+        const float upper = histo_bucket_upper_ms(bucket);
+        while (next < result_count && seen >= (int)SDL_ceilf(fractions[next] * (float)h->count)) {
+            *results[next++] = upper < out->max ? upper : out->max;
+        }
+    }
+    for (; next < result_count; next++) {
+        *results[next] = out->max;
+    }
+}
+
+bool PROF_getPercentiles(const ProfilerSampleCategory category, ProfilerPercentiles *const out) {
+    if (!out || category >= PROFILER_CATEGORY_COUNT) {
+        return false;
+    }
+
+    const ProfilerHistory *const h = &prof_history;
+    *out = (ProfilerPercentiles){.sample_count = h->count};
+    if (h->count == 0) {
+        return false;
+    }
+
+    out->max = history_max(category);
+    out->mean = (float)(h->sum_ms[category] / (double)h->count);
+    histo_percentiles(category, out);
+    return true;
+}
+
+/* ------------ ZONES ------------ */
+// Every thread writes begin/end records into its own single-producer ring buffer. The main thread drains all rings at
+// PROF_frameEnd() and rebuilds the frame timeline (one lane per thread), then folds it into per-lane call trees.
+#define PROF_THREAD_RING_SIZE 8192 // records per thread, power of two
+#define PROF_THREAD_RING_MASK (PROF_THREAD_RING_SIZE - 1)
+static_assert((PROF_THREAD_RING_SIZE & PROF_THREAD_RING_MASK) == 0, SDL_FILE ": ring size must be a power of two.");
+
+typedef struct ProfilerZoneRecord {
+    const char *name; // nullptr marks the end of the innermost open zone
+    Uint64 time;
+} ProfilerZoneRecord;
+
+typedef struct ProfilerOpenZone {
+    const char *name;
+    int event; // timeline event of the current frame, -1 if it did not fit
+} ProfilerOpenZone;
+
+typedef struct ProfilerThreadBuffer {
+    alignas(64) atomic_uint head; // written by the owning thread
+    alignas(64) atomic_uint tail; // written by the main thread while merging
+    atomic_uint dropped;
+
+    // owning thread only
+    alignas(64) int recorded_depth; // zones with a begin record whose end is still pending
+    int skipped_depth;              // dropped zones (and everything nested in them) still open
+
+    // written once before the buffer is published, read-only afterwards
+    char name[PROF_MAX_LANE_NAME];
+
+    // main thread only
+    ProfilerOpenZone open[PROF_MAX_ZONE_DEPTH];
+    int open_depth;
+
+    ProfilerZoneRecord records[PROF_THREAD_RING_SIZE];
+} ProfilerThreadBuffer;
+
+#define ZONE_LOOKUP_SIZE 256 // power of two, at least 2x PROF_MAX_ZONE_STATS
+static_assert(ZONE_LOOKUP_SIZE >= 2 * PROF_MAX_ZONE_STATS && (ZONE_LOOKUP_SIZE & (ZONE_LOOKUP_SIZE - 1)) == 0,
+              SDL_FILE ": zone lookup table must be a power of two with room to spare.");
+
+static _Atomic(ProfilerThreadBuffer *) prof_threads[PROF_MAX_THREADS];
+static atomic_uint prof_thread_count = 0;
+static thread_local ProfilerThreadBuffer *tls_thread_buffer = nullptr;
+static thread_local bool tls_thread_failed = false;
+// bumped by PROF_shutdown when it frees the buffers, a thread's cached buffer is only valid in its own generation
+static atomic_uint prof_generation = 0;
+static thread_local unsigned tls_thread_generation = 0;
+static SDL_ThreadID prof_main_thread = 0; // set by PROF_init
+static thread_local bool tls_is_main_thread = false; // saves a thread id query on every PROF_start/stop
+
+static ProfilerZoneEvent zone_events[PROF_MAX_ZONE_EVENTS];
+static int zone_event_count = 0;
+static int zone_dropped = 0;
+static Uint64 zone_frame_start = 0;
+static Uint64 zone_last_merge = 0;
+static Uint64 prof_frame_index = 0;
+
+static ProfilerZoneStats zone_stats[PROF_MAX_ZONE_STATS];
+static int zone_stat_count = 0;
+static ProfilerLaneStats lane_stats[PROF_MAX_THREADS];
+static int lane_stat_count = 0;
+static int zone_last_event_count = 0;
+static int zone_last_dropped = 0;
+
+static ProfilerThreadBuffer *register_thread(const char *const name) {
+    if (tls_thread_failed) {
+        return nullptr;
+    }
+
+    const unsigned lane = atomic_fetch_add_explicit(&prof_thread_count, 1u, memory_order_relaxed);
+    ProfilerThreadBuffer *const buffer =
+        lane < PROF_MAX_THREADS ? SDL_aligned_alloc(alignof(ProfilerThreadBuffer), sizeof(ProfilerThreadBuffer))
+                                : nullptr;
+    if (!buffer) {
+        SDL_LogWarn(
+            SDL_LOG_CATEGORY_APPLICATION, "Profiler: no zone buffer for thread %" SDL_PRIu64, SDL_GetCurrentThreadID());
+        tls_thread_failed = true;
+        return nullptr;
+    }
+
+    SDL_memset(buffer, 0, sizeof(ProfilerThreadBuffer));
+    if (name) {
+        SDL_strlcpy(buffer->name, name, sizeof(buffer->name));
     } else {
-        // Update FPS stats
-        if (last_frame_fps < frames_per_second.min) {
-            frames_per_second.min = last_frame_fps;
+        SDL_snprintf(buffer->name, sizeof(buffer->name), "thread %" SDL_PRIu64, SDL_GetCurrentThreadID());
+    }
+
+    atomic_store_explicit(&prof_threads[lane], buffer, memory_order_release);
+    tls_thread_buffer = buffer;
+    tls_thread_generation = atomic_load_explicit(&prof_generation, memory_order_acquire);
+    return buffer;
+}
+
+// The calling thread's buffer, or nullptr if it has none or PROF_shutdown has freed it since it was registered.
+static inline ProfilerThreadBuffer *thread_buffer(void) {
+    ProfilerThreadBuffer *const buffer = tls_thread_buffer;
+    if (buffer && unlikely(tls_thread_generation != atomic_load_explicit(&prof_generation, memory_order_acquire))) {
+        tls_thread_buffer = nullptr;
+        return nullptr;
+    }
+    return buffer;
+}
+
+void PROF_setThreadName(const char *const name) {
+    if (!name) {
+        return;
+    }
+    // the main thread reads published names without a lock, so a lane keeps the name it was registered with
+    const ProfilerThreadBuffer *const buffer = thread_buffer();
+    if (buffer) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "Profiler: thread already registered as \"%s\", cannot rename it to \"%s\"",
+                    buffer->name,
+                    name);
+        return;
+    }
+    register_thread(name);
+}
+
+void PROF_zoneBegin(const char *const name) {
+    ProfilerThreadBuffer *buffer = thread_buffer();
+    if (unlikely(!buffer)) {
+        buffer = register_thread(nullptr);
+    }
+    if (unlikely(!buffer)) {
+        return;
+    }
+
+    if (unlikely(buffer->skipped_depth > 0 || buffer->recorded_depth >= PROF_MAX_ZONE_DEPTH)) {
+        buffer->skipped_depth++;
+        atomic_fetch_add_explicit(&buffer->dropped, 1u, memory_order_relaxed);
+        return;
+    }
+
+    const unsigned head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    const unsigned tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    // keep room for the end record of every open zone, including this one
+    if (unlikely(head - tail + (unsigned)buffer->recorded_depth + 2u > PROF_THREAD_RING_SIZE)) {
+        buffer->skipped_depth++;
+        atomic_fetch_add_explicit(&buffer->dropped, 1u, memory_order_relaxed);
+        return;
+    }
+
+    ProfilerZoneRecord *const record = &buffer->records[head & PROF_THREAD_RING_MASK];
+    record->name = name;
+    buffer->recorded_depth++;
+    record->time = prof_clock_now(); // last, so bookkeeping is not measured
+    atomic_store_explicit(&buffer->head, head + 1u, memory_order_release);
+}
+
+void PROF_zoneEnd(void) {
+    const Uint64 end_time = prof_clock_now();
+    ProfilerThreadBuffer *const buffer = thread_buffer();
+    if (unlikely(!buffer)) {
+        return;
+    }
+
+    if (buffer->skipped_depth > 0) {
+        buffer->skipped_depth--;
+        return;
+    }
+    if (unlikely(buffer->recorded_depth <= 0)) {
+        return; // unbalanced end
+    }
+
+    // room for this record was reserved by the matching begin
+    const unsigned head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    ProfilerZoneRecord *const record = &buffer->records[head & PROF_THREAD_RING_MASK];
+    record->name = nullptr;
+    record->time = end_time;
+    buffer->recorded_depth--;
+    atomic_store_explicit(&buffer->head, head + 1u, memory_order_release);
+}
+
+static int push_zone_event(const char *const name, const int lane, const ProfilerThreadBuffer *const buffer,
+                           const Uint64 start) {
+    const int parent = buffer->open_depth > 0 ? buffer->open[buffer->open_depth - 1].event : -1;
+    if (buffer->open_depth > 0 && parent < 0) {
+        zone_dropped++; // parent did not fit
+        return -1;
+    }
+    if (zone_event_count >= PROF_MAX_ZONE_EVENTS) {
+        zone_dropped++;
+        return -1;
+    }
+
+    const int event = zone_event_count++;
+    zone_events[event] =
+        (ProfilerZoneEvent){.name = name, .start = start, .end = start, .parent = parent, .lane = lane};
+    return event;
+}
+
+static void merge_thread_buffer(ProfilerThreadBuffer *const buffer, const int lane, const Uint64 merge_time) {
+    // zones still open at the previous merge continue from there
+    const int carried = buffer->open_depth;
+    buffer->open_depth = 0;
+    for (int depth = 0; depth < carried; depth++) {
+        const int event = push_zone_event(buffer->open[depth].name, lane, buffer, zone_last_merge);
+        buffer->open[depth].event = event;
+        buffer->open_depth++;
+    }
+
+    unsigned tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+    const unsigned head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+    for (; tail != head; tail++) {
+        const ProfilerZoneRecord *const record = &buffer->records[tail & PROF_THREAD_RING_MASK];
+        if (record->name) {
+            const int event = push_zone_event(record->name, lane, buffer, record->time);
+            buffer->open[buffer->open_depth++] = (ProfilerOpenZone){.name = record->name, .event = event};
+        } else if (buffer->open_depth > 0) {
+            const int event = buffer->open[--buffer->open_depth].event;
+            if (event >= 0) {
+                zone_events[event].end = record->time;
+            }
+        }
+    }
+    atomic_store_explicit(&buffer->tail, tail, memory_order_release);
+
+    // still open: cut at the frame boundary, carried into the next frame
+    for (int depth = 0; depth < buffer->open_depth; depth++) {
+        const int event = buffer->open[depth].event;
+        if (event >= 0) {
+            zone_events[event].end = merge_time;
+        }
+    }
+
+    zone_dropped += (int)atomic_exchange_explicit(&buffer->dropped, 0u, memory_order_relaxed);
+}
+
+static int find_or_add_zone_stat(int *const lookup, const char *const name, const int parent, const int lane) {
+    const Uint32 hash =
+        (Uint32)((uintptr_t)name >> 3) ^ ((Uint32)(parent + 1) * 0x9E3779B1u) ^ ((Uint32)lane * 0x85EBCA6Bu);
+    for (Uint32 probe = 0; probe < ZONE_LOOKUP_SIZE; probe++) {
+        const Uint32 slot = (hash + probe) & (ZONE_LOOKUP_SIZE - 1);
+        const int stat = lookup[slot];
+        if (stat < 0) {
+            if (zone_stat_count >= PROF_MAX_ZONE_STATS) {
+                return -1;
+            }
+            const int new_stat = zone_stat_count++;
+            zone_stats[new_stat] = (ProfilerZoneStats){
+                .name = name,
+                .parent = parent,
+                .lane = lane,
+                .depth = parent >= 0 ? zone_stats[parent].depth + 1 : 0,
+            };
+            lookup[slot] = new_stat;
+            return new_stat;
+        }
+        if (zone_stats[stat].name == name && zone_stats[stat].parent == parent && zone_stats[stat].lane == lane) {
+            return stat;
+        }
+    }
+    return -1;
+}
+
+// Builds the zone call trees for the frame. Events of a lane are stored in begin order, so parents are always
+// processed before their children.
+static void aggregate_zones(const Uint64 frame_start, const Uint64 frame_end) {
+    static int event_stat[PROF_MAX_ZONE_EVENTS];
+    int lookup[ZONE_LOOKUP_SIZE];
+    SDL_memset(lookup, 0xFF, sizeof(lookup)); // -1
+
+    const double ms_per_tick = clock_ms_per_tick;
+    const double frame_ms = frame_end > frame_start ? (double)(frame_end - frame_start) * ms_per_tick : 0.0;
+    zone_stat_count = 0;
+    for (int lane = 0; lane < lane_stat_count; lane++) {
+        lane_stats[lane].busy_ms = 0.0f;
+        lane_stats[lane].zone_count = 0;
+    }
+
+    for (int i = 0; i < zone_event_count; i++) {
+        const ProfilerZoneEvent *const event = &zone_events[i];
+        const float duration_ms = (float)((double)(event->end - event->start) * ms_per_tick);
+        ProfilerLaneStats *const lane = &lane_stats[event->lane];
+        lane->zone_count++;
+        if (event->parent < 0) {
+            lane->busy_ms += duration_ms;
+        }
+
+        const int parent_stat = event->parent >= 0 ? event_stat[event->parent] : -1;
+        if (event->parent >= 0 && parent_stat < 0) {
+            event_stat[i] = -1; // parent did not fit in the stats table
+            continue;
+        }
+
+        const int stat = find_or_add_zone_stat(lookup, event->name, parent_stat, event->lane);
+        event_stat[i] = stat;
+        if (stat < 0) {
+            continue;
         }
-        if (last_frame_fps > frames_per_second.max) {
-            frames_per_second.max = last_frame_fps;
+
+        zone_stats[stat].call_count++;
+        zone_stats[stat].total_ms += duration_ms;
+        zone_stats[stat].self_ms += duration_ms;
+        if (parent_stat >= 0) {
+            zone_stats[parent_stat].self_ms -= duration_ms;
+        }
+    }
+
+    for (int lane = 0; lane < lane_stat_count; lane++) {
+        lane_stats[lane].utilization = frame_ms > 0.0 ? (float)(lane_stats[lane].busy_ms / frame_ms) : 0.0f;
+    }
+}
+
+static void merge_zones(const Uint64 frame_end) {
+    zone_event_count = 0;
+
+    const unsigned thread_count = atomic_load_explicit(&prof_thread_count, memory_order_acquire);
+    lane_stat_count = thread_count < PROF_MAX_THREADS ? (int)thread_count : PROF_MAX_THREADS;
+    for (int lane = 0; lane < lane_stat_count; lane++) {
+        ProfilerThreadBuffer *const buffer = atomic_load_explicit(&prof_threads[lane], memory_order_acquire);
+        lane_stats[lane].name = buffer ? buffer->name : "";
+        if (buffer) {
+            merge_thread_buffer(buffer, lane, frame_end);
         }
     }
-    frames_per_second.avg = (frames_per_second.avg * (float)(prof_samples.count - 1) + last_frame_fps) /
-                            (float)(prof_samples.count); //NOTE: check
-    // SDL_LogDebug(SDL_LOG_CATEGORY_TEST, "FPS stats updated. New AVG_FPS: %.2f || last: %.2f", frames_per_second.avg, last_frame_fps);
+
+    aggregate_zones(zone_frame_start, frame_end);
+    zone_last_merge = frame_end;
+    zone_last_event_count = zone_event_count;
+    zone_last_dropped = zone_dropped;
+    zone_dropped = 0;
+}
+
+int PROF_getZoneStats(const ProfilerZoneStats **const out_stats) {
+    if (out_stats) {
+        *out_stats = zone_stats;
+    }
+    return zone_stat_count;
+}
+
+int PROF_getLaneStats(const ProfilerLaneStats **const out_stats) {
+    if (out_stats) {
+        *out_stats = lane_stats;
+    }
+    return lane_stat_count;
+}
+
+// false everywhere until PROF_init, so no thread writes the main thread's state before it is known
+static inline bool is_main_thread(void) {
+    return tls_is_main_thread;
+}
+
+/* ------------ COUNTERS ------------ */
+typedef struct ProfilerCounter {
+    const char *name;
+    double current; // accumulating for the running frame
+    double history[PROF_COUNTER_HISTORY];
+} ProfilerCounter;
+
+static ProfilerCounter prof_counters[PROF_MAX_COUNTERS];
+static int prof_counter_count = 0;
+static int counter_history_newest = PROF_COUNTER_HISTORY - 1; // shared by all counters, they advance together
+static int counter_history_count = 0;
+
+static ProfilerCounter *find_counter(const char *const name) {
+    for (int i = 0; i < prof_counter_count; i++) {
+        // names are usually the same literal, only compare contents when the pointers differ
+        if (prof_counters[i].name == name || SDL_strcmp(prof_counters[i].name, name) == 0) {
+            return &prof_counters[i];
+        }
+    }
+    if (prof_counter_count >= PROF_MAX_COUNTERS) {
+        return nullptr;
+    }
+
+    ProfilerCounter *const counter = &prof_counters[prof_counter_count++];
+    *counter = (ProfilerCounter){.name = name};
+    return counter;
+}
+
+void PROF_counter(const char *const name, const double value) {
+    if (unlikely(!name || !is_main_thread())) {
+        return;
+    }
+    ProfilerCounter *const counter = find_counter(name);
+    if (counter) {
+        counter->current = value;
+    }
+}
+
+void PROF_counterAdd(const char *const name, const double delta) {
+    if (unlikely(!name || !is_main_thread())) {
+        return;
+    }
+    ProfilerCounter *const counter = find_counter(name);
+    if (counter) {
+        counter->current += delta;
+    }
+}
+
+// Moves this frame's values into the history (and the trace frame) and restarts them from 0.
+static void record_counters(ProfilerTraceFrame *const trace_frame) {
+    counter_history_newest = (counter_history_newest + 1) % PROF_COUNTER_HISTORY;
+    if (counter_history_count < PROF_COUNTER_HISTORY) {
+        counter_history_count++;
+    }
+
+    for (int i = 0; i < prof_counter_count; i++) {
+        ProfilerCounter *const counter = &prof_counters[i];
+        counter->history[counter_history_newest] = counter->current;
+        trace_frame->counters[i] = (ProfilerCounterValue){.name = counter->name, .value = counter->current};
+        counter->current = 0.0;
+    }
+    trace_frame->counter_count = prof_counter_count;
+}
+
+static void counter_stats(const ProfilerCounter *const counter, ProfilerCounterStats *const out) {
+    *out = (ProfilerCounterStats){.name = counter->name};
+    if (counter_history_count == 0) {
+        return;
+    }
+
+    out->value = counter->history[counter_history_newest];
+    out->min = out->value;
+    out->max = out->value;
+    double sum = 0.0;
+    for (int i = 0; i < counter_history_count; i++) {
+        const double value = counter->history[i];
+        out->min = value < out->min ? value : out->min;
+        out->max = value > out->max ? value : out->max;
+        sum += value;
+    }
+    out->avg = sum / (double)counter_history_count;
+}
+
+int PROF_getCounterStats(ProfilerCounterStats *const out_stats, const int max_stats) {
+    if (!out_stats) {
+        return 0;
+    }
+    const int count = prof_counter_count < max_stats ? prof_counter_count : max_stats;
+    for (int i = 0; i < count; i++) {
+        counter_stats(&prof_counters[i], &out_stats[i]);
+    }
+    return count;
+}
+
+void PROF_init(void) {
+    if (prof_main_thread != 0) {
+        return;
+    }
+    prof_main_thread = SDL_GetCurrentThreadID();
+    tls_is_main_thread = true;
+    if (!thread_buffer()) {
+        register_thread("main");
+    }
+    clock_init();
 }
 
 void PROF_frameStart() {
+    if (unlikely(prof_main_thread == 0)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Profiler: PROF_frameStart before PROF_init");
+        PROF_init();
+    }
+
     if (measuring_samples[PROFILER_FRAME_TOTAL].start_time != 0) {
         //didn't do PROF_frameEnd...
         PROF_frameEnd();
     }
 
     SDL_memset(measuring_samples, 0, sizeof(ProfilerSample) * PROFILER_CATEGORY_COUNT);
+    SDL_memset(measuring_ticks, 0, sizeof(measuring_ticks));
 
     PROF_start(PROFILER_FRAME_TOTAL);
+    zone_frame_start = measuring_samples[PROFILER_FRAME_TOTAL].start_time;
+    if (zone_last_merge == 0) {
+        zone_last_merge = zone_frame_start;
+    }
 }
 
 void PROF_frameEnd() {
     PROF_stop(PROFILER_FRAME_TOTAL);
+    const Uint64 frame_end = prof_clock_now();
+    clock_refine();
+    convert_measuring_ticks();
 
-    //TODO: swap sample buffers here? thinking thoughts
     swap_sample_buffers();
     calculate_FPS();
+    record_history();
+    merge_zones(frame_end);
+    MEM_frameEnd();
+
+    ProfilerTraceFrame trace_frame = {
+        .index = prof_frame_index++,
+        .start = zone_frame_start,
+        .end = frame_end,
+        .events = zone_events,
+        .event_count = zone_event_count,
+        .dropped_event_count = zone_last_dropped,
+        .render = *Renderer_GetFrameStats(),
+    };
+    for (ProfilerSampleCategory category = 0; category < PROFILER_CATEGORY_COUNT; category++) {
+        trace_frame.category_ms[category] = measuring_samples[category].duration_ms;
+    }
+    for (MemTag tag = 0; tag < MEM_TAG_COUNT; tag++) {
+        MEM_getTagStats(tag, &trace_frame.mem[tag]);
+    }
+    record_counters(&trace_frame);
+    prof_trace_frame_end(&trace_frame);
 }
 
 //starts the timer for a named section.
 void PROF_start(const ProfilerSampleCategory category) {
+    if (unlikely(!is_main_thread())) {
+        // categories are per-frame totals of the main thread, elsewhere they become zones on the thread's lane
+        if (category < PROFILER_CATEGORY_COUNT) {
+            PROF_zoneBegin(PROF_category_names[category]);
+        }
+        return;
+    }
     if (category < PROFILER_CATEGORY_COUNT) {
-        measuring_samples[category].start_time = SDL_GetPerformanceCounter();
+        measuring_samples[category].start_time = prof_clock_now();
     }
 }
 
-//stops the timer and adds the duration in milliseconds.
+//stops the timer and adds the duration, converted to milliseconds at frame end.
 void PROF_stop(const ProfilerSampleCategory category) {
-    const Uint64 end_time = SDL_GetPerformanceCounter();
+    const Uint64 end_time = prof_clock_now();
+    if (unlikely(!is_main_thread())) {
+        if (category < PROFILER_CATEGORY_COUNT) {
+            PROF_zoneEnd();
+        }
+        return;
+    }
     if (category < PROFILER_CATEGORY_COUNT && measuring_samples[category].start_time > 0) {
-        const Uint64 duration_ticks = end_time - measuring_samples[category].start_time;
-        measuring_samples[category].duration_ms +=
-            (float)(duration_ticks * 1000) / (float)SDL_GetPerformanceFrequency(); //note: check 1000
-        measuring_samples[category].start_time = 0;                                //mark as stopped
+        measuring_ticks[category] += end_time - measuring_samples[category].start_time;
+        measuring_samples[category].start_time = 0; //mark as stopped
     }
 }
 
@@ -142,6 +835,7 @@ void PROF_setDuration(const ProfilerSampleCategory category, const float duratio
 
     measuring_samples[category].start_time = 0;
     measuring_samples[category].duration_ms = duration_ms > 0.0f ? duration_ms : 0.0f;
+    measuring_ticks[category] = 0;
 }
 
 inline float PROF_getLastFrameTime() {
@@ -151,6 +845,13 @@ inline float PROF_getLastFrameTime() {
     return prof_samples.total_times[prof_samples.newest]; //return the last frame time in milliseconds
 }
 
+float PROF_getLastCategoryTime(const ProfilerSampleCategory category) {
+    if (unlikely(prof_samples.count <= 0 || category >= PROFILER_CATEGORY_COUNT)) {
+        return 0.0f;
+    }
+    return prof_samples.samples[prof_samples.newest][category].duration_ms;
+}
+
 inline float PROF_getFrameTime() {
 
     if (measuring_samples[PROFILER_FRAME_TOTAL].start_time == 0) {
@@ -158,9 +859,8 @@ inline float PROF_getFrameTime() {
         return measuring_samples[PROFILER_FRAME_TOTAL].duration_ms; //return the last frame time in milliseconds
     }
 
-    const Uint64 current_time = SDL_GetPerformanceCounter();
-    const Uint64 elapsed_ticks = current_time - measuring_samples[PROFILER_FRAME_TOTAL].start_time;
-    return (float)(elapsed_ticks * 1000) / (float)SDL_GetPerformanceFrequency();
+    const Uint64 elapsed_ticks = prof_clock_now() - measuring_samples[PROFILER_FRAME_TOTAL].start_time;
+    return (float)((double)elapsed_ticks * prof_clock_ms_per_tick());
 }
 
 float PROF_getFrameWaitTime() {
@@ -176,6 +876,23 @@ void PROF_getFPS(float *const SDL_RESTRICT min, float *const SDL_RESTRICT avg, f
     *max = frames_per_second.max;
 }
 
+void PROF_shutdown(void) {
+    prof_trace_shutdown();
+
+    // threads that are still alive see the new generation and drop their cached buffer before touching it again
+    atomic_fetch_add_explicit(&prof_generation, 1u, memory_order_acq_rel);
+    const unsigned thread_count = atomic_exchange_explicit(&prof_thread_count, 0u, memory_order_acq_rel);
+    for (unsigned lane = 0; lane < thread_count && lane < PROF_MAX_THREADS; lane++) {
+        SDL_aligned_free(atomic_exchange_explicit(&prof_threads[lane], nullptr, memory_order_acq_rel));
+    }
+    lane_stat_count = 0;
+    zone_stat_count = 0;
+    zone_event_count = 0;
+    tls_thread_buffer = nullptr;
+    prof_main_thread = 0;
+    tls_is_main_thread = false;
+}
+
 /* ------------ RENDERING ------------ */
 static SDL_FColor hsv_to_fcolor(const float hue, const float saturation, const float value) {
     const float c = value * saturation;
@@ -226,31 +943,152 @@ static inline SDL_FColor fcolor_for_section(const ProfilerSampleCategory section
 static TTF_Font *prof_font = nullptr;
 static TTF_TextEngine *prof_text_engine = nullptr;
 static TTF_Text *title_text = nullptr;
+static TTF_Text *percentile_text = nullptr;
+static TTF_Text *memory_text = nullptr;
 static TTF_Text *prof_category_texts[PROFILER_CATEGORY_COUNT] = {nullptr};
 
+#define PROF_ZONE_LINES 24
+static TTF_Text *zone_title_text = nullptr;
+static TTF_Text *prof_zone_texts[PROF_ZONE_LINES] = {nullptr};
+static TTF_Text *prof_counter_texts[PROF_MAX_COUNTERS] = {nullptr};
+
 void PROF_initUI(TTF_TextEngine *engine, TTF_Font *font) {
     prof_text_engine = engine;
     prof_font = font;
 
     // Pre-create TTF_Text objects for each category
     title_text = TTF_CreateText(engine, font, "Debug Info", 0);
+    percentile_text = TTF_CreateText(engine, font, "", 0);
+    memory_text = TTF_CreateText(engine, font, "", 0);
     for (int i = 0; i < PROFILER_CATEGORY_COUNT; i++) {
         prof_category_texts[i] = TTF_CreateText(engine, font, "", 0);
     }
+
+    zone_title_text = TTF_CreateText(engine, font, "", 0);
+    for (int i = 0; i < PROF_ZONE_LINES; i++) {
+        prof_zone_texts[i] = TTF_CreateText(engine, font, "", 0);
+    }
+    for (int i = 0; i < PROF_MAX_COUNTERS; i++) {
+        prof_counter_texts[i] = TTF_CreateText(engine, font, "", 0);
+    }
 }
 
 void PROF_deinitUI(void) {
     TTF_DestroyText(title_text);
+    TTF_DestroyText(percentile_text);
+    percentile_text = nullptr;
+    TTF_DestroyText(memory_text);
+    memory_text = nullptr;
     for (int i = 0; i < PROFILER_CATEGORY_COUNT; i++) {
         if (prof_category_texts[i]) {
             TTF_DestroyText(prof_category_texts[i]);
             prof_category_texts[i] = nullptr;
         }
     }
+    TTF_DestroyText(zone_title_text);
+    zone_title_text = nullptr;
+    for (int i = 0; i < PROF_ZONE_LINES; i++) {
+        if (prof_zone_texts[i]) {
+            TTF_DestroyText(prof_zone_texts[i]);
+            prof_zone_texts[i] = nullptr;
+        }
+    }
+    for (int i = 0; i < PROF_MAX_COUNTERS; i++) {
+        if (prof_counter_texts[i]) {
+            TTF_DestroyText(prof_counter_texts[i]);
+            prof_counter_texts[i] = nullptr;
+        }
+    }
     prof_text_engine = nullptr;
     prof_font = nullptr;
 }
 
+// Thread lanes and zone trees of the last frame, one line per node, indented by depth.
+static void render_zone_tree(const float x, const float y) {
+    constexpr float line_height = 24.0f;
+    char text_buffer[96];
+    float current_y = y;
+
+    snprintf(text_buffer,
+             sizeof(text_buffer),
+             "zones: %d events, %d dropped",
+             zone_last_event_count,
+             zone_last_dropped);
+    TTF_SetTextString(zone_title_text, text_buffer, 0);
+    UI_TextWithBackground(zone_title_text, x, current_y);
+    current_y += line_height + 8.0f;
+
+    int line = 0;
+    for (int lane = 0; lane < lane_stat_count && line < PROF_ZONE_LINES; lane++, line++) {
+        snprintf(text_buffer,
+                 sizeof(text_buffer),
+                 "[%s] busy %6.2f ms (%3.0f%%)",
+                 lane_stats[lane].name,
+                 lane_stats[lane].busy_ms,
+                 lane_stats[lane].utilization * 100.0f);
+        TTF_SetTextString(prof_zone_texts[line], text_buffer, 0);
+        UI_TextWithBackground(prof_zone_texts[line], x, current_y);
+        current_y += line_height + 4.0f;
+    }
+    current_y += 8.0f;
+
+    for (int i = 0; i < zone_stat_count && line < PROF_ZONE_LINES; i++, line++) {
+        const ProfilerZoneStats *const stat = &zone_stats[i];
+        snprintf(text_buffer,
+                 sizeof(text_buffer),
+                 "%*s%s%s%s: %6.2f | self %6.2f ms x%d",
+                 stat->depth * 2,
+                 "",
+                 stat->depth == 0 && lane_stat_count > 1 ? lane_stats[stat->lane].name : "",
+                 stat->depth == 0 && lane_stat_count > 1 ? "/" : "",
+                 stat->name,
+                 stat->total_ms,
+                 stat->self_ms,
+                 stat->call_count);
+        TTF_SetTextString(prof_zone_texts[line], text_buffer, 0);
+        UI_TextWithBackground(prof_zone_texts[line], x, current_y);
+        current_y += line_height + 4.0f;
+    }
+}
+
+// One sparkline per counter (scaled to its own max over the history) with its current value next to it.
+static void render_counters(const float x, const float y) {
+    constexpr float graph_height = 20.0f;
+    constexpr float column_width = 4.0f;
+    constexpr float graph_width = column_width * PROF_COUNTER_HISTORY;
+    const SDL_FColor graph_color = {0.3f, 0.8f, 1.0f, 1.0f};
+    char text_buffer[96];
+    float current_y = y;
+
+    for (int i = 0; i < prof_counter_count; i++) {
+        const ProfilerCounter *const counter = &prof_counters[i];
+        ProfilerCounterStats stats;
+        counter_stats(counter, &stats);
+
+        UI_FillRect(x, current_y, graph_width, graph_height, UI_COLOR_BACKGROUND_DEFAULT);
+        if (stats.max > 0.0) {
+            for (int age = 0; age < counter_history_count; age++) {
+                int slot = counter_history_newest - age;
+                slot = slot < 0 ? slot + PROF_COUNTER_HISTORY : slot;
+                const float height = (float)(counter->history[slot] / stats.max) * graph_height;
+                const float column_x = x + graph_width - column_width * (float)(age + 1);
+                UI_FillRect(column_x, current_y + graph_height - height, column_width - 1.0f, height, graph_color);
+            }
+        }
+
+        snprintf(text_buffer,
+                 sizeof(text_buffer),
+                 "%s: %.0f (avg %.0f, max %.0f)",
+                 counter->name,
+                 stats.value,
+                 stats.avg,
+                 stats.max);
+        TTF_SetTextString(prof_counter_texts[i], text_buffer, 0);
+        UI_TextWithBackground(prof_counter_texts[i], x + graph_width + 8.0f, current_y - 4.0f);
+        current_y += graph_height + 8.0f;
+    }
+}
+
 void PROF_render(const SDL_FPoint position) {
     if (!prof_text_engine || !prof_font)
         return;
@@ -268,6 +1106,9 @@ void PROF_render(const SDL_FPoint position) {
     current_y += line_height + 16.0f;
 
     for (ProfilerSampleCategory category = 0; category < PROFILER_CATEGORY_COUNT; category++) {
+        ProfilerPercentiles percentiles;
+        PROF_getPercentiles(category, &percentiles);
+
         // Update text content
         if (category == PROFILER_FRAME_TOTAL) {
             snprintf(text_buffer,
@@ -279,9 +1120,10 @@ void PROF_render(const SDL_FPoint position) {
         } else {
             snprintf(text_buffer,
                      sizeof(text_buffer),
-                     "%s: %6.2f ms",
+                     "%s: %6.2f ms  p99 %6.2f",
                      PROF_category_names[category],
-                     prof_samples.samples[index][category].duration_ms);
+                     prof_samples.samples[index][category].duration_ms,
+                     percentiles.p99);
         }
         TTF_SetTextString(prof_category_texts[category], text_buffer, 0);
 
@@ -297,6 +1139,52 @@ void PROF_render(const SDL_FPoint position) {
         current_y += line_height + 8.0f;
     }
 
+    // --- Frame time percentiles over the long history ---
+    ProfilerPercentiles frame_percentiles;
+    PROF_getPercentiles(PROFILER_FRAME_TOTAL, &frame_percentiles);
+    char percentile_buffer[128];
+    snprintf(percentile_buffer,
+             sizeof(percentile_buffer),
+             "p50 %5.2f | p95 %5.2f | p99 %5.2f | p99.9 %5.2f | max %5.2f ms (%d frames)",
+             frame_percentiles.p50,
+             frame_percentiles.p95,
+             frame_percentiles.p99,
+             frame_percentiles.p999,
+             frame_percentiles.max,
+             frame_percentiles.sample_count);
+    TTF_SetTextString(percentile_text, percentile_buffer, 0);
+    UI_TextWithBackground(percentile_text, text_x, current_y - 4.0f);
+    current_y += line_height + 8.0f;
+
+    // --- Allocations, the frame should not make any once warmed up ---
+    if (MEM_isTrackerInstalled()) {
+        MemTagStats total;
+        MEM_getTotalStats(&total);
+        MemTag worst_tag = MEM_TAG_UNTAGGED;
+        Uint32 worst_count = 0;
+        for (MemTag tag = 0; tag < MEM_TAG_COUNT; tag++) {
+            MemTagStats stats;
+            MEM_getTagStats(tag, &stats);
+            if (stats.frame_alloc_count > worst_count) {
+                worst_count = stats.frame_alloc_count;
+                worst_tag = tag;
+            }
+        }
+        char memory_buffer[128];
+        snprintf(memory_buffer,
+                 sizeof(memory_buffer),
+                 "mem %.2f MB live (peak %.2f) | %u allocs %.1f KB/frame%s%s",
+                 (double)total.live_bytes / (1024.0 * 1024.0),
+                 (double)total.peak_bytes / (1024.0 * 1024.0),
+                 total.frame_alloc_count,
+                 (double)total.frame_alloc_bytes / 1024.0,
+                 worst_count > 0 ? ", most in " : "",
+                 worst_count > 0 ? MEM_tagName(worst_tag) : "");
+        TTF_SetTextString(memory_text, memory_buffer, 0);
+        UI_TextWithBackground(memory_text, text_x, current_y - 4.0f);
+        current_y += line_height + 8.0f;
+    }
+
     // --- Bar chart parameters ---
     const float bar_x = position.x;
     const float bar_y = current_y + 10.0f;
@@ -352,4 +1240,8 @@ void PROF_render(const SDL_FPoint position) {
             bar_y + bar_height + time_graph_height * 0.5f,
             goal_line_color,
             1.0f);
+
+    // --- Counters below the graphs, zone tree right of them ---
+    render_counters(bar_x, bar_y + bar_height + time_graph_height + 16.0f);
+    render_zone_tree(bar_x + bar_width * GRAPH_COUNT + 16.0f, bar_y);
 }
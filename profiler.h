@@ -29,6 +29,12 @@ typedef struct ProfilerSample {
 
 #define unlikely(x) __builtin_expect(!!(x), 0)
 #define likely(x) __builtin_expect(!!(x), 1)
+/**
+ * Makes the calling thread the main thread and registers its lane as "main". Call it once at startup, before other
+ * threads record anything: until then PROF_start()/PROF_stop() and counters are ignored on every thread.
+ */
+void PROF_init(void);
+
 /**
  * Must be called ONCE per frame loop, BEFORE any/all PROF_start() calls, ideally at the beginning of the frame loop, or right after the PROF_frameEnd() call.
  * It starts counting the total frame time for the frame sample.
@@ -45,6 +51,7 @@ void PROF_frameEnd();
 
 /**
  * Starts (or resumes) counting time for a specific ProfilerSampleCategory.
+ * Categories are main thread totals, on any other thread this opens a zone named after the category instead.
  * @param category profiler category to measure.
  * @enum ProfilerSampleCategory
  */
@@ -89,7 +96,8 @@ float PROF_getLastFrameTime();
 float PROF_getFrameWaitTime();
 
 /**
- * Gets the minimum, average and maximum FPS for the most recently finished frame sample.
+ * Gets the minimum, average and maximum FPS over the frames shown in the profiler graph (the last 60 finished frames).
+ * The average is frames / total time, not the mean of per-frame FPS values.
  * @param min pointer to store the minimum FPS.
  * @param avg pointer to store the average FPS.
  * @param max pointer to store the maximum FPS.
@@ -97,6 +105,188 @@ float PROF_getFrameWaitTime();
  */
 void PROF_getFPS(float *SDL_RESTRICT min, float *SDL_RESTRICT avg, float *SDL_RESTRICT max);
 
+const char *PROF_getCategoryName(ProfilerSampleCategory category);
+
+/**
+ * Returns the time in milliseconds a category took in the last finished frame, 0 if there is none yet.
+ */
+float PROF_getLastCategoryTime(ProfilerSampleCategory category);
+
+/* ------------ percentiles ------------ */
+#define PROF_HISTORY_FRAMES 4096 // frames kept for percentiles, ~68 s at 60 FPS
+
+typedef struct ProfilerPercentiles {
+    float p50;
+    float p95;
+    float p99; // 1000 / p99 of PROFILER_FRAME_TOTAL is the "1% low" FPS
+    float p999;
+    float max;
+    float mean;
+    int sample_count;
+} ProfilerPercentiles;
+
+/**
+ * Gets frame time percentiles (in milliseconds) of a category over the last PROF_HISTORY_FRAMES finished frames.
+ * Percentiles come from a log-linear histogram and are accurate to ~3%, max and mean are exact.
+ * @param category profiler category to query, PROFILER_FRAME_TOTAL for whole frames.
+ * @param out pointer to receive the percentiles.
+ * @return false if there are no finished frames yet.
+ */
+bool PROF_getPercentiles(ProfilerSampleCategory category, ProfilerPercentiles *out);
+
+/* ------------ zones ------------ */
+#define PROF_MAX_ZONE_EVENTS 8192 // per frame across all threads, extra zones are dropped (and counted)
+#define PROF_MAX_ZONE_DEPTH 32
+#define PROF_MAX_ZONE_STATS 128 // distinct (lane, name, parent) triples per frame
+#define PROF_MAX_THREADS 16     // threads that can record zones, each one gets a lane
+#define PROF_MAX_LANE_NAME 32
+
+/**
+ * Aggregated timing of one node of the zone call tree for a finished frame.
+ * Zones with the same name under the same parent are merged into one node.
+ */
+typedef struct ProfilerZoneStats {
+    const char *name;
+    int parent; // index into the same stats array, -1 for top-level zones
+    int lane;   // thread that recorded the zone, see PROF_getLaneStats()
+    int depth;
+    int call_count;
+    float total_ms;
+    float self_ms; // total_ms minus the time spent in child zones
+} ProfilerZoneStats;
+
+/**
+ * Per-thread summary of a finished frame.
+ */
+typedef struct ProfilerLaneStats {
+    const char *name;
+    float busy_ms;     // time covered by top-level zones
+    float utilization; // busy_ms / frame time
+    int zone_count;
+} ProfilerLaneStats;
+
+/**
+ * Opens a named zone nested inside the currently open one (if any) of the calling thread.
+ * Safe to call from any thread: each thread records into its own lock-free ring buffer, which the main thread drains
+ * in PROF_frameEnd(). Zones still open at that point are split at the frame boundary.
+ * @param name static string, zones are merged by pointer so it must outlive the frame.
+ * @note Prefer the PROF_ZONE* macros, which compile to nothing without MISO_PROFILER_ZONES.
+ */
+void PROF_zoneBegin(const char *name);
+
+/**
+ * Closes the most recently opened zone of the calling thread.
+ */
+void PROF_zoneEnd(void);
+
+/**
+ * Names the calling thread's lane. Call it before the thread records its first zone, a lane cannot be renamed once
+ * registered. The thread that calls PROF_init() is named "main".
+ */
+void PROF_setThreadName(const char *name);
+
+/**
+ * Gets the zone call tree of the most recently finished frame, parents always come before their children.
+ * @param out_stats pointer to receive the stats array, valid until the next PROF_frameEnd().
+ * @return number of entries in the array.
+ */
+int PROF_getZoneStats(const ProfilerZoneStats **out_stats);
+
+/**
+ * Gets the per-thread lanes of the most recently finished frame, indexed by ProfilerZoneStats::lane.
+ * @param out_stats pointer to receive the stats array, valid until the next PROF_frameEnd().
+ * @return number of lanes.
+ */
+int PROF_getLaneStats(const ProfilerLaneStats **out_stats);
+
+static inline void PROF_zoneScopeEnd(const char *const scope) {
+    (void)scope;
+    PROF_zoneEnd();
+}
+
+#define PROF_CONCAT_(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+
+#ifdef MISO_PROFILER_ZONES
+#define PROF_ZONE_BEGIN(name) PROF_zoneBegin(name)
+#define PROF_ZONE_END() PROF_zoneEnd()
+// Zone that closes automatically when the enclosing scope ends.
+#define PROF_ZONE(name)                                                                                                \
+    __attribute__((cleanup(PROF_zoneScopeEnd))) const char PROF_CONCAT(prof_zone_, __LINE__) = (PROF_zoneBegin(name), 0)
+#else
+#define PROF_ZONE_BEGIN(name) ((void)0)
+#define PROF_ZONE_END() ((void)0)
+#define PROF_ZONE(name) ((void)0)
+#endif
+
+/* ------------ counters ------------ */
+#define PROF_MAX_COUNTERS 32
+#define PROF_COUNTER_HISTORY 60 // frames kept for the overlay graphs
+
+// Throughput next to the timings: how much work a frame did, so "slower" can be told apart from "doing more".
+typedef struct ProfilerCounterStats {
+    const char *name;
+    double value; // last finished frame
+    double min;   // over the history
+    double avg;
+    double max;
+} ProfilerCounterStats;
+
+/**
+ * Sets this frame's value of a counter. Counters restart from 0 every frame.
+ * @param name identifies the counter, must stay valid for the whole run (a string literal).
+ * @note Main thread only, calls from other threads are ignored. Counters past PROF_MAX_COUNTERS are ignored.
+ */
+void PROF_counter(const char *name, double value);
+
+/**
+ * Adds to this frame's value of a counter, see PROF_counter().
+ */
+void PROF_counterAdd(const char *name, double delta);
+
+/**
+ * Gets the counters as of the most recently finished frame.
+ * @param out_stats array receiving up to max_stats entries.
+ * @return number of entries written.
+ */
+int PROF_getCounterStats(ProfilerCounterStats *out_stats, int max_stats);
+
+/* ------------ trace export ------------ */
+/**
+ * Starts recording the next frame_count frames (zones of every thread, category times and RendererFrameStats).
+ * When they are done, or on PROF_captureStop(), they are written to path as chrome://tracing / Perfetto JSON.
+ * @return false if the capture buffers could not be allocated.
+ * @note Starting a capture while one is running writes the running one first.
+ */
+bool PROF_captureStart(int frame_count, const char *path);
+
+/**
+ * Ends the running capture early and writes the frames recorded so far.
+ */
+void PROF_captureStop(void);
+
+bool PROF_isCapturing(void);
+
+/**
+ * Keeps the last few frames of zones and stats in a rolling window. When a frame takes longer than threshold_ms the
+ * window is frozen a few frames later and written to "<path_prefix>_<frame index>.json", so the frames leading up to
+ * and following a hitch can be inspected after the fact.
+ * @param threshold_ms frame time that counts as a spike, <= 0 uses twice the frame goal.
+ * @param path_prefix NULL uses "miso_spike".
+ * @note Disabled by default. The window costs about 1 MB while enabled; dumps are written on the main thread and
+ * further spikes are ignored until the window has refilled.
+ */
+void PROF_setSpikeCapture(bool enabled, float threshold_ms, const char *path_prefix);
+
+// Number of spike traces written so far.
+Uint32 PROF_getSpikeDumpCount(void);
+
+/**
+ * Writes any pending capture and frees the per-thread zone buffers. Call once at exit, while no other thread is
+ * inside a zone. Threads that outlive it drop their freed buffer and register a new one if they record again.
+ */
+void PROF_shutdown(void);
+
 /* ------------ rendering the profiler ------------ */
 /**
  * Initialize the GPU profiler rendering resources.
@@ -0,0 +1,32 @@
+#ifndef PROFILER_CLOCK_H
+#define PROFILER_CLOCK_H
+
+#include "SDL3/SDL_stdinc.h"
+#include "SDL3/SDL_timer.h"
+
+// Timestamps of the profiler (PROF_start/stop, zones, frame bounds) in raw counter ticks.
+// Reading the counter is a single instruction on x86-64 (TSC) and arm64 (generic timer virtual count), anything else
+// falls back to SDL_GetPerformanceCounter(). Ticks are only converted to time at frame end, with the factor from
+// prof_clock_ms_per_tick() (profiler_internal.h).
+// Only include this header from the profiler.
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PROF_CLOCK_TSC 1
+#elif defined(__aarch64__)
+#define PROF_CLOCK_CNTVCT 1
+#endif
+
+static inline Uint64 prof_clock_now(void) {
+#if defined(PROF_CLOCK_TSC)
+    // rdtsc, not rdtscp: zones only need ordering against themselves and the fence would cost more than the read
+    return __builtin_ia32_rdtsc();
+#elif defined(PROF_CLOCK_CNTVCT)
+    Uint64 ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return SDL_GetPerformanceCounter();
+#endif
+}
+
+#endif //PROFILER_CLOCK_H
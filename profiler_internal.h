@@ -0,0 +1,51 @@
+#ifndef PROFILER_INTERNAL_H
+#define PROFILER_INTERNAL_H
+
+#include "memtrack.h"
+#include "profiler.h"
+#include "renderer/renderer.h"
+
+// Shared between the profiler translation units (profiler.c, profiler_trace.c)
+// Do not include this header outside the profiler
+
+typedef struct ProfilerZoneEvent {
+    const char *name;
+    Uint64 start;
+    Uint64 end;
+    int parent; // event index, -1 for top-level zones
+    int lane;
+} ProfilerZoneEvent;
+
+typedef struct ProfilerCounterValue {
+    const char *name;
+    double value;
+} ProfilerCounterValue;
+
+// One finished frame: its zone timeline plus the per-frame summaries recorded next to it.
+typedef struct ProfilerTraceFrame {
+    Uint64 index;
+    Uint64 start;
+    Uint64 end;
+    const ProfilerZoneEvent *events;
+    int event_count;
+    int dropped_event_count; // zones recorded this frame that are missing from events
+    float category_ms[PROFILER_CATEGORY_COUNT];
+    RendererFrameStats render;
+    ProfilerCounterValue counters[PROF_MAX_COUNTERS];
+    int counter_count;
+    MemTagStats mem[MEM_TAG_COUNT]; // all zero without the allocation tracker
+} ProfilerTraceFrame;
+
+float prof_goal_frame_ms(void);
+// Conversion factor of the profiler's raw timestamps (see profiler_clock.h), calibrated at startup.
+double prof_clock_ms_per_tick(void);
+
+// Called by PROF_frameEnd() with the frame that just finished. The frame's data is only valid during the call.
+void prof_trace_frame_end(const ProfilerTraceFrame *frame);
+
+// Writes frames (oldest first) as a chrome://tracing / Perfetto compatible JSON file.
+bool prof_trace_write(const char *path, const ProfilerTraceFrame *frames, int frame_count);
+
+void prof_trace_shutdown(void);
+
+#endif //PROFILER_INTERNAL_H
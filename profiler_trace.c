@@ -0,0 +1,455 @@
+#include "profiler_internal.h"
+
+#include <SDL3/SDL.h>
+
+#define TRACE_PID 1
+#define TRACE_FRAME_TID 1000 // lane holding one slice per frame, below the thread lanes
+
+/* ------------ JSON writer ------------ */
+typedef struct TraceWriter {
+    SDL_IOStream *io;
+    bool first;
+    double us_per_tick;
+    Uint64 base;
+    bool dropped_track; // a dropped_zones sample is open and has to be brought back to zero
+} TraceWriter;
+
+static void trace_begin_event(TraceWriter *const writer) {
+    SDL_IOprintf(writer->io, writer->first ? "\n" : ",\n");
+    writer->first = false;
+}
+
+static void trace_write_string(SDL_IOStream *const io, const char *const string) {
+    SDL_IOprintf(io, "\"");
+    for (const char *c = string; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            SDL_IOprintf(io, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            SDL_IOprintf(io, "\\u%04x", (unsigned int)(unsigned char)*c);
+        } else {
+            SDL_WriteIO(io, c, 1);
+        }
+    }
+    SDL_IOprintf(io, "\"");
+}
+
+static double trace_time_us(const TraceWriter *const writer, const Uint64 ticks) {
+    return (double)(Sint64)(ticks - writer->base) * writer->us_per_tick;
+}
+
+static void trace_write_thread_name(TraceWriter *const writer, const int tid, const char *const name) {
+    trace_begin_event(writer);
+    SDL_IOprintf(writer->io,
+                 "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                 TRACE_PID,
+                 tid);
+    trace_write_string(writer->io, name);
+    SDL_IOprintf(writer->io, "}}");
+
+    trace_begin_event(writer);
+    SDL_IOprintf(writer->io,
+                 "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"sort_index\":%d}}",
+                 TRACE_PID,
+                 tid,
+                 tid);
+}
+
+static void trace_write_slice(TraceWriter *const writer,
+                              const char *const name,
+                              const char *const category,
+                              const int tid,
+                              const Uint64 start,
+                              const Uint64 end) {
+    trace_begin_event(writer);
+    SDL_IOprintf(writer->io, "{\"name\":");
+    trace_write_string(writer->io, name);
+    SDL_IOprintf(writer->io,
+                 ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                 category,
+                 trace_time_us(writer, start),
+                 (double)(end - start) * writer->us_per_tick,
+                 TRACE_PID,
+                 tid);
+}
+
+static void trace_begin_counter(TraceWriter *const writer, const char *const name, const Uint64 time) {
+    trace_begin_event(writer);
+    SDL_IOprintf(writer->io,
+                 "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{",
+                 name,
+                 trace_time_us(writer, time),
+                 TRACE_PID);
+}
+
+static void trace_write_frame(TraceWriter *const writer, const ProfilerTraceFrame *const frame) {
+    char frame_name[32];
+    SDL_snprintf(frame_name, sizeof(frame_name), "frame %" SDL_PRIu64, frame->index);
+    trace_write_slice(writer, frame_name, "frame", TRACE_FRAME_TID, frame->start, frame->end);
+
+    for (int i = 0; i < frame->event_count; i++) {
+        const ProfilerZoneEvent *const event = &frame->events[i];
+        trace_write_slice(writer, event->name, "zone", event->lane, event->start, event->end);
+    }
+
+    // only frames that lost zones (and the one after, to end the step) get a sample, clean captures stay uncluttered
+    if (frame->dropped_event_count > 0 || writer->dropped_track) {
+        trace_begin_counter(writer, "dropped_zones", frame->start);
+        SDL_IOprintf(writer->io, "\"zones\":%d}}", frame->dropped_event_count);
+        writer->dropped_track = frame->dropped_event_count > 0;
+    }
+
+    trace_begin_counter(writer, "categories_ms", frame->start);
+    for (ProfilerSampleCategory category = 0; category < PROFILER_CATEGORY_COUNT; category++) {
+        SDL_IOprintf(writer->io,
+                     "%s\"%s\":%.3f",
+                     category == 0 ? "" : ",",
+                     PROF_getCategoryName(category),
+                     (double)frame->category_ms[category]);
+    }
+    SDL_IOprintf(writer->io, "}}");
+
+    trace_begin_counter(writer, "draw_calls", frame->start);
+    for (RendererStatsQueueKind queue = 0; queue < RENDERER_STATS_QUEUE_COUNT; queue++) {
+        SDL_IOprintf(writer->io,
+                     "%s\"%s\":%u",
+                     queue == 0 ? "" : ",",
+                     Renderer_GetStatsQueueName(queue),
+                     frame->render.queues[queue].draw_calls);
+    }
+    SDL_IOprintf(writer->io, "}}");
+
+    trace_begin_counter(writer, "queued_cmds", frame->start);
+    for (RendererStatsQueueKind queue = 0; queue < RENDERER_STATS_QUEUE_COUNT; queue++) {
+        SDL_IOprintf(writer->io,
+                     "%s\"%s\":%u",
+                     queue == 0 ? "" : ",",
+                     Renderer_GetStatsQueueName(queue),
+                     frame->render.queues[queue].cmd_count);
+    }
+    SDL_IOprintf(writer->io, "}}");
+
+    trace_begin_counter(writer, "stream_used_bytes", frame->start);
+    for (RendererStatsStreamKind stream = 0; stream < RENDERER_STATS_STREAM_COUNT; stream++) {
+        SDL_IOprintf(writer->io,
+                     "%s\"%s\":%u",
+                     stream == 0 ? "" : ",",
+                     Renderer_GetStatsStreamName(stream),
+                     frame->render.streams[stream].used_bytes);
+    }
+    SDL_IOprintf(writer->io, "}}");
+
+    trace_begin_counter(writer, "gpu_timing_ms", frame->start);
+    SDL_IOprintf(writer->io,
+                 "\"swapchain_acquire\":%.3f,\"submit\":%.3f}}",
+                 (double)frame->render.timing.swapchain_acquire_ms,
+                 (double)frame->render.timing.submit_ms);
+
+    // user counters get a track each, their scales have nothing in common
+    for (int i = 0; i < frame->counter_count; i++) {
+        trace_begin_event(writer);
+        SDL_IOprintf(writer->io, "{\"name\":");
+        trace_write_string(writer->io, frame->counters[i].name);
+        SDL_IOprintf(writer->io,
+                     ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"value\":%.17g}}",
+                     trace_time_us(writer, frame->start),
+                     TRACE_PID,
+                     frame->counters[i].value);
+    }
+
+    if (MEM_isTrackerInstalled()) {
+        trace_begin_counter(writer, "frame_allocs", frame->start);
+        for (MemTag tag = 0; tag < MEM_TAG_COUNT; tag++) {
+            SDL_IOprintf(writer->io,
+                         "%s\"%s\":%u",
+                         tag == 0 ? "" : ",",
+                         MEM_tagName(tag),
+                         frame->mem[tag].frame_alloc_count);
+        }
+        SDL_IOprintf(writer->io, "}}");
+
+        trace_begin_counter(writer, "live_bytes", frame->start);
+        for (MemTag tag = 0; tag < MEM_TAG_COUNT; tag++) {
+            SDL_IOprintf(writer->io,
+                         "%s\"%s\":%" SDL_PRIu64,
+                         tag == 0 ? "" : ",",
+                         MEM_tagName(tag),
+                         frame->mem[tag].live_bytes);
+        }
+        SDL_IOprintf(writer->io, "}}");
+    }
+}
+
+bool prof_trace_write(const char *const path, const ProfilerTraceFrame *const frames, const int frame_count) {
+    if (!path || !frames || frame_count <= 0) {
+        return false;
+    }
+
+    SDL_IOStream *const io = SDL_IOFromFile(path, "w");
+    if (!io) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Profiler: failed to open trace file %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    TraceWriter writer = {
+        .io = io,
+        .first = true,
+        .us_per_tick = prof_clock_ms_per_tick() * 1000.0,
+        .base = frames[0].start,
+    };
+
+    SDL_IOprintf(io, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    trace_begin_event(&writer);
+    SDL_IOprintf(io, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"miso\"}}", TRACE_PID);
+
+    const ProfilerLaneStats *lanes = nullptr;
+    const int lane_count = PROF_getLaneStats(&lanes);
+    for (int lane = 0; lane < lane_count; lane++) {
+        trace_write_thread_name(&writer, lane, lanes[lane].name);
+    }
+    trace_write_thread_name(&writer, TRACE_FRAME_TID, "frames");
+
+    for (int i = 0; i < frame_count; i++) {
+        trace_write_frame(&writer, &frames[i]);
+    }
+
+    SDL_IOprintf(io, "\n]}\n");
+    if (!SDL_CloseIO(io)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Profiler: failed to write trace file %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Profiler: wrote %d frames to %s", frame_count, path);
+    return true;
+}
+
+/* ------------ capture ------------ */
+#define CAPTURE_PATH_MAX 512
+#define CAPTURE_EVENTS_PER_FRAME 512 // initial estimate, grows on demand
+
+typedef struct ProfilerCapture {
+    bool active;
+    char path[CAPTURE_PATH_MAX];
+    int frame_target;
+    int frame_count;
+    ProfilerTraceFrame *frames;
+    int *first_event; // per frame offset into events, events can move while growing
+    ProfilerZoneEvent *events;
+    int event_count;
+    int event_capacity;
+} ProfilerCapture;
+
+static ProfilerCapture capture = {0};
+
+static void capture_free(void) {
+    SDL_free(capture.frames);
+    SDL_free(capture.first_event);
+    SDL_free(capture.events);
+    capture = (ProfilerCapture){0};
+}
+
+static bool capture_reserve_events(const int count) {
+    if (capture.event_count + count <= capture.event_capacity) {
+        return true;
+    }
+    MEM_TAG(MEM_TAG_PROFILER);
+
+    int new_capacity = capture.event_capacity > 0 ? capture.event_capacity : CAPTURE_EVENTS_PER_FRAME;
+    while (new_capacity < capture.event_count + count) {
+        new_capacity *= 2;
+    }
+
+    ProfilerZoneEvent *const new_events = SDL_realloc(capture.events, sizeof(ProfilerZoneEvent) * (size_t)new_capacity);
+    if (!new_events) {
+        return false;
+    }
+    capture.events = new_events;
+    capture.event_capacity = new_capacity;
+    return true;
+}
+
+bool PROF_captureStart(const int frame_count, const char *const path) {
+    if (frame_count <= 0 || !path) {
+        return false;
+    }
+
+    if (capture.active) {
+        PROF_captureStop();
+    }
+
+    MEM_TAG(MEM_TAG_PROFILER);
+    capture.frames = SDL_calloc((size_t)frame_count, sizeof(ProfilerTraceFrame));
+    capture.first_event = SDL_calloc((size_t)frame_count, sizeof(int));
+    if (!capture.frames || !capture.first_event ||
+        !capture_reserve_events(CAPTURE_EVENTS_PER_FRAME * (frame_count < 64 ? frame_count : 64))) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Profiler: out of memory starting a %d frame capture", frame_count);
+        capture_free();
+        return false;
+    }
+
+    SDL_strlcpy(capture.path, path, sizeof(capture.path));
+    capture.frame_target = frame_count;
+    capture.active = true;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Profiler: capturing %d frames to %s", frame_count, path);
+    return true;
+}
+
+void PROF_captureStop(void) {
+    if (!capture.active) {
+        return;
+    }
+    capture.active = false;
+
+    for (int i = 0; i < capture.frame_count; i++) {
+        capture.frames[i].events = capture.events + capture.first_event[i];
+    }
+    prof_trace_write(capture.path, capture.frames, capture.frame_count);
+    capture_free();
+}
+
+bool PROF_isCapturing(void) {
+    return capture.active;
+}
+
+/* ------------ spike capture ------------ */
+#define SPIKE_WINDOW_FRAMES 32
+#define SPIKE_POST_FRAMES 8 // frames kept after the spike, the rest of the window is history before it
+#define SPIKE_EVENTS_PER_FRAME 1024 // zones past this are dropped from the frame's slot and counted in the dump
+#define SPIKE_COOLDOWN_FRAMES SPIKE_WINDOW_FRAMES // writing a dump hitches too, don't trigger on it
+
+typedef struct ProfilerSpikeCapture {
+    bool enabled;
+    float threshold_ms; // <= 0 uses 2x the frame goal
+    char path_prefix[CAPTURE_PATH_MAX];
+    ProfilerTraceFrame frames[SPIKE_WINDOW_FRAMES]; // rolling window, slot = frame index % SPIKE_WINDOW_FRAMES
+    ProfilerZoneEvent (*events)[SPIKE_EVENTS_PER_FRAME]; // one fixed block per slot, allocated on enable
+    int frame_count; // filled slots, up to SPIKE_WINDOW_FRAMES
+    int next_slot;
+    Uint64 spike_index; // frame that triggered the pending dump
+    int post_frames_left; // > 0 while finishing a dump
+    int cooldown;
+    Uint32 dump_count;
+} ProfilerSpikeCapture;
+
+static ProfilerSpikeCapture spike = {0};
+static ProfilerTraceFrame spike_ordered[SPIKE_WINDOW_FRAMES];
+
+void PROF_setSpikeCapture(const bool enabled, const float threshold_ms, const char *const path_prefix) {
+    if (enabled && !spike.events) {
+        MEM_pushTag(MEM_TAG_PROFILER);
+        spike.events = SDL_malloc(sizeof(*spike.events) * SPIKE_WINDOW_FRAMES);
+        MEM_popTag();
+        if (!spike.events) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Profiler: out of memory enabling spike capture");
+            return;
+        }
+    } else if (!enabled) {
+        SDL_free(spike.events);
+        spike.events = nullptr;
+    }
+
+    spike.enabled = enabled;
+    spike.threshold_ms = threshold_ms;
+    SDL_strlcpy(spike.path_prefix, path_prefix ? path_prefix : "miso_spike", sizeof(spike.path_prefix));
+    spike.frame_count = 0;
+    spike.next_slot = 0;
+    spike.post_frames_left = 0;
+    spike.cooldown = 0;
+}
+
+static void spike_dump(void) {
+    const int first_slot = spike.frame_count < SPIKE_WINDOW_FRAMES ? 0 : spike.next_slot;
+    int dropped = 0;
+    for (int i = 0; i < spike.frame_count; i++) {
+        spike_ordered[i] = spike.frames[(first_slot + i) % SPIKE_WINDOW_FRAMES];
+        dropped += spike_ordered[i].dropped_event_count;
+    }
+
+    char path[CAPTURE_PATH_MAX + 32];
+    SDL_snprintf(path, sizeof(path), "%s_%" SDL_PRIu64 ".json", spike.path_prefix, spike.spike_index);
+    if (prof_trace_write(path, spike_ordered, spike.frame_count)) {
+        spike.dump_count++;
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+                    "Profiler: frame %" SDL_PRIu64 " spiked, wrote %d frames to %s (%d zones dropped)",
+                    spike.spike_index,
+                    spike.frame_count,
+                    path,
+                    dropped);
+    }
+    spike.cooldown = SPIKE_COOLDOWN_FRAMES;
+}
+
+static void spike_frame_end(const ProfilerTraceFrame *const frame) {
+    if (!spike.enabled) {
+        return;
+    }
+
+    const int slot = spike.next_slot;
+    const int event_count = frame->event_count < SPIKE_EVENTS_PER_FRAME ? frame->event_count : SPIKE_EVENTS_PER_FRAME;
+    spike.frames[slot] = *frame;
+    spike.frames[slot].events = spike.events[slot];
+    spike.frames[slot].event_count = event_count;
+    spike.frames[slot].dropped_event_count += frame->event_count - event_count;
+    SDL_memcpy(spike.events[slot], frame->events, sizeof(ProfilerZoneEvent) * (size_t)event_count);
+    spike.next_slot = (slot + 1) % SPIKE_WINDOW_FRAMES;
+    if (spike.frame_count < SPIKE_WINDOW_FRAMES) {
+        spike.frame_count++;
+    }
+
+    if (spike.post_frames_left > 0) {
+        if (--spike.post_frames_left == 0) {
+            spike_dump();
+        }
+        return;
+    }
+    if (spike.cooldown > 0) {
+        spike.cooldown--;
+        return;
+    }
+
+    const float threshold_ms = spike.threshold_ms > 0.0f ? spike.threshold_ms : 2.0f * prof_goal_frame_ms();
+    const float frame_ms = (float)((double)(frame->end - frame->start) * prof_clock_ms_per_tick());
+    if (frame_ms > threshold_ms) {
+        spike.spike_index = frame->index;
+        spike.post_frames_left = SPIKE_POST_FRAMES;
+    }
+}
+
+Uint32 PROF_getSpikeDumpCount(void) {
+    return spike.dump_count;
+}
+
+void prof_trace_frame_end(const ProfilerTraceFrame *const frame) {
+    spike_frame_end(frame);
+
+    if (!capture.active) {
+        return;
+    }
+
+    ProfilerTraceFrame *const stored = &capture.frames[capture.frame_count];
+    *stored = *frame;
+    stored->events = nullptr;
+    capture.first_event[capture.frame_count] = capture.event_count;
+
+    if (capture_reserve_events(frame->event_count)) {
+        SDL_memcpy(capture.events + capture.event_count,
+                   frame->events,
+                   sizeof(ProfilerZoneEvent) * (size_t)frame->event_count);
+        capture.event_count += frame->event_count;
+    } else {
+        stored->event_count = 0; // keep the frame summary, lose its zones
+    }
+
+    capture.frame_count++;
+    if (capture.frame_count >= capture.frame_target) {
+        PROF_captureStop();
+    }
+}
+
+void prof_trace_shutdown(void) {
+    PROF_captureStop();
+    if (spike.post_frames_left > 0) {
+        spike_dump(); // spike right before exit, write what we have
+    }
+    PROF_setSpikeCapture(false, 0.0f, nullptr);
+}
@@ -0,0 +1,153 @@
+#include "../cooked_texture.h"
+
+#include "../memtrack.h"
+#include "renderer_internal.h"
+
+#include <SDL3/SDL_log.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define COOKED_TEXTURE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define COOKED_TEXTURE_MAPPING_PROPERTY "miso.cooked_texture.mapping"
+#define COOKED_TEXTURE_TILE_WIDTH_PROPERTY "miso.cooked_texture.tile_width"
+#define COOKED_TEXTURE_TILE_HEIGHT_PROPERTY "miso.cooked_texture.tile_height"
+
+// The blob's bytes, alive as long as the surface made over them
+typedef struct {
+    void *data;
+    size_t size;
+    bool mapped; // false: read into memory where mmap is unavailable
+} CookedMapping;
+
+static void SDLCALL cooked_texture_unmap(void *const userdata, void *const value) {
+    (void)userdata;
+    CookedMapping *const mapping = value;
+#ifdef COOKED_TEXTURE_MMAP
+    if (mapping->mapped) {
+        munmap(mapping->data, mapping->size);
+        SDL_free(mapping);
+        return;
+    }
+#endif
+    SDL_free(mapping->data);
+    SDL_free(mapping);
+}
+
+static bool cooked_texture_map(const char *const path, CookedMapping *const mapping) {
+#ifdef COOKED_TEXTURE_MMAP
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void *const data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    *mapping = (CookedMapping){.data = data, .size = (size_t)info.st_size, .mapped = true};
+    return true;
+#else
+    size_t size = 0;
+    void *const data = SDL_LoadFile(path, &size);
+    if (!data) {
+        return false;
+    }
+    *mapping = (CookedMapping){.data = data, .size = size, .mapped = false};
+    return true;
+#endif
+}
+
+static bool cooked_texture_validate(const CookedMapping *const mapping, const char *const path) {
+    if (mapping->size < sizeof(CookedTextureHeader)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: truncated cooked texture", path);
+        return false;
+    }
+    const CookedTextureHeader *const header = mapping->data;
+    if (header->magic != COOKED_TEXTURE_MAGIC || header->version != COOKED_TEXTURE_VERSION) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "%s: not a version %u cooked texture, re-run cook_assets",
+                     path,
+                     COOKED_TEXTURE_VERSION);
+        return false;
+    }
+    if (header->format != COOKED_TEXTURE_FORMAT_RGBA8 || header->width == 0 || header->height == 0 ||
+        header->width > (uint32_t)SDL_MAX_SINT32 / 4u || header->height > (uint32_t)SDL_MAX_SINT32 ||
+        header->pitch > (uint32_t)SDL_MAX_SINT32 || header->pitch < header->width * 4u ||
+        header->data_size < (uint64_t)header->pitch * header->height ||
+        header->data_offset > mapping->size || header->data_size > mapping->size - header->data_offset) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: corrupt cooked texture header", path);
+        return false;
+    }
+    return true;
+}
+
+SDL_Surface *Renderer_MapCookedTexture(const char *const path) {
+    MEM_TAG(MEM_TAG_RENDERER);
+    CookedMapping *const mapping = SDL_malloc(sizeof(CookedMapping));
+    if (!mapping) {
+        return nullptr;
+    }
+    if (!cooked_texture_map(path, mapping)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to map %s", path);
+        SDL_free(mapping);
+        return nullptr;
+    }
+    if (!cooked_texture_validate(mapping, path)) {
+        cooked_texture_unmap(nullptr, mapping);
+        return nullptr;
+    }
+
+    // The surface points into the mapping, its pixels are only read once, by the upload
+    const CookedTextureHeader *const header = mapping->data;
+    SDL_Surface *const surface = SDL_CreateSurfaceFrom((int)header->width,
+                                                       (int)header->height,
+                                                       SDL_PIXELFORMAT_RGBA32,
+                                                       (Uint8 *)mapping->data + header->data_offset,
+                                                       (int)header->pitch);
+    if (!surface) {
+        cooked_texture_unmap(nullptr, mapping);
+        return nullptr;
+    }
+    // unmapped when the surface is destroyed (SDL also runs the cleanup if setting the property fails)
+    const SDL_PropertiesID properties = SDL_GetSurfaceProperties(surface);
+    if (!SDL_SetPointerPropertyWithCleanup(
+            properties, COOKED_TEXTURE_MAPPING_PROPERTY, mapping, cooked_texture_unmap, nullptr)) {
+        SDL_DestroySurface(surface);
+        return nullptr;
+    }
+    if (header->tile_width > 0 && header->tile_height > 0) {
+        SDL_SetNumberProperty(properties, COOKED_TEXTURE_TILE_WIDTH_PROPERTY, header->tile_width);
+        SDL_SetNumberProperty(properties, COOKED_TEXTURE_TILE_HEIGHT_PROPERTY, header->tile_height);
+    }
+    return surface;
+}
+
+bool Renderer_CookedTextureFitsGrid(SDL_Surface *const image, const int cell_w, const int cell_h) {
+    if (!image || cell_w <= 0 || cell_h <= 0) {
+        return true;
+    }
+    const SDL_PropertiesID properties = SDL_GetSurfaceProperties(image);
+    const Sint64 tile_w = SDL_GetNumberProperty(properties, COOKED_TEXTURE_TILE_WIDTH_PROPERTY, 0);
+    const Sint64 tile_h = SDL_GetNumberProperty(properties, COOKED_TEXTURE_TILE_HEIGHT_PROPERTY, 0);
+    if (tile_w == 0 || (tile_w == cell_w && tile_h == cell_h)) {
+        return true;
+    }
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                 "Cooked texture has %" SDL_PRIs64 "x%" SDL_PRIs64
+                 " tiles but is loaded with %dx%d, re-run cook_assets",
+                 tile_w,
+                 tile_h,
+                 cell_w,
+                 cell_h);
+    return false;
+}
@@ -0,0 +1,149 @@
+#include "../memtrack.h"
+#include "renderer.h"
+#include "renderer_internal.h"
+
+#include <SDL3/SDL_log.h>
+
+// Levels the cell grid can be halved into: each level halves the cells, so a cell has to stay a whole number of
+// texels and every 2x2 block a level is filtered from lies inside one cell
+static int renderer_mip_level_count(const int width, const int height, const int cell_w, const int cell_h) {
+    if (cell_w <= 0 || cell_h <= 0 || width % cell_w != 0 || height % cell_h != 0) {
+        return 1;
+    }
+    int count = 1;
+    while (count < RENDERER_MAX_MIP_LEVELS && ((cell_w >> (count - 1)) & 1) == 0 &&
+           ((cell_h >> (count - 1)) & 1) == 0) {
+        count++;
+    }
+    return count;
+}
+
+// 2x2 box filter weighted by alpha, so the transparent texels around a sprite do not darken its edges
+static SDL_Surface *renderer_mip_downsample(const SDL_Surface *const source) {
+    SDL_Surface *const target = SDL_CreateSurface(source->w / 2, source->h / 2, SDL_PIXELFORMAT_ABGR8888);
+    if (!target) {
+        return nullptr;
+    }
+    for (int y = 0; y < target->h; y++) {
+        const Uint8 *const row0 = (const Uint8 *)source->pixels + (size_t)source->pitch * (size_t)(y * 2);
+        const Uint8 *const row1 = row0 + source->pitch;
+        Uint8 *const out_row = (Uint8 *)target->pixels + (size_t)target->pitch * (size_t)y;
+        for (int x = 0; x < target->w; x++) {
+            const Uint8 *const texels[4] = {row0 + x * 8, row0 + x * 8 + 4, row1 + x * 8, row1 + x * 8 + 4};
+            Uint8 *const out = out_row + x * 4;
+            const Uint32 alpha = (Uint32)texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3];
+            for (int c = 0; c < 3; c++) {
+                Uint32 sum = 0;
+                for (int t = 0; t < 4; t++) {
+                    sum += (Uint32)texels[t][c] * texels[t][3];
+                }
+                out[c] = alpha ? (Uint8)((sum + alpha / 2U) / alpha) : 0;
+            }
+            out[3] = (Uint8)((alpha + 2U) / 4U);
+        }
+    }
+    return target;
+}
+
+bool Renderer_BuildMipChain(SDL_Surface *const image,
+                            const int cell_w,
+                            const int cell_h,
+                            RendererMipChain *const chain) {
+    MEM_TAG(MEM_TAG_RENDERER);
+    *chain = (RendererMipChain){0};
+    if (!image) {
+        return false;
+    }
+    // the cells are a tileset's tiles, a cooked tileset must have been cooked for the same ones
+    if (!Renderer_CookedTextureFitsGrid(image, cell_w, cell_h)) {
+        SDL_DestroySurface(image);
+        return false;
+    }
+    chain->levels[0] = image;
+    chain->count = 1;
+
+    const int count = renderer_mip_level_count(image->w, image->h, cell_w, cell_h);
+    while (chain->count < count) {
+        SDL_Surface *const level = renderer_mip_downsample(chain->levels[chain->count - 1]);
+        if (!level) {
+            // the levels built so far are still a valid, shorter chain
+            SDL_LogWarn(
+                SDL_LOG_CATEGORY_RENDER, "Stopped mipmap generation at level %d: %s", chain->count, SDL_GetError());
+            break;
+        }
+        chain->levels[chain->count++] = level;
+    }
+    return true;
+}
+
+void Renderer_DestroyMipChain(RendererMipChain *const chain) {
+    for (int i = 0; i < chain->count; i++) {
+        SDL_DestroySurface(chain->levels[i]);
+    }
+    *chain = (RendererMipChain){0};
+}
+
+Uint32 Renderer_MipChainBytes(const RendererMipChain *const chain) {
+    Uint32 bytes = 0;
+    for (int i = 0; i < chain->count; i++) {
+        bytes += (Uint32)chain->levels[i]->pitch * (Uint32)chain->levels[i]->h;
+    }
+    return bytes;
+}
+
+bool Renderer_UploadMipChainLayer(SDL_GPUCopyPass *const copy_pass,
+                                  SDL_GPUTexture *const texture,
+                                  const Uint32 layer,
+                                  const RendererMipChain *const chain,
+                                  const int level_count) {
+    bool ok = level_count <= chain->count;
+    for (int i = 0; i < level_count && ok; i++) {
+        const SDL_Surface *const level = chain->levels[i];
+        const SDL_Rect region = {0, 0, level->w, level->h};
+        ok = Renderer_UploadTextureRegion(copy_pass,
+                                          texture,
+                                          layer,
+                                          (Uint32)i,
+                                          &region,
+                                          level->pixels,
+                                          level->pitch,
+                                          SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM);
+    }
+    return ok;
+}
+
+SDL_GPUTexture *Renderer_UploadMipChain(SDL_GPUCopyPass *const copy_pass, const RendererMipChain *const chain) {
+    if (!copy_pass || !chain || chain->count <= 0) {
+        return nullptr;
+    }
+    const SDL_GPUTextureCreateInfo tex_info = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+        .width = (Uint32)chain->levels[0]->w,
+        .height = (Uint32)chain->levels[0]->h,
+        .layer_count_or_depth = 1,
+        .num_levels = (Uint32)chain->count,
+        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+    };
+    SDL_GPUTexture *const texture = SDL_CreateGPUTexture(Renderer_GetDevice(), &tex_info);
+    if (!texture) {
+        return nullptr;
+    }
+    if (!Renderer_UploadMipChainLayer(copy_pass, texture, 0, chain, chain->count)) {
+        Renderer_DestroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
+
+SDL_GPUTexture *Renderer_CreateMipChainTexture(const RendererMipChain *const chain) {
+    SDL_GPUCommandBuffer *const upload_cmd = SDL_AcquireGPUCommandBuffer(Renderer_GetDevice());
+    if (!upload_cmd) {
+        return nullptr;
+    }
+    SDL_GPUCopyPass *const copy = SDL_BeginGPUCopyPass(upload_cmd);
+    SDL_GPUTexture *const texture = Renderer_UploadMipChain(copy, chain);
+    SDL_EndGPUCopyPass(copy);
+    SDL_SubmitGPUCommandBuffer(upload_cmd);
+    return texture;
+}
@@ -23,6 +23,7 @@
 #define NK_SDL3_GPU_H_
 
 #include "renderer.h"
+#include "renderer_internal.h"
 
 #include <SDL3/SDL.h>
 
@@ -51,10 +52,9 @@ NK_API struct nk_font_atlas *nk_sdl_gpu_font_stash_begin(const struct nk_context
 NK_API void nk_sdl_gpu_font_stash_end(struct nk_context *ctx);
 #endif
 NK_API int nk_sdl_gpu_handle_event(struct nk_context *ctx, const SDL_Event *evt);
-NK_API void nk_sdl_gpu_render(struct nk_context *ctx,
-                              SDL_GPUCommandBuffer *cmd,
-                              SDL_GPUTexture *swapchain,
-                              enum nk_anti_aliasing AA);
+/* Queues the frame's UI into the renderer, drawn at the end of its UI pass. Call between Renderer_BeginFrame() and
+ * Renderer_EndFrame(). */
+NK_API void nk_sdl_gpu_render(struct nk_context *ctx, enum nk_anti_aliasing AA);
 NK_API void nk_sdl_gpu_shutdown(struct nk_context *ctx);
 
 #endif /* NK_SDL3_GPU_H_ */
@@ -77,10 +77,7 @@ NK_API void nk_sdl_gpu_shutdown(struct nk_context *ctx);
 #define NK_SDL_DOUBLE_CLICK_HI 0.2
 #endif
 
-#define NK_SDL_GPU_FRAMES_IN_FLIGHT 3U
-#define NK_SDL_GPU_STREAM_ALIGN 16U
-#define NK_SDL_GPU_VERTEX_SLOT_BYTES (sizeof(struct nk_sdl_gpu_vertex) * 131072U)
-#define NK_SDL_GPU_INDEX_SLOT_BYTES (sizeof(nk_draw_index) * 524288U)
+#define NK_SDL_GPU_DRAWS_INITIAL 256 /* grown on demand */
 
 struct nk_sdl_gpu_vertex {
     float position[2];
@@ -94,14 +91,21 @@ struct nk_sdl_gpu_device {
     SDL_GPUTexture *font_tex;
     SDL_GPUGraphicsPipeline *pipeline;
     SDL_GPUSampler *sampler;
-    SDL_GPUBuffer *vertex_buffer;
-    SDL_GPUBuffer *index_buffer;
-    SDL_GPUTransferBuffer *vertex_transfer;
-    SDL_GPUTransferBuffer *index_transfer;
-    Uint32 vertex_slot_size;
-    Uint32 index_slot_size;
-    Uint32 frame_slot;
-    bool stream_capacity_warned;
+    struct nk_buffer vbuf; /* converted vertices, kept across frames */
+    struct nk_buffer ebuf;
+    RendererDebugUIDraw *draws; /* kept across frames like vbuf/ebuf */
+    Uint32 draw_count;
+    Uint32 draw_capacity;
+    bool draws_warned;
+    /* Commands of the last converted frame. A frame with the same commands and window size reuses vbuf, ebuf and
+     * draws as they are, without running nk_convert. */
+    void *last_commands;
+    nk_size last_commands_size;
+    nk_size last_commands_capacity;
+    int last_win_w;
+    int last_win_h;
+    enum nk_anti_aliasing last_AA;
+    bool converted_valid;
 };
 
 struct nk_sdl_gpu {
@@ -131,66 +135,6 @@ NK_INTERN void nk_sdl_gpu_free(const nk_handle user, void *const old) {
     SDL_free(old);
 }
 
-NK_INTERN Uint32 nk_sdl_gpu_align_up(const Uint32 value, const Uint32 align) {
-    const Uint32 mask = align - 1U;
-    return (value + mask) & ~mask;
-}
-
-NK_INTERN void nk_sdl_gpu_destroy_stream_buffers(struct nk_sdl_gpu *const sdl) {
-    if (sdl->gpu.vertex_transfer) {
-        SDL_ReleaseGPUTransferBuffer(sdl->device, sdl->gpu.vertex_transfer);
-        sdl->gpu.vertex_transfer = nullptr;
-    }
-    if (sdl->gpu.index_transfer) {
-        SDL_ReleaseGPUTransferBuffer(sdl->device, sdl->gpu.index_transfer);
-        sdl->gpu.index_transfer = nullptr;
-    }
-    if (sdl->gpu.vertex_buffer) {
-        SDL_ReleaseGPUBuffer(sdl->device, sdl->gpu.vertex_buffer);
-        sdl->gpu.vertex_buffer = nullptr;
-    }
-    if (sdl->gpu.index_buffer) {
-        SDL_ReleaseGPUBuffer(sdl->device, sdl->gpu.index_buffer);
-        sdl->gpu.index_buffer = nullptr;
-    }
-}
-
-NK_INTERN bool nk_sdl_gpu_create_stream_buffers(struct nk_sdl_gpu *const sdl) {
-    const Uint32 vertex_slot_size = nk_sdl_gpu_align_up(NK_SDL_GPU_VERTEX_SLOT_BYTES, NK_SDL_GPU_STREAM_ALIGN);
-    const Uint32 index_slot_size = nk_sdl_gpu_align_up(NK_SDL_GPU_INDEX_SLOT_BYTES, NK_SDL_GPU_STREAM_ALIGN);
-    const Uint32 vertex_total_size = vertex_slot_size * NK_SDL_GPU_FRAMES_IN_FLIGHT;
-    const Uint32 index_total_size = index_slot_size * NK_SDL_GPU_FRAMES_IN_FLIGHT;
-
-    sdl->gpu.vertex_slot_size = vertex_slot_size;
-    sdl->gpu.index_slot_size = index_slot_size;
-    sdl->gpu.frame_slot = 0;
-    sdl->gpu.stream_capacity_warned = false;
-
-    const SDL_GPUBufferCreateInfo vb_info = {.usage = SDL_GPU_BUFFERUSAGE_VERTEX, .size = vertex_total_size};
-    const SDL_GPUBufferCreateInfo ib_info = {.usage = SDL_GPU_BUFFERUSAGE_INDEX, .size = index_total_size};
-    sdl->gpu.vertex_buffer = SDL_CreateGPUBuffer(sdl->device, &vb_info);
-    sdl->gpu.index_buffer = SDL_CreateGPUBuffer(sdl->device, &ib_info);
-    if (!sdl->gpu.vertex_buffer || !sdl->gpu.index_buffer) {
-        SDL_Log("nuklear: Failed to create persistent GPU stream buffers");
-        nk_sdl_gpu_destroy_stream_buffers(sdl);
-        return false;
-    }
-
-    const SDL_GPUTransferBufferCreateInfo vtx_transfer_info = {
-        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = vertex_total_size};
-    const SDL_GPUTransferBufferCreateInfo idx_transfer_info = {
-        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = index_total_size};
-    sdl->gpu.vertex_transfer = SDL_CreateGPUTransferBuffer(sdl->device, &vtx_transfer_info);
-    sdl->gpu.index_transfer = SDL_CreateGPUTransferBuffer(sdl->device, &idx_transfer_info);
-    if (!sdl->gpu.vertex_transfer || !sdl->gpu.index_transfer) {
-        SDL_Log("nuklear: Failed to create persistent transfer stream buffers");
-        nk_sdl_gpu_destroy_stream_buffers(sdl);
-        return false;
-    }
-
-    return true;
-}
-
 /* Shader loading helper */
 NK_INTERN SDL_GPUShader *nk_sdl_gpu_load_shader(SDL_GPUDevice *const device,
                                                 const char *const path,
@@ -323,6 +267,8 @@ NK_API struct nk_context *nk_sdl_gpu_init(SDL_Window *const win, SDL_GPUDevice *
     sdl->ctx.clip.paste = nk_sdl_gpu_clipboard_paste;
     sdl->ctx.clip.userdata = nk_handle_ptr(sdl);
     nk_buffer_init(&sdl->gpu.cmds, &sdl->allocator, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&sdl->gpu.vbuf, &sdl->allocator, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    nk_buffer_init(&sdl->gpu.ebuf, &sdl->allocator, NK_BUFFER_DEFAULT_INITIAL_SIZE);
 
     /* Load shaders */
     char shader_path[512] = {0};
@@ -404,15 +350,8 @@ NK_API struct nk_context *nk_sdl_gpu_init(SDL_Window *const win, SDL_GPUDevice *
         SDL_Log("nuklear: Failed to create sampler");
         SDL_ReleaseGPUGraphicsPipeline(device, sdl->gpu.pipeline);
         nk_buffer_free(&sdl->gpu.cmds);
-        nk_free(&sdl->ctx);
-        SDL_free(sdl);
-        return nullptr;
-    }
-
-    if (!nk_sdl_gpu_create_stream_buffers(sdl)) {
-        SDL_ReleaseGPUSampler(device, sdl->gpu.sampler);
-        SDL_ReleaseGPUGraphicsPipeline(device, sdl->gpu.pipeline);
-        nk_buffer_free(&sdl->gpu.cmds);
+        nk_buffer_free(&sdl->gpu.vbuf);
+        nk_buffer_free(&sdl->gpu.ebuf);
         nk_free(&sdl->ctx);
         SDL_free(sdl);
         return nullptr;
@@ -438,6 +377,7 @@ NK_API void nk_sdl_gpu_font_stash_end(struct nk_context *const ctx) {
     const void *const image = nk_font_atlas_bake(&sdl->atlas, &w, &h, NK_FONT_ATLAS_RGBA32);
     nk_sdl_gpu_upload_atlas(ctx, image, w, h);
     nk_font_atlas_end(&sdl->atlas, nk_handle_ptr(sdl->gpu.font_tex), &sdl->gpu.tex_null);
+    sdl->gpu.converted_valid = false; /* the same commands now resolve to another texture */
 
     if (sdl->atlas.default_font) {
         nk_style_set_font(ctx, &sdl->atlas.default_font->handle);
@@ -607,19 +547,42 @@ NK_API int nk_sdl_gpu_handle_event(struct nk_context *const ctx, const SDL_Event
     return 0;
 }
 
-NK_API void nk_sdl_gpu_render(struct nk_context *const ctx,
-                              SDL_GPUCommandBuffer *const cmd,
-                              SDL_GPUTexture *const swapchain,
-                              enum nk_anti_aliasing AA) {
-    struct nk_sdl_gpu *const sdl = (struct nk_sdl_gpu *)ctx->userdata.ptr;
-    NK_ASSERT(sdl);
+/* Compares the frame's command memory and conversion settings with the last converted ones, keeping a copy when they
+ * differ. Needs NK_ZERO_COMMAND_MEMORY, otherwise padding inside the commands differs even when nothing changed. */
+NK_INTERN bool nk_sdl_gpu_commands_changed(struct nk_sdl_gpu *const sdl,
+                                           const enum nk_anti_aliasing AA,
+                                           const int win_w,
+                                           const int win_h) {
+    const void *const commands = nk_buffer_memory_const(&sdl->ctx.memory);
+    const nk_size size = sdl->ctx.memory.allocated;
+    if (sdl->gpu.converted_valid && size == sdl->gpu.last_commands_size && win_w == sdl->gpu.last_win_w &&
+        win_h == sdl->gpu.last_win_h && AA == sdl->gpu.last_AA &&
+        SDL_memcmp(commands, sdl->gpu.last_commands, size) == 0) {
+        return false;
+    }
 
-    /* Update delta time */
-    const Uint64 ticks = SDL_GetTicks();
-    ctx->delta_time_seconds = (float)(ticks - sdl->last_render) / 1000.0f;
-    sdl->last_render = ticks;
+    /* without a copy every frame converts, as if caching was off */
+    sdl->gpu.converted_valid = false;
+    if (size > sdl->gpu.last_commands_capacity) {
+        void *const grown = SDL_realloc(sdl->gpu.last_commands, size);
+        if (!grown)
+            return true;
+        sdl->gpu.last_commands = grown;
+        sdl->gpu.last_commands_capacity = size;
+    }
+    SDL_memcpy(sdl->gpu.last_commands, commands, size);
+    sdl->gpu.last_commands_size = size;
+    sdl->gpu.last_win_w = win_w;
+    sdl->gpu.last_win_h = win_h;
+    sdl->gpu.last_AA = AA;
+    sdl->gpu.converted_valid = true;
+    return true;
+}
+
+/* Converts the commands into vbuf/ebuf and records the scissored draws that index them */
+NK_INTERN void nk_sdl_gpu_convert(struct nk_sdl_gpu *const sdl, const enum nk_anti_aliasing AA, const int win_w, const int win_h) {
+    struct nk_context *const ctx = &sdl->ctx;
 
-    /* Convert commands to vertex/index buffers */
     static const struct nk_draw_vertex_layout_element vertex_layout[] = {
         {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sdl_gpu_vertex, position)},
         {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_sdl_gpu_vertex, uv)},
@@ -637,120 +600,13 @@ NK_API void nk_sdl_gpu_render(struct nk_context *const ctx,
                                        .shape_AA = AA,
                                        .line_AA = AA};
 
-    struct nk_buffer vbuf, ebuf;
-    nk_buffer_init(&vbuf, &sdl->allocator, NK_BUFFER_DEFAULT_INITIAL_SIZE);
-    nk_buffer_init(&ebuf, &sdl->allocator, NK_BUFFER_DEFAULT_INITIAL_SIZE);
-    nk_convert(ctx, &sdl->gpu.cmds, &vbuf, &ebuf, &config);
-
-    /* Get buffer sizes */
-    const Uint32 vert_size = (Uint32)vbuf.needed;
-    const Uint32 idx_size = (Uint32)ebuf.needed;
-
-    if (vert_size == 0 || idx_size == 0) {
-        nk_buffer_free(&vbuf);
-        nk_buffer_free(&ebuf);
-        nk_clear(ctx);
-        nk_buffer_clear(&sdl->gpu.cmds);
-        return;
-    }
-
-    if (!cmd || !swapchain) {
-        nk_buffer_free(&vbuf);
-        nk_buffer_free(&ebuf);
-        nk_clear(ctx);
-        nk_buffer_clear(&sdl->gpu.cmds);
-        return;
-    }
-
-    if (vert_size > sdl->gpu.vertex_slot_size || idx_size > sdl->gpu.index_slot_size) {
-        if (!sdl->gpu.stream_capacity_warned) {
-            SDL_LogWarn(SDL_LOG_CATEGORY_RENDER,
-                        "nuklear: UI stream exhausted (vert=%u/%u bytes, idx=%u/%u bytes)",
-                        vert_size,
-                        sdl->gpu.vertex_slot_size,
-                        idx_size,
-                        sdl->gpu.index_slot_size);
-            sdl->gpu.stream_capacity_warned = true;
-        }
-        nk_buffer_free(&vbuf);
-        nk_buffer_free(&ebuf);
-        nk_clear(ctx);
-        nk_buffer_clear(&sdl->gpu.cmds);
-        return;
-    }
-    sdl->gpu.stream_capacity_warned = false;
-
-    sdl->gpu.frame_slot = (sdl->gpu.frame_slot + 1U) % NK_SDL_GPU_FRAMES_IN_FLIGHT;
-    const Uint32 vertex_offset = sdl->gpu.frame_slot * sdl->gpu.vertex_slot_size;
-    const Uint32 index_offset_bytes = sdl->gpu.frame_slot * sdl->gpu.index_slot_size;
-
-    Uint8 *const vertex_map = (Uint8 *)SDL_MapGPUTransferBuffer(sdl->device, sdl->gpu.vertex_transfer, true);
-    Uint8 *const index_map = (Uint8 *)SDL_MapGPUTransferBuffer(sdl->device, sdl->gpu.index_transfer, true);
-    if (!vertex_map || !index_map) {
-        if (vertex_map) {
-            SDL_UnmapGPUTransferBuffer(sdl->device, sdl->gpu.vertex_transfer);
-        }
-        if (index_map) {
-            SDL_UnmapGPUTransferBuffer(sdl->device, sdl->gpu.index_transfer);
-        }
-        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "nuklear: failed to map transfer streams");
-        nk_buffer_free(&vbuf);
-        nk_buffer_free(&ebuf);
-        nk_clear(ctx);
-        nk_buffer_clear(&sdl->gpu.cmds);
-        return;
-    }
-
-    SDL_memcpy(vertex_map + vertex_offset, nk_buffer_memory_const(&vbuf), vert_size);
-    SDL_memcpy(index_map + index_offset_bytes, nk_buffer_memory_const(&ebuf), idx_size);
-
-    SDL_UnmapGPUTransferBuffer(sdl->device, sdl->gpu.vertex_transfer);
-    SDL_UnmapGPUTransferBuffer(sdl->device, sdl->gpu.index_transfer);
-
-    SDL_GPUCopyPass *const copy = SDL_BeginGPUCopyPass(cmd);
-    const SDL_GPUTransferBufferLocation src_v = {.transfer_buffer = sdl->gpu.vertex_transfer, .offset = vertex_offset};
-    const SDL_GPUBufferRegion dst_v = {.buffer = sdl->gpu.vertex_buffer, .offset = vertex_offset, .size = vert_size};
-    SDL_UploadToGPUBuffer(copy, &src_v, &dst_v, false);
-
-    const SDL_GPUTransferBufferLocation src_i = {.transfer_buffer = sdl->gpu.index_transfer, .offset = index_offset_bytes};
-    const SDL_GPUBufferRegion dst_i = {.buffer = sdl->gpu.index_buffer, .offset = index_offset_bytes, .size = idx_size};
-    SDL_UploadToGPUBuffer(copy, &src_i, &dst_i, false);
-    SDL_EndGPUCopyPass(copy);
+    /* The buffers keep their memory, after the first frames converting allocates nothing */
+    nk_buffer_clear(&sdl->gpu.cmds);
+    nk_buffer_clear(&sdl->gpu.vbuf);
+    nk_buffer_clear(&sdl->gpu.ebuf);
+    nk_convert(ctx, &sdl->gpu.cmds, &sdl->gpu.vbuf, &sdl->gpu.ebuf, &config);
 
-    /* Setup projection matrix */
-    int win_w, win_h;
-    SDL_GetWindowSizeInPixels(sdl->win, &win_w, &win_h);
-    const float projection[16] = {2.0f / (float)win_w,
-                            0.0f,
-                            0.0f,
-                            0.0f,
-                            0.0f,
-                            -2.0f / (float)win_h,
-                            0.0f,
-                            0.0f,
-                            0.0f,
-                            0.0f,
-                            1.0f,
-                            0.0f,
-                            -1.0f,
-                            1.0f,
-                            0.0f,
-                            1.0f};
-
-    /* Begin render pass */
-    const SDL_GPUColorTargetInfo color_target = {
-        .texture = swapchain, .load_op = SDL_GPU_LOADOP_LOAD, .store_op = SDL_GPU_STOREOP_STORE};
-    SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmd, &color_target, 1, nullptr);
-
-    SDL_BindGPUGraphicsPipeline(pass, sdl->gpu.pipeline);
-    SDL_BindGPUVertexBuffers(pass, 0, &(SDL_GPUBufferBinding){.buffer = sdl->gpu.vertex_buffer, .offset = vertex_offset}, 1);
-    SDL_BindGPUIndexBuffer(pass,
-                           &(SDL_GPUBufferBinding){.buffer = sdl->gpu.index_buffer, .offset = index_offset_bytes},
-                           sizeof(nk_draw_index) == 2 ? SDL_GPU_INDEXELEMENTSIZE_16BIT
-                                                      : SDL_GPU_INDEXELEMENTSIZE_32BIT);
-    SDL_PushGPUVertexUniformData(cmd, 0, projection, sizeof(projection));
-
-    /* Process draw commands */
+    sdl->gpu.draw_count = 0;
     Uint32 index_offset = 0;
     const struct nk_draw_command *draw_cmd;
     nk_draw_foreach(draw_cmd, ctx, &sdl->gpu.cmds) {
@@ -779,27 +635,63 @@ NK_API void nk_sdl_gpu_render(struct nk_context *const ctx,
             index_offset += draw_cmd->elem_count;
             continue;
         }
-        SDL_SetGPUScissor(pass, &scissor);
 
-        /* Bind texture */
-        SDL_GPUTexture *const tex = (SDL_GPUTexture *)draw_cmd->texture.ptr;
-        if (tex) {
-            SDL_BindGPUFragmentSamplers(
-                pass, 0, &(SDL_GPUTextureSamplerBinding){.texture = tex, .sampler = sdl->gpu.sampler}, 1);
+        if (sdl->gpu.draw_count == sdl->gpu.draw_capacity) {
+            const Uint32 capacity = sdl->gpu.draw_capacity ? sdl->gpu.draw_capacity * 2U : NK_SDL_GPU_DRAWS_INITIAL;
+            RendererDebugUIDraw *const grown = SDL_realloc(sdl->gpu.draws, sizeof(RendererDebugUIDraw) * capacity);
+            if (!grown) {
+                if (!sdl->gpu.draws_warned) {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_RENDER,
+                                "nuklear: out of memory at %u draw commands, dropping the rest",
+                                sdl->gpu.draw_count);
+                    sdl->gpu.draws_warned = true;
+                }
+                break;
+            }
+            sdl->gpu.draws = grown;
+            sdl->gpu.draw_capacity = capacity;
         }
-
-        /* Draw */
-        SDL_DrawGPUIndexedPrimitives(pass, draw_cmd->elem_count, 1, index_offset, 0, 0);
+        sdl->gpu.draws[sdl->gpu.draw_count++] = (RendererDebugUIDraw){.texture = (SDL_GPUTexture *)draw_cmd->texture.ptr,
+                                                                       .scissor = scissor,
+                                                                       .first_index = index_offset,
+                                                                       .index_count = draw_cmd->elem_count};
         index_offset += draw_cmd->elem_count;
     }
+}
 
-    SDL_EndGPURenderPass(pass);
+NK_API void nk_sdl_gpu_render(struct nk_context *const ctx, enum nk_anti_aliasing AA) {
+    struct nk_sdl_gpu *const sdl = (struct nk_sdl_gpu *)ctx->userdata.ptr;
+    NK_ASSERT(sdl);
+
+    /* Update delta time */
+    const Uint64 ticks = SDL_GetTicks();
+    ctx->delta_time_seconds = (float)(ticks - sdl->last_render) / 1000.0f;
+    sdl->last_render = ticks;
+
+    int win_w, win_h;
+    SDL_GetWindowSizeInPixels(sdl->win, &win_w, &win_h);
+
+    /* Windows left open usually produce the same commands frame after frame: reuse the last conversion then */
+    if (nk_sdl_gpu_commands_changed(sdl, AA, win_w, win_h))
+        nk_sdl_gpu_convert(sdl, AA, win_w, win_h);
+
+    /* Vertices and indices go into the renderer's upload streams, uploaded by its single copy pass */
+    const Uint32 vert_size = (Uint32)sdl->gpu.vbuf.needed;
+    const Uint32 idx_size = (Uint32)sdl->gpu.ebuf.needed;
+    if (vert_size > 0 && idx_size > 0 && sdl->gpu.draw_count > 0) {
+        Renderer_QueueDebugUI(sdl->gpu.pipeline,
+                              sdl->gpu.sampler,
+                              nk_buffer_memory_const(&sdl->gpu.vbuf),
+                              vert_size,
+                              nk_buffer_memory_const(&sdl->gpu.ebuf),
+                              idx_size,
+                              sizeof(nk_draw_index) == 2 ? SDL_GPU_INDEXELEMENTSIZE_16BIT
+                                                         : SDL_GPU_INDEXELEMENTSIZE_32BIT,
+                              sdl->gpu.draws,
+                              sdl->gpu.draw_count);
+    }
 
-    /* Cleanup */
-    nk_buffer_free(&vbuf);
-    nk_buffer_free(&ebuf);
     nk_clear(ctx);
-    nk_buffer_clear(&sdl->gpu.cmds);
 }
 
 NK_API void nk_sdl_gpu_shutdown(struct nk_context *const ctx) {
@@ -812,7 +704,10 @@ NK_API void nk_sdl_gpu_shutdown(struct nk_context *const ctx) {
 #endif
 
     nk_buffer_free(&sdl->gpu.cmds);
-    nk_sdl_gpu_destroy_stream_buffers(sdl);
+    nk_buffer_free(&sdl->gpu.vbuf);
+    nk_buffer_free(&sdl->gpu.ebuf);
+    SDL_free(sdl->gpu.last_commands);
+    SDL_free(sdl->gpu.draws);
 
     if (sdl->gpu.font_tex)
         SDL_ReleaseGPUTexture(sdl->device, sdl->gpu.font_tex);
@@ -1,5 +1,8 @@
 #include "renderer.h"
 
+#include "../cooked_texture.h"
+#include "../memtrack.h"
+#include "../profiler.h"
 #include "renderer_internal.h"
 
 #include <SDL3/SDL_log.h>
@@ -12,13 +15,23 @@ const char *getResourcePath(char *const string, const char *const relative_path)
     return string;
 }
 
+const char *getCookedAssetPath(char *const string, const char *const relative_path) {
+    SDL_snprintf(string, 512, "%scooked/%s", SDL_GetBasePath(), relative_path);
+    return string;
+}
+
 static SDL_GPUDevice *gpu_device = nullptr;
 static SDL_Window *render_window = nullptr;
 static SDL_GPUSampler *sampler = nullptr;
+static SDL_GPUSampler *linear_sampler = nullptr; // distance fields must be interpolated
+static SDL_GPUSampler *mip_sampler = nullptr;    // sprites shrunk on screen read their texture's smaller levels
 
 static SDL_GPUGraphicsPipeline *sprite_pipeline = nullptr;
+static SDL_GPUGraphicsPipeline *layered_sprite_pipeline = nullptr;
 static SDL_GPUGraphicsPipeline *geometry_pipeline = nullptr;
 static SDL_GPUGraphicsPipeline *line_pipeline = nullptr;
+static SDL_GPUGraphicsPipeline *wireframe_pipeline = nullptr;
+static SDL_GPUGraphicsPipeline *sdf_text_pipeline = nullptr;
 static SDL_GPUGraphicsPipeline *text_pipeline = nullptr;
 
 static TTF_TextEngine *text_engine = nullptr;
@@ -32,18 +45,29 @@ static SDL_GPUPresentMode g_present_mode = SDL_GPU_PRESENTMODE_VSYNC;
 #define RENDERER_STREAM_ALIGN 16U
 
 #define RENDERER_MAX_SPRITE_CMDS 4096U
+#define RENDERER_MAX_TEXTURE_ARRAYS 16U
 #define RENDERER_MAX_WORLD_GEOM_CMDS 4096U
-#define RENDERER_MAX_LINE_CMDS 8192U
+#define RENDERER_MAX_LINE_CMDS 1024U // consecutive batches sharing a matrix merge into one command
+#define RENDERER_MAX_WIREFRAME_CMDS 256U
+#define RENDERER_MAX_SDF_TEXT_CMDS 256U
+#define RENDERER_WIREFRAME_MAX_SEGMENTS 16384U // 2 * (width + length + levels) + 3, a box 8000 tiles across
 #define RENDERER_MAX_UI_GEOM_CMDS 4096U
 #define RENDERER_MAX_UI_TEXT_CMDS 1024U
-#define RENDERER_MAX_UI_TEXT_RANGES 16U
+#define RENDERER_MAX_UI_BLOCKS 64U
+#define RENDERER_MAX_DEBUG_UI_CMDS 8U
+#define RENDERER_DEBUG_UI_DRAWS_INITIAL 1024U // grown on demand, a busy Nuklear frame can need more
 
-#define RENDERER_SPRITE_SLOT_BYTES (sizeof(SpriteInstance) * 100000U)
+#define RENDERER_SPRITE_SLOT_BYTES (sizeof(SpriteInstance) * 100000U) // SpriteLayerInstance batches share it
 #define RENDERER_WORLD_GEOM_SLOT_BYTES (sizeof(SDL_Vertex) * 300000U)
-#define RENDERER_LINE_SLOT_BYTES (sizeof(float) * 3U * 65536U)
+#define RENDERER_LINE_SLOT_BYTES (sizeof(RendererLineVertex) * 262144U)
+#define RENDERER_WIREFRAME_SLOT_BYTES (sizeof(RendererWireframeInstance) * 131072U)
+#define RENDERER_SDF_TEXT_SLOT_BYTES (sizeof(RendererSDFGlyph) * 131072U)
 #define RENDERER_UI_GEOM_SLOT_BYTES (sizeof(SDL_Vertex) * 131072U)
-#define RENDERER_UI_TEXT_VERT_SLOT_BYTES (sizeof(float) * 4U * 262144U)
+#define RENDERER_UI_TEXT_VERT_SLOT_BYTES (sizeof(UITextVertex) * 262144U)
 #define RENDERER_UI_TEXT_INDEX_SLOT_BYTES (sizeof(int) * 524288U)
+#define RENDERER_DEBUG_UI_VERT_SLOT_BYTES (32U * 131072U) // Nuklear's vertex: float2 position, float2 uv, float4 color
+#define RENDERER_DEBUG_UI_INDEX_SLOT_BYTES (sizeof(Uint32) * 524288U)
+#define RENDERER_UI_BLOCK_SLOT_BYTES (1024U * 1024U) // staging for UI blocks updated this frame
 
 typedef struct {
     float viewProjection[16];
@@ -63,10 +87,16 @@ typedef struct {
 
 typedef struct {
     SDL_GPUTexture *texture;
-    Uint32 first_instance;
+    Uint32 first_instance; // in instances of this command's stride
     Uint32 instance_count;
     SpriteUniforms uniforms;
+    SDL_GPUSampler *sampler; // chosen from the view projection's zoom, see renderer_sprite_sampler
+    bool layered;            // SpriteLayerInstance from a texture array, drawn by layered_sprite_pipeline
 } SpriteCmd;
+static_assert(sizeof(SpriteInstance) == 48, "SpriteInstance must match InstanceData in sprite.metal");
+static_assert(sizeof(SpriteLayerInstance) == 64, "SpriteLayerInstance must match LayeredInstanceData in sprite.metal");
+static_assert(RENDERER_SPRITE_SLOT_BYTES % sizeof(SpriteLayerInstance) == 0,
+              "Sprite stream slots must start on a whole instance of either stride");
 
 typedef struct {
     Uint32 vertex_offset;
@@ -76,9 +106,28 @@ typedef struct {
 
 typedef struct {
     Uint32 vertex_offset;
-    SDL_FColor color;
+    Uint32 vertex_count;
     float matrix[16];
 } LineCmd;
+static_assert(sizeof(RendererLineVertex) == 16, "RendererLineVertex must match LineVertexInput in ui.metal");
+static_assert(sizeof(UITextVertex) == 20, "UITextVertex must match TextVertexInput in ui.metal");
+
+typedef struct {
+    Uint32 first_instance;
+    Uint32 instance_count;
+    Uint32 segment_count; // of the largest box, every instance in the draw gets this many
+    float matrix[16];
+} WireframeCmd;
+static_assert(sizeof(RendererWireframeInstance) == 32,
+              "RendererWireframeInstance must match WireframeInstance in wireframe.metal");
+
+typedef struct {
+    SDL_GPUTexture *atlas;
+    Uint32 first_instance;
+    Uint32 instance_count;
+    float matrix[16];
+} SDFTextCmd;
+static_assert(sizeof(RendererSDFGlyph) == 32, "RendererSDFGlyph must match GlyphInstance in sdf_text.metal");
 
 typedef struct {
     SDL_GPUTexture *atlas;
@@ -86,26 +135,74 @@ typedef struct {
     Uint32 index_count;
 } UITextRangeCmd;
 
+// Grown on demand, text has no limit on atlas count
+typedef struct {
+    UITextRangeCmd *ranges;
+    Uint32 count;
+    Uint32 capacity;
+} UITextRangeList;
+
 typedef struct {
     Uint32 vertex_offset;
     Uint32 index_offset;
     Uint32 vertex_count;
     Uint32 index_count;
-    UITextRangeCmd ranges[RENDERER_MAX_UI_TEXT_RANGES];
+    Uint32 first_range; // into ui_text_ranges
     Uint32 range_count;
 } UITextCmd;
 
+// Buffer layout: [geometry vertices | text vertices | text indices], each part 16-byte aligned
+typedef struct {
+    bool live;
+    SDL_GPUBuffer *buffer;
+    Uint32 capacity;
+    bool pending; // the last update is staged in ui_block_stream, uploaded at the next flush
+    Uint32 pending_offset;
+    Uint32 pending_size;
+    Uint32 geometry_count;
+    Uint32 text_vertex_offset;
+    Uint32 index_offset;
+    Uint32 index_count;
+    UITextRangeList ranges;
+} UIBlock;
+
+// A queued block and how many immediate UI commands were queued before it, so the pass keeps submission order
+typedef struct {
+    RendererUIBlock block;
+    Uint32 geom_cmd_mark; // ui_geom_cmd_count at the time of the draw
+    Uint32 text_cmd_mark; // ui_text_cmd_count at the time of the draw
+} UIBlockDraw;
+
+typedef struct {
+    SDL_GPUGraphicsPipeline *pipeline;
+    SDL_GPUSampler *sampler;
+    Uint32 vertex_offset;
+    Uint32 index_offset;
+    SDL_GPUIndexElementSize index_size;
+    Uint32 first_draw; // into debug_ui_draws
+    Uint32 draw_count;
+} DebugUICmd;
+
 static SpriteUniforms sprite_uniforms = {0};
+static SDL_GPUSampler *sprite_sampler = nullptr; // for the current view projection
 
 static RendererUploadStream sprite_stream = {0};
 static RendererUploadStream world_geom_stream = {0};
 static RendererUploadStream line_stream = {0};
+static RendererUploadStream wireframe_stream = {0};
+static RendererUploadStream sdf_text_stream = {0};
 static RendererUploadStream ui_geom_stream = {0};
 static RendererUploadStream ui_text_vert_stream = {0};
 static RendererUploadStream ui_text_index_stream = {0};
+static RendererUploadStream debug_ui_vert_stream = {0};
+static RendererUploadStream debug_ui_index_stream = {0};
+static RendererUploadStream ui_block_stream = {0}; // staging only, blocks own their GPU buffers
 
 static SpriteCmd sprite_cmds[RENDERER_MAX_SPRITE_CMDS] = {0};
 static Uint32 sprite_cmd_count = 0;
+// textures from Renderer_LoadTextureArray(), the only ones the layered sprite pipeline can sample
+static SDL_GPUTexture *texture_arrays[RENDERER_MAX_TEXTURE_ARRAYS] = {0};
+static Uint32 texture_array_count = 0;
 
 static GeometryCmd world_geom_cmds[RENDERER_MAX_WORLD_GEOM_CMDS] = {0};
 static Uint32 world_geom_cmd_count = 0;
@@ -113,11 +210,28 @@ static Uint32 world_geom_cmd_count = 0;
 static LineCmd line_cmds[RENDERER_MAX_LINE_CMDS] = {0};
 static Uint32 line_cmd_count = 0;
 
+static WireframeCmd wireframe_cmds[RENDERER_MAX_WIREFRAME_CMDS] = {0};
+static Uint32 wireframe_cmd_count = 0;
+
+static SDFTextCmd sdf_text_cmds[RENDERER_MAX_SDF_TEXT_CMDS] = {0};
+static Uint32 sdf_text_cmd_count = 0;
+
 static GeometryCmd ui_geom_cmds[RENDERER_MAX_UI_GEOM_CMDS] = {0};
 static Uint32 ui_geom_cmd_count = 0;
 
 static UITextCmd ui_text_cmds[RENDERER_MAX_UI_TEXT_CMDS] = {0};
 static Uint32 ui_text_cmd_count = 0;
+static UITextRangeList ui_text_ranges = {0};
+
+static DebugUICmd debug_ui_cmds[RENDERER_MAX_DEBUG_UI_CMDS] = {0};
+static Uint32 debug_ui_cmd_count = 0;
+static RendererDebugUIDraw *debug_ui_draws = nullptr;
+static Uint32 debug_ui_draw_count = 0;
+static Uint32 debug_ui_draw_capacity = 0;
+
+static UIBlock ui_blocks[RENDERER_MAX_UI_BLOCKS] = {0}; // handle - 1 indexes this
+static UIBlockDraw ui_block_draws[RENDERER_MAX_UI_BLOCKS] = {0};
+static Uint32 ui_block_draw_count = 0;
 
 static Uint32 current_frame_slot = 0;
 static bool frame_queues_flushed = false;
@@ -126,9 +240,9 @@ static RendererFrameStats g_frame_stats = {0};
 
 static float g_screen_projection[16] = {0};
 
+// Not limited to powers of two: sprite instances are aligned to their 48 or 64 byte stride
 static inline Uint32 renderer_align_up(const Uint32 value, const Uint32 align) {
-    const Uint32 mask = align - 1U;
-    return (value + mask) & ~mask;
+    return (value + align - 1U) / align * align;
 }
 
 static void renderer_make_screen_projection(float out[16]) {
@@ -197,6 +311,7 @@ static SDL_GPUShader *LoadShader(SDL_GPUDevice *const device,
     return shader;
 }
 
+// A usage of 0 makes a staging-only stream, whose data is copied into other buffers instead of its own
 static bool renderer_stream_init(RendererUploadStream *const stream, const SDL_GPUBufferUsageFlags usage, const Uint32 slot_size) {
     stream->slot_size = renderer_align_up(slot_size, RENDERER_STREAM_ALIGN);
     stream->total_size = stream->slot_size * RENDERER_FRAMES_IN_FLIGHT;
@@ -205,8 +320,8 @@ static bool renderer_stream_init(RendererUploadStream *const stream, const SDL_G
         .usage = usage,
         .size = stream->total_size,
     };
-    stream->gpu = SDL_CreateGPUBuffer(gpu_device, &gpu_info);
-    if (!stream->gpu) {
+    stream->gpu = usage ? SDL_CreateGPUBuffer(gpu_device, &gpu_info) : nullptr;
+    if (usage && !stream->gpu) {
         SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create GPU buffer stream: %s", SDL_GetError());
         return false;
     }
@@ -218,8 +333,10 @@ static bool renderer_stream_init(RendererUploadStream *const stream, const SDL_G
     stream->transfer = SDL_CreateGPUTransferBuffer(gpu_device, &transfer_info);
     if (!stream->transfer) {
         SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create transfer stream: %s", SDL_GetError());
-        SDL_ReleaseGPUBuffer(gpu_device, stream->gpu);
-        stream->gpu = nullptr;
+        if (stream->gpu) {
+            SDL_ReleaseGPUBuffer(gpu_device, stream->gpu);
+            stream->gpu = nullptr;
+        }
         return false;
     }
 
@@ -317,6 +434,26 @@ static bool renderer_stream_upload_used(SDL_GPUCopyPass *const copy_pass, const
     return true;
 }
 
+static void renderer_ui_blocks_upload(SDL_GPUCopyPass *const copy_pass) {
+    for (Uint32 i = 0; i < RENDERER_MAX_UI_BLOCKS; i++) {
+        UIBlock *const block = &ui_blocks[i];
+        if (!block->live || !block->pending) {
+            continue;
+        }
+        // the whole content is rewritten, so cycling is safe and avoids waiting on frames still reading it
+        const SDL_GPUTransferBufferLocation source = {
+            .transfer_buffer = ui_block_stream.transfer,
+            .offset = block->pending_offset,
+        };
+        SDL_UploadToGPUBuffer(
+            copy_pass,
+            &source,
+            &((SDL_GPUBufferRegion){.buffer = block->buffer, .offset = 0, .size = block->pending_size}),
+            true);
+        block->pending = false;
+    }
+}
+
 static Uint32 renderer_stream_used_bytes(const RendererUploadStream *const stream) {
     if (!stream || stream->write_offset <= stream->slot_base) {
         return 0;
@@ -335,17 +472,69 @@ static void renderer_record_stream_stats(void) {
     renderer_record_stream_stat(RENDERER_STATS_STREAM_SPRITE, &sprite_stream);
     renderer_record_stream_stat(RENDERER_STATS_STREAM_WORLD_GEOMETRY, &world_geom_stream);
     renderer_record_stream_stat(RENDERER_STATS_STREAM_LINE, &line_stream);
+    renderer_record_stream_stat(RENDERER_STATS_STREAM_WIREFRAME, &wireframe_stream);
+    renderer_record_stream_stat(RENDERER_STATS_STREAM_SDF_TEXT, &sdf_text_stream);
     renderer_record_stream_stat(RENDERER_STATS_STREAM_UI_GEOMETRY, &ui_geom_stream);
     renderer_record_stream_stat(RENDERER_STATS_STREAM_UI_TEXT_VERT, &ui_text_vert_stream);
     renderer_record_stream_stat(RENDERER_STATS_STREAM_UI_TEXT_INDEX, &ui_text_index_stream);
+    renderer_record_stream_stat(RENDERER_STATS_STREAM_DEBUG_UI_VERT, &debug_ui_vert_stream);
+    renderer_record_stream_stat(RENDERER_STATS_STREAM_DEBUG_UI_INDEX, &debug_ui_index_stream);
+    renderer_record_stream_stat(RENDERER_STATS_STREAM_UI_BLOCK, &ui_block_stream);
+}
+
+// Appends the non-empty atlas ranges of one command, merging a range that continues the previous one on the same atlas.
+// Ranges before `first` belong to other commands, whose indices are relative to another buffer offset.
+static bool renderer_text_ranges_append(UITextRangeList *const list,
+                                        const Uint32 first,
+                                        const UITextAtlasInfo *const atlases,
+                                        const int atlas_count) {
+    for (int i = 0; i < atlas_count; i++) {
+        if (!atlases[i].atlas || atlases[i].index_count <= 0) {
+            continue;
+        }
+        const Uint32 start_index = (Uint32)atlases[i].start_index;
+        const Uint32 index_count = (Uint32)atlases[i].index_count;
+        UITextRangeCmd *const last = list->count > first ? &list->ranges[list->count - 1U] : nullptr;
+        if (last && last->atlas == atlases[i].atlas && last->start_index + last->index_count == start_index) {
+            last->index_count += index_count;
+            continue;
+        }
+
+        if (list->count == list->capacity) {
+            const Uint32 capacity = list->capacity ? list->capacity * 2U : 16U;
+            UITextRangeCmd *const ranges = SDL_realloc(list->ranges, sizeof(UITextRangeCmd) * capacity);
+            if (!ranges) {
+                return false;
+            }
+            list->ranges = ranges;
+            list->capacity = capacity;
+        }
+        list->ranges[list->count++] = (UITextRangeCmd){
+            .atlas = atlases[i].atlas,
+            .start_index = start_index,
+            .index_count = index_count,
+        };
+    }
+    return true;
+}
+
+static void renderer_text_ranges_free(UITextRangeList *const list) {
+    SDL_free(list->ranges);
+    *list = (UITextRangeList){0};
 }
 
 static void renderer_reset_queues(void) {
     sprite_cmd_count = 0;
     world_geom_cmd_count = 0;
     line_cmd_count = 0;
+    wireframe_cmd_count = 0;
+    sdf_text_cmd_count = 0;
     ui_geom_cmd_count = 0;
     ui_text_cmd_count = 0;
+    ui_text_ranges.count = 0;
+    ui_block_draw_count = 0;
+    debug_ui_cmd_count = 0;
+    debug_ui_draw_count = 0;
 }
 
 static void renderer_reset_frame_stats(void) {
@@ -368,9 +557,10 @@ static void renderer_count_pass_end(void) {
     g_frame_stats.passes.end_calls++;
 }
 
-static void renderer_bind_sprite_pipeline(SDL_GPURenderPass *const pass, SDL_GPUTexture *const texture) {
-    SDL_BindGPUGraphicsPipeline(pass, sprite_pipeline);
-    SDL_BindGPUFragmentSamplers(pass, 0, &((SDL_GPUTextureSamplerBinding){.texture = texture, .sampler = sampler}), 1);
+static void renderer_bind_sprite_pipeline(SDL_GPURenderPass *const pass, const SpriteCmd *const cmd) {
+    SDL_BindGPUGraphicsPipeline(pass, cmd->layered ? layered_sprite_pipeline : sprite_pipeline);
+    SDL_BindGPUFragmentSamplers(
+        pass, 0, &((SDL_GPUTextureSamplerBinding){.texture = cmd->texture, .sampler = cmd->sampler}), 1);
     SDL_BindGPUVertexStorageBuffers(pass, 0, &sprite_stream.gpu, 1);
 }
 
@@ -395,16 +585,17 @@ static void renderer_draw_world_pass(SDL_GPUCommandBuffer *const cmd) {
     renderer_count_pass_begin();
     g_frame_stats.passes.world_passes++;
 
-    const SDL_GPUTexture *bound_sprite_tex = nullptr;
+    const SpriteCmd *bound_sprite_cmd = nullptr;
     for (Uint32 i = 0; i < sprite_cmd_count; i++) {
         const SpriteCmd *const cmdi = &sprite_cmds[i];
         if (!cmdi->texture || cmdi->instance_count == 0) {
             continue;
         }
 
-        if (bound_sprite_tex != cmdi->texture) {
-            renderer_bind_sprite_pipeline(pass, cmdi->texture);
-            bound_sprite_tex = cmdi->texture;
+        if (!bound_sprite_cmd || bound_sprite_cmd->texture != cmdi->texture ||
+            bound_sprite_cmd->layered != cmdi->layered || bound_sprite_cmd->sampler != cmdi->sampler) {
+            renderer_bind_sprite_pipeline(pass, cmdi);
+            bound_sprite_cmd = cmdi;
         }
 
         SDL_PushGPUVertexUniformData(cmd, 0, &cmdi->uniforms, sizeof(SpriteUniforms));
@@ -428,23 +619,141 @@ static void renderer_draw_world_pass(SDL_GPUCommandBuffer *const cmd) {
         g_frame_stats.queues[RENDERER_STATS_QUEUE_WORLD_GEOMETRY].draw_calls++;
     }
 
+    if (line_cmd_count > 0) {
+        SDL_BindGPUGraphicsPipeline(pass, line_pipeline);
+        SDL_BindGPUVertexBuffers(pass, 0, &((SDL_GPUBufferBinding){.buffer = line_stream.gpu, .offset = 0}), 1);
+    }
     for (Uint32 i = 0; i < line_cmd_count; i++) {
         const LineCmd *const cmdi = &line_cmds[i];
 
-        SDL_BindGPUGraphicsPipeline(pass, line_pipeline);
-        SDL_BindGPUVertexBuffers(
-            pass, 0, &((SDL_GPUBufferBinding){.buffer = line_stream.gpu, .offset = cmdi->vertex_offset}), 1);
         SDL_PushGPUVertexUniformData(cmd, 0, cmdi->matrix, sizeof(float) * 16U);
-        SDL_PushGPUFragmentUniformData(cmd, 0, &cmdi->color, sizeof(cmdi->color));
-        SDL_DrawGPUPrimitives(pass, 2, 1, 0, 0);
+        SDL_DrawGPUPrimitives(pass, cmdi->vertex_count, 1, cmdi->vertex_offset / (Uint32)sizeof(RendererLineVertex), 0);
 
         g_frame_stats.queues[RENDERER_STATS_QUEUE_LINE].draw_calls++;
     }
 
+    if (wireframe_cmd_count > 0) {
+        SDL_BindGPUGraphicsPipeline(pass, wireframe_pipeline);
+        SDL_BindGPUVertexStorageBuffers(pass, 0, &wireframe_stream.gpu, 1);
+    }
+    for (Uint32 i = 0; i < wireframe_cmd_count; i++) {
+        const WireframeCmd *const cmdi = &wireframe_cmds[i];
+
+        SDL_PushGPUVertexUniformData(cmd, 0, cmdi->matrix, sizeof(float) * 16U);
+        SDL_DrawGPUPrimitives(pass, cmdi->segment_count * 6U, cmdi->instance_count, 0, cmdi->first_instance);
+
+        g_frame_stats.queues[RENDERER_STATS_QUEUE_WIREFRAME].draw_calls++;
+    }
+
+    // labels last and without depth test, they read over everything in the world
+    if (sdf_text_cmd_count > 0) {
+        SDL_BindGPUGraphicsPipeline(pass, sdf_text_pipeline);
+        SDL_BindGPUVertexStorageBuffers(pass, 0, &sdf_text_stream.gpu, 1);
+    }
+    const SDL_GPUTexture *bound_atlas = nullptr;
+    for (Uint32 i = 0; i < sdf_text_cmd_count; i++) {
+        const SDFTextCmd *const cmdi = &sdf_text_cmds[i];
+
+        if (bound_atlas != cmdi->atlas) {
+            SDL_BindGPUFragmentSamplers(
+                pass, 0, &((SDL_GPUTextureSamplerBinding){.texture = cmdi->atlas, .sampler = linear_sampler}), 1);
+            bound_atlas = cmdi->atlas;
+        }
+        SDL_PushGPUVertexUniformData(cmd, 0, cmdi->matrix, sizeof(float) * 16U);
+        SDL_DrawGPUPrimitives(pass, 6, cmdi->instance_count, 0, cmdi->first_instance);
+
+        g_frame_stats.queues[RENDERER_STATS_QUEUE_SDF_TEXT].draw_calls++;
+    }
+
     SDL_EndGPURenderPass(pass);
     renderer_count_pass_end();
 }
 
+// Binding state shared by the UI pass helpers, text only rebinds its atlas when it changes
+typedef struct {
+    SDL_GPURenderPass *pass;
+    SDL_GPUCommandBuffer *cmd;
+    SDL_GPUGraphicsPipeline *pipeline;
+    SDL_GPUTexture *atlas;
+} UIPassState;
+
+static void renderer_ui_bind_pipeline(UIPassState *const state, SDL_GPUGraphicsPipeline *const pipeline) {
+    if (state->pipeline != pipeline) {
+        SDL_BindGPUGraphicsPipeline(state->pass, pipeline);
+        SDL_PushGPUVertexUniformData(state->cmd, 0, g_screen_projection, sizeof(float) * 16U);
+        state->pipeline = pipeline;
+    }
+}
+
+static void renderer_ui_draw_geometry(UIPassState *const state,
+                                      SDL_GPUBuffer *const buffer,
+                                      const Uint32 offset,
+                                      const Uint32 vertex_count) {
+    if (vertex_count == 0) {
+        return;
+    }
+    renderer_ui_bind_pipeline(state, geometry_pipeline);
+    SDL_BindGPUVertexBuffers(state->pass, 0, &((SDL_GPUBufferBinding){.buffer = buffer, .offset = offset}), 1);
+    SDL_DrawGPUPrimitives(state->pass, vertex_count, 1, 0, 0);
+
+    g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_GEOMETRY].draw_calls++;
+}
+
+static void renderer_ui_draw_text(UIPassState *const state,
+                                  SDL_GPUBuffer *const vertex_buffer,
+                                  const Uint32 vertex_offset,
+                                  SDL_GPUBuffer *const index_buffer,
+                                  const Uint32 index_offset,
+                                  const UITextRangeCmd *const ranges,
+                                  const Uint32 range_count) {
+    if (range_count == 0) {
+        return;
+    }
+    renderer_ui_bind_pipeline(state, text_pipeline);
+    SDL_BindGPUVertexBuffers(
+        state->pass, 0, &((SDL_GPUBufferBinding){.buffer = vertex_buffer, .offset = vertex_offset}), 1);
+    SDL_BindGPUIndexBuffer(state->pass,
+                           &((SDL_GPUBufferBinding){.buffer = index_buffer, .offset = index_offset}),
+                           SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+    for (Uint32 r = 0; r < range_count; r++) {
+        const UITextRangeCmd *const range = &ranges[r];
+        if (range->atlas != state->atlas) {
+            SDL_BindGPUFragmentSamplers(
+                state->pass, 0, &((SDL_GPUTextureSamplerBinding){.texture = range->atlas, .sampler = sampler}), 1);
+            state->atlas = range->atlas;
+        }
+        SDL_DrawGPUIndexedPrimitives(state->pass, range->index_count, 1, range->start_index, 0, 0);
+
+        g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_TEXT].draw_calls++;
+    }
+}
+
+// Immediate commands in [*geom_done, geom_end) and [*text_done, text_end): geometry first, then the text over it
+static void renderer_ui_draw_immediate(UIPassState *const state,
+                                       Uint32 *const geom_done,
+                                       const Uint32 geom_end,
+                                       Uint32 *const text_done,
+                                       const Uint32 text_end) {
+    for (; *geom_done < geom_end; (*geom_done)++) {
+        const GeometryCmd *const cmdi = &ui_geom_cmds[*geom_done];
+        renderer_ui_draw_geometry(state, ui_geom_stream.gpu, cmdi->vertex_offset, cmdi->vertex_count);
+    }
+    for (; *text_done < text_end; (*text_done)++) {
+        const UITextCmd *const cmdi = &ui_text_cmds[*text_done];
+        if (cmdi->index_count == 0 || cmdi->vertex_count == 0) {
+            continue;
+        }
+        renderer_ui_draw_text(state,
+                              ui_text_vert_stream.gpu,
+                              cmdi->vertex_offset,
+                              ui_text_index_stream.gpu,
+                              cmdi->index_offset,
+                              &ui_text_ranges.ranges[cmdi->first_range],
+                              cmdi->range_count);
+    }
+}
+
 static void renderer_draw_ui_pass(SDL_GPUCommandBuffer *cmd) {
     const SDL_GPUColorTargetInfo color_target = {
         .texture = swapchain_texture,
@@ -456,50 +765,51 @@ static void renderer_draw_ui_pass(SDL_GPUCommandBuffer *cmd) {
     renderer_count_pass_begin();
     g_frame_stats.passes.ui_passes++;
 
-    for (Uint32 i = 0; i < ui_geom_cmd_count; i++) {
-        const GeometryCmd *cmdi = &ui_geom_cmds[i];
-        if (cmdi->vertex_count == 0) {
-            continue;
-        }
-
-        SDL_BindGPUGraphicsPipeline(pass, geometry_pipeline);
-        SDL_BindGPUVertexBuffers(
-            pass, 0, &((SDL_GPUBufferBinding){.buffer = ui_geom_stream.gpu, .offset = cmdi->vertex_offset}), 1);
-        SDL_PushGPUVertexUniformData(cmd, 0, g_screen_projection, sizeof(float) * 16U);
-        SDL_DrawGPUPrimitives(pass, cmdi->vertex_count, 1, 0, 0);
-
-        g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_GEOMETRY].draw_calls++;
-    }
-
-    for (Uint32 i = 0; i < ui_text_cmd_count; i++) {
-        const UITextCmd *cmdi = &ui_text_cmds[i];
-        if (cmdi->range_count == 0 || cmdi->index_count == 0 || cmdi->vertex_count == 0) {
-            continue;
-        }
-
-        SDL_BindGPUGraphicsPipeline(pass, text_pipeline);
+    // Submission order: each block lands after the immediate commands queued before it, with its text over its
+    // geometry. The pipeline, projection and atlas are only rebound when they change.
+    UIPassState state = {.pass = pass, .cmd = cmd};
+    Uint32 geom_done = 0;
+    Uint32 text_done = 0;
+    for (Uint32 i = 0; i < ui_block_draw_count; i++) {
+        const UIBlockDraw *const draw = &ui_block_draws[i];
+        renderer_ui_draw_immediate(&state, &geom_done, draw->geom_cmd_mark, &text_done, draw->text_cmd_mark);
+
+        const UIBlock *const block = &ui_blocks[draw->block - 1U];
+        renderer_ui_draw_geometry(&state, block->buffer, 0, block->geometry_count);
+        renderer_ui_draw_text(&state,
+                              block->buffer,
+                              block->text_vertex_offset,
+                              block->buffer,
+                              block->index_offset,
+                              block->ranges.ranges,
+                              block->ranges.count);
+    }
+    renderer_ui_draw_immediate(&state, &geom_done, ui_geom_cmd_count, &text_done, ui_text_cmd_count);
+
+    // last, the scissor rects it sets would clip anything drawn after it
+    for (Uint32 i = 0; i < debug_ui_cmd_count; i++) {
+        const DebugUICmd *const cmdi = &debug_ui_cmds[i];
+
+        SDL_BindGPUGraphicsPipeline(pass, cmdi->pipeline);
         SDL_BindGPUVertexBuffers(
-            pass, 0, &((SDL_GPUBufferBinding){.buffer = ui_text_vert_stream.gpu, .offset = cmdi->vertex_offset}), 1);
-        SDL_BindGPUIndexBuffer(
-            pass,
-            &((SDL_GPUBufferBinding){.buffer = ui_text_index_stream.gpu, .offset = cmdi->index_offset}),
-            SDL_GPU_INDEXELEMENTSIZE_32BIT);
+            pass, 0, &((SDL_GPUBufferBinding){.buffer = debug_ui_vert_stream.gpu, .offset = cmdi->vertex_offset}), 1);
+        SDL_BindGPUIndexBuffer(pass,
+                               &((SDL_GPUBufferBinding){.buffer = debug_ui_index_stream.gpu, .offset = cmdi->index_offset}),
+                               cmdi->index_size);
         SDL_PushGPUVertexUniformData(cmd, 0, g_screen_projection, sizeof(float) * 16U);
 
-        constexpr float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-        SDL_PushGPUFragmentUniformData(cmd, 0, color, sizeof(color));
-
-        for (Uint32 r = 0; r < cmdi->range_count; r++) {
-            const UITextRangeCmd *const range = &cmdi->ranges[r];
-            if (!range->atlas || range->index_count == 0) {
-                continue;
+        const SDL_GPUTexture *bound_texture = nullptr;
+        for (Uint32 d = 0; d < cmdi->draw_count; d++) {
+            const RendererDebugUIDraw *const draw = &debug_ui_draws[cmdi->first_draw + d];
+            SDL_SetGPUScissor(pass, &draw->scissor);
+            if (draw->texture && draw->texture != bound_texture) {
+                SDL_BindGPUFragmentSamplers(
+                    pass, 0, &((SDL_GPUTextureSamplerBinding){.texture = draw->texture, .sampler = cmdi->sampler}), 1);
+                bound_texture = draw->texture;
             }
+            SDL_DrawGPUIndexedPrimitives(pass, draw->index_count, 1, draw->first_index, 0, 0);
 
-            SDL_BindGPUFragmentSamplers(
-                pass, 0, &((SDL_GPUTextureSamplerBinding){.texture = range->atlas, .sampler = sampler}), 1);
-            SDL_DrawGPUIndexedPrimitives(pass, range->index_count, 1, range->start_index, 0, 0);
-
-            g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_TEXT].draw_calls++;
+            g_frame_stats.queues[RENDERER_STATS_QUEUE_DEBUG_UI].draw_calls++;
         }
     }
 
@@ -517,18 +827,29 @@ static void renderer_flush_queued_draws(void) {
     renderer_stream_end_frame(&sprite_stream);
     renderer_stream_end_frame(&world_geom_stream);
     renderer_stream_end_frame(&line_stream);
+    renderer_stream_end_frame(&wireframe_stream);
+    renderer_stream_end_frame(&sdf_text_stream);
     renderer_stream_end_frame(&ui_geom_stream);
     renderer_stream_end_frame(&ui_text_vert_stream);
     renderer_stream_end_frame(&ui_text_index_stream);
+    renderer_stream_end_frame(&debug_ui_vert_stream);
+    renderer_stream_end_frame(&debug_ui_index_stream);
+    renderer_stream_end_frame(&ui_block_stream);
     renderer_record_stream_stats();
 
     SDL_GPUCopyPass *const copy_pass = SDL_BeginGPUCopyPass(cmd_buffer);
     renderer_stream_upload_used(copy_pass, &sprite_stream);
     renderer_stream_upload_used(copy_pass, &world_geom_stream);
     renderer_stream_upload_used(copy_pass, &line_stream);
+    renderer_stream_upload_used(copy_pass, &wireframe_stream);
+    renderer_stream_upload_used(copy_pass, &sdf_text_stream);
     renderer_stream_upload_used(copy_pass, &ui_geom_stream);
     renderer_stream_upload_used(copy_pass, &ui_text_vert_stream);
     renderer_stream_upload_used(copy_pass, &ui_text_index_stream);
+    renderer_stream_upload_used(copy_pass, &debug_ui_vert_stream);
+    renderer_stream_upload_used(copy_pass, &debug_ui_index_stream);
+    renderer_ui_blocks_upload(copy_pass);
+    Renderer_TextureLoaderUpload(copy_pass);
     SDL_EndGPUCopyPass(copy_pass);
 
     renderer_draw_world_pass(cmd_buffer);
@@ -646,6 +967,38 @@ bool Renderer_Init(SDL_Window *const window) {
         return false;
     }
 
+    // Same state, sampling a texture array with the layer read from the instance
+    SDL_GPUShader *const layered_sprite_vs = LoadShader(gpu_device,
+                                                  getResourcePath(shader_path, "shaders/sprite.metal"),
+                                                  "vertex_layered",
+                                                  0,
+                                                  1,
+                                                  1,
+                                                  0,
+                                                  SDL_GPU_SHADERSTAGE_VERTEX);
+    SDL_GPUShader *const layered_sprite_fs = LoadShader(gpu_device,
+                                                  getResourcePath(shader_path, "shaders/sprite.metal"),
+                                                  "fragment_layered",
+                                                  1,
+                                                  0,
+                                                  0,
+                                                  0,
+                                                  SDL_GPU_SHADERSTAGE_FRAGMENT);
+    if (!layered_sprite_vs || !layered_sprite_fs) {
+        return false;
+    }
+
+    SDL_GPUGraphicsPipelineCreateInfo layered_sprite_pipe_info = sprite_pipe_info;
+    layered_sprite_pipe_info.vertex_shader = layered_sprite_vs;
+    layered_sprite_pipe_info.fragment_shader = layered_sprite_fs;
+    layered_sprite_pipeline = SDL_CreateGPUGraphicsPipeline(gpu_device, &layered_sprite_pipe_info);
+    SDL_ReleaseGPUShader(gpu_device, layered_sprite_vs);
+    SDL_ReleaseGPUShader(gpu_device, layered_sprite_fs);
+    if (!layered_sprite_pipeline) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create layered sprite pipeline: %s", SDL_GetError());
+        return false;
+    }
+
     SDL_GPUShader *const geo_vs = LoadShader(gpu_device,
                                        getResourcePath(shader_path, "shaders/geometry.metal"),
                                        "vertex_geometry",
@@ -730,7 +1083,7 @@ bool Renderer_Init(SDL_Window *const window) {
                                         getResourcePath(shader_path, "shaders/ui.metal"),
                                         "fragment_line",
                                         0,
-                                        1,
+                                        0,
                                         0,
                                         0,
                                         SDL_GPU_SHADERSTAGE_FRAGMENT);
@@ -740,10 +1093,14 @@ bool Renderer_Init(SDL_Window *const window) {
 
     const SDL_GPUVertexAttribute line_attrs[] = {
         {.location = 0, .buffer_slot = 0, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, .offset = 0},
+        {.location = 1,
+         .buffer_slot = 0,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+         .offset = (Uint32)(sizeof(float) * 3)},
     };
     const SDL_GPUVertexBufferDescription line_binding = {
         .slot = 0,
-        .pitch = (Uint32)(sizeof(float) * 3),
+        .pitch = (Uint32)sizeof(RendererLineVertex),
         .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
         .instance_step_rate = 0,
     };
@@ -753,7 +1110,7 @@ bool Renderer_Init(SDL_Window *const window) {
         .fragment_shader = line_fs,
         .vertex_input_state =
             {
-                .num_vertex_attributes = 1,
+                .num_vertex_attributes = 2,
                 .vertex_attributes = line_attrs,
                 .num_vertex_buffers = 1,
                 .vertex_buffer_descriptions = &line_binding,
@@ -782,6 +1139,101 @@ bool Renderer_Init(SDL_Window *const window) {
         return false;
     }
 
+    SDL_GPUShader *const wireframe_vs = LoadShader(gpu_device,
+                                             getResourcePath(shader_path, "shaders/wireframe.metal"),
+                                             "vertex_wireframe",
+                                             0,
+                                             1,
+                                             1,
+                                             0,
+                                             SDL_GPU_SHADERSTAGE_VERTEX);
+    SDL_GPUShader *const wireframe_fs = LoadShader(gpu_device,
+                                             getResourcePath(shader_path, "shaders/wireframe.metal"),
+                                             "fragment_wireframe",
+                                             0,
+                                             0,
+                                             0,
+                                             0,
+                                             SDL_GPU_SHADERSTAGE_FRAGMENT);
+    if (!wireframe_vs || !wireframe_fs) {
+        return false;
+    }
+
+    const SDL_GPUGraphicsPipelineCreateInfo wireframe_pipe_info = {
+        .vertex_shader = wireframe_vs,
+        .fragment_shader = wireframe_fs,
+        .target_info =
+            {
+                .num_color_targets = 1,
+                .color_target_descriptions = &color_target_desc,
+                .depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D16_UNORM,
+                .has_depth_stencil_target = true,
+            },
+        .depth_stencil_state =
+            {
+                .enable_depth_test = true,
+                .enable_depth_write = true,
+                .compare_op = SDL_GPU_COMPAREOP_LESS_OR_EQUAL,
+            },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+        .multisample_state = {.sample_count = SDL_GPU_SAMPLECOUNT_1},
+        .rasterizer_state = {.cull_mode = SDL_GPU_CULLMODE_NONE},
+    };
+    wireframe_pipeline = SDL_CreateGPUGraphicsPipeline(gpu_device, &wireframe_pipe_info);
+    SDL_ReleaseGPUShader(gpu_device, wireframe_vs);
+    SDL_ReleaseGPUShader(gpu_device, wireframe_fs);
+    if (!wireframe_pipeline) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create wireframe pipeline: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_GPUShader *const sdf_text_vs = LoadShader(gpu_device,
+                                            getResourcePath(shader_path, "shaders/sdf_text.metal"),
+                                            "vertex_sdf_text",
+                                            0,
+                                            1,
+                                            1,
+                                            0,
+                                            SDL_GPU_SHADERSTAGE_VERTEX);
+    SDL_GPUShader *const sdf_text_fs = LoadShader(gpu_device,
+                                            getResourcePath(shader_path, "shaders/sdf_text.metal"),
+                                            "fragment_sdf_text",
+                                            1,
+                                            0,
+                                            0,
+                                            0,
+                                            SDL_GPU_SHADERSTAGE_FRAGMENT);
+    if (!sdf_text_vs || !sdf_text_fs) {
+        return false;
+    }
+
+    const SDL_GPUGraphicsPipelineCreateInfo sdf_text_pipe_info = {
+        .vertex_shader = sdf_text_vs,
+        .fragment_shader = sdf_text_fs,
+        .target_info =
+            {
+                .num_color_targets = 1,
+                .color_target_descriptions = &color_target_desc,
+                .depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D16_UNORM,
+                .has_depth_stencil_target = true,
+            },
+        .depth_stencil_state =
+            {
+                .enable_depth_test = false,
+                .enable_depth_write = false,
+            },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+        .multisample_state = {.sample_count = SDL_GPU_SAMPLECOUNT_1},
+        .rasterizer_state = {.cull_mode = SDL_GPU_CULLMODE_NONE},
+    };
+    sdf_text_pipeline = SDL_CreateGPUGraphicsPipeline(gpu_device, &sdf_text_pipe_info);
+    SDL_ReleaseGPUShader(gpu_device, sdf_text_vs);
+    SDL_ReleaseGPUShader(gpu_device, sdf_text_fs);
+    if (!sdf_text_pipeline) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create SDF text pipeline: %s", SDL_GetError());
+        return false;
+    }
+
     SDL_GPUShader *const text_vs = LoadShader(gpu_device,
                                         getResourcePath(shader_path, "shaders/ui.metal"),
                                         "vertex_text",
@@ -794,7 +1246,7 @@ bool Renderer_Init(SDL_Window *const window) {
                                         getResourcePath(shader_path, "shaders/ui.metal"),
                                         "fragment_text",
                                         1,
-                                        1,
+                                        0,
                                         0,
                                         0,
                                         SDL_GPU_SHADERSTAGE_FRAGMENT);
@@ -808,10 +1260,14 @@ bool Renderer_Init(SDL_Window *const window) {
          .buffer_slot = 0,
          .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
          .offset = (Uint32)(sizeof(float) * 2)},
+        {.location = 2,
+         .buffer_slot = 0,
+         .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+         .offset = (Uint32)(sizeof(float) * 4)},
     };
     SDL_GPUVertexBufferDescription text_binding = {
         .slot = 0,
-        .pitch = (Uint32)(sizeof(float) * 4),
+        .pitch = (Uint32)sizeof(UITextVertex),
         .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
         .instance_step_rate = 0,
     };
@@ -821,7 +1277,7 @@ bool Renderer_Init(SDL_Window *const window) {
         .fragment_shader = text_fs,
         .vertex_input_state =
             {
-                .num_vertex_attributes = 2,
+                .num_vertex_attributes = 3,
                 .vertex_attributes = text_attrs,
                 .num_vertex_buffers = 1,
                 .vertex_buffer_descriptions = &text_binding,
@@ -856,6 +1312,27 @@ bool Renderer_Init(SDL_Window *const window) {
         return false;
     }
 
+    sampler_info.min_filter = SDL_GPU_FILTER_LINEAR;
+    sampler_info.mag_filter = SDL_GPU_FILTER_LINEAR;
+    linear_sampler = SDL_CreateGPUSampler(gpu_device, &sampler_info);
+    if (!linear_sampler) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create linear sampler: %s", SDL_GetError());
+        return false;
+    }
+
+    // Nearest texels within a level never reach past a tile's cell into its neighbour in the sheet, blending between
+    // levels keeps zooming out from popping
+    sampler_info.min_filter = SDL_GPU_FILTER_NEAREST;
+    sampler_info.mag_filter = SDL_GPU_FILTER_NEAREST;
+    sampler_info.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR;
+    sampler_info.max_lod = (float)RENDERER_MAX_MIP_LEVELS;
+    mip_sampler = SDL_CreateGPUSampler(gpu_device, &sampler_info);
+    if (!mip_sampler) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create mipmap sampler: %s", SDL_GetError());
+        return false;
+    }
+    sprite_sampler = sampler;
+
     int w = 1;
     int h = 1;
     SDL_GetWindowSizeInPixels(window, &w, &h);
@@ -875,13 +1352,23 @@ bool Renderer_Init(SDL_Window *const window) {
     if (!renderer_stream_init(&sprite_stream, SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, RENDERER_SPRITE_SLOT_BYTES) ||
         !renderer_stream_init(&world_geom_stream, SDL_GPU_BUFFERUSAGE_VERTEX, RENDERER_WORLD_GEOM_SLOT_BYTES) ||
         !renderer_stream_init(&line_stream, SDL_GPU_BUFFERUSAGE_VERTEX, RENDERER_LINE_SLOT_BYTES) ||
+        !renderer_stream_init(
+            &wireframe_stream, SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, RENDERER_WIREFRAME_SLOT_BYTES) ||
+        !renderer_stream_init(
+            &sdf_text_stream, SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, RENDERER_SDF_TEXT_SLOT_BYTES) ||
         !renderer_stream_init(&ui_geom_stream, SDL_GPU_BUFFERUSAGE_VERTEX, RENDERER_UI_GEOM_SLOT_BYTES) ||
         !renderer_stream_init(&ui_text_vert_stream, SDL_GPU_BUFFERUSAGE_VERTEX, RENDERER_UI_TEXT_VERT_SLOT_BYTES) ||
-        !renderer_stream_init(&ui_text_index_stream, SDL_GPU_BUFFERUSAGE_INDEX, RENDERER_UI_TEXT_INDEX_SLOT_BYTES)) {
+        !renderer_stream_init(&ui_text_index_stream, SDL_GPU_BUFFERUSAGE_INDEX, RENDERER_UI_TEXT_INDEX_SLOT_BYTES) ||
+        !renderer_stream_init(&debug_ui_vert_stream, SDL_GPU_BUFFERUSAGE_VERTEX, RENDERER_DEBUG_UI_VERT_SLOT_BYTES) ||
+        !renderer_stream_init(&debug_ui_index_stream, SDL_GPU_BUFFERUSAGE_INDEX, RENDERER_DEBUG_UI_INDEX_SLOT_BYTES) ||
+        !renderer_stream_init(&ui_block_stream, 0, RENDERER_UI_BLOCK_SLOT_BYTES)) {
         SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to initialize upload streams");
         return false;
     }
 
+    // without loader threads, async loads decode on the calling thread
+    Renderer_TextureLoaderInit();
+
     renderer_reset_queues();
     renderer_reset_frame_stats();
 
@@ -894,12 +1381,25 @@ bool Renderer_Init(SDL_Window *const window) {
 }
 
 void Renderer_Shutdown(void) {
+    Renderer_TextureLoaderShutdown();
     renderer_stream_shutdown(&sprite_stream);
     renderer_stream_shutdown(&world_geom_stream);
     renderer_stream_shutdown(&line_stream);
+    renderer_stream_shutdown(&wireframe_stream);
+    renderer_stream_shutdown(&sdf_text_stream);
     renderer_stream_shutdown(&ui_geom_stream);
     renderer_stream_shutdown(&ui_text_vert_stream);
     renderer_stream_shutdown(&ui_text_index_stream);
+    renderer_stream_shutdown(&debug_ui_vert_stream);
+    renderer_stream_shutdown(&debug_ui_index_stream);
+    renderer_stream_shutdown(&ui_block_stream);
+    for (RendererUIBlock block = 1; block <= RENDERER_MAX_UI_BLOCKS; block++) {
+        Renderer_DestroyUIBlock(block);
+    }
+    renderer_text_ranges_free(&ui_text_ranges);
+    SDL_free(debug_ui_draws);
+    debug_ui_draws = nullptr;
+    debug_ui_draw_capacity = 0;
 
     if (text_engine) {
         TTF_DestroyGPUTextEngine(text_engine);
@@ -911,11 +1411,24 @@ void Renderer_Shutdown(void) {
         SDL_ReleaseGPUSampler(gpu_device, sampler);
         sampler = nullptr;
     }
+    if (linear_sampler) {
+        SDL_ReleaseGPUSampler(gpu_device, linear_sampler);
+        linear_sampler = nullptr;
+    }
+    if (mip_sampler) {
+        SDL_ReleaseGPUSampler(gpu_device, mip_sampler);
+        mip_sampler = nullptr;
+    }
+    sprite_sampler = nullptr;
 
     if (sprite_pipeline) {
         SDL_ReleaseGPUGraphicsPipeline(gpu_device, sprite_pipeline);
         sprite_pipeline = nullptr;
     }
+    if (layered_sprite_pipeline) {
+        SDL_ReleaseGPUGraphicsPipeline(gpu_device, layered_sprite_pipeline);
+        layered_sprite_pipeline = nullptr;
+    }
     if (geometry_pipeline) {
         SDL_ReleaseGPUGraphicsPipeline(gpu_device, geometry_pipeline);
         geometry_pipeline = nullptr;
@@ -924,6 +1437,14 @@ void Renderer_Shutdown(void) {
         SDL_ReleaseGPUGraphicsPipeline(gpu_device, line_pipeline);
         line_pipeline = nullptr;
     }
+    if (wireframe_pipeline) {
+        SDL_ReleaseGPUGraphicsPipeline(gpu_device, wireframe_pipeline);
+        wireframe_pipeline = nullptr;
+    }
+    if (sdf_text_pipeline) {
+        SDL_ReleaseGPUGraphicsPipeline(gpu_device, sdf_text_pipeline);
+        sdf_text_pipeline = nullptr;
+    }
     if (text_pipeline) {
         SDL_ReleaseGPUGraphicsPipeline(gpu_device, text_pipeline);
         text_pipeline = nullptr;
@@ -982,18 +1503,79 @@ SDL_GPUPresentMode Renderer_GetPresentMode(void) {
     return g_present_mode;
 }
 
-SDL_GPUTexture *Renderer_LoadTexture(const char *const path) {
-    SDL_Surface *const surface = IMG_Load(path);
-    if (!surface) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load image %s: %s", path, SDL_GetError());
+bool Renderer_UploadTextureRegion(SDL_GPUCopyPass *const copy_pass,
+                                  SDL_GPUTexture *const texture,
+                                  const Uint32 layer,
+                                  const Uint32 mip_level,
+                                  const SDL_Rect *const region,
+                                  const void *const pixels,
+                                  const int pitch,
+                                  const SDL_GPUTextureFormat format) {
+    if (!copy_pass || !texture || !region || !pixels || region->w <= 0 || region->h <= 0) {
+        return false;
+    }
+
+    const Uint32 row_size = SDL_GPUTextureFormatTexelBlockSize(format) * (Uint32)region->w;
+    const Uint32 upload_size = row_size * (Uint32)region->h;
+    const SDL_GPUTransferBufferCreateInfo transfer_info = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = upload_size,
+    };
+    SDL_GPUTransferBuffer *const transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device, &transfer_info);
+    if (!transfer_buffer) {
+        return false;
+    }
+
+    Uint8 *const map = (Uint8 *)SDL_MapGPUTransferBuffer(gpu_device, transfer_buffer, false);
+    if (!map) {
+        SDL_ReleaseGPUTransferBuffer(gpu_device, transfer_buffer);
+        return false;
+    }
+    for (int y = 0; y < region->h; y++) {
+        const Uint8 *const src = (const Uint8 *)pixels + (size_t)pitch * (size_t)y;
+        SDL_memcpy(map + row_size * (Uint32)y, src, row_size);
+    }
+    SDL_UnmapGPUTransferBuffer(gpu_device, transfer_buffer);
+
+    const SDL_GPUTextureTransferInfo src_info = {
+        .transfer_buffer = transfer_buffer,
+        .offset = 0,
+        .pixels_per_row = (Uint32)region->w,
+        .rows_per_layer = (Uint32)region->h,
+    };
+    const SDL_GPUTextureRegion dst_info = {
+        .texture = texture,
+        .mip_level = mip_level,
+        .layer = layer,
+        .x = (Uint32)region->x,
+        .y = (Uint32)region->y,
+        .w = (Uint32)region->w,
+        .h = (Uint32)region->h,
+        .d = 1,
+    };
+
+    SDL_UploadToGPUTexture(copy_pass, &src_info, &dst_info, false);
+
+    // kept alive by the device until the command buffer that uploads from it completes
+    SDL_ReleaseGPUTransferBuffer(gpu_device, transfer_buffer);
+    return true;
+}
+
+SDL_GPUTexture *Renderer_UploadTexture(SDL_GPUCopyPass *const copy_pass,
+                                      const void *const pixels,
+                                      const int width,
+                                      const int height,
+                                      const int pitch,
+                                      const SDL_GPUTextureFormat format) {
+    if (!copy_pass || !pixels || width <= 0 || height <= 0) {
         return nullptr;
     }
 
     const SDL_GPUTextureCreateInfo tex_info = {
         .type = SDL_GPU_TEXTURETYPE_2D,
-        .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
-        .width = (Uint32)surface->w,
-        .height = (Uint32)surface->h,
+        .format = format,
+        .width = (Uint32)width,
+        .height = (Uint32)height,
         .layer_count_or_depth = 1,
         .num_levels = 1,
         .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
@@ -1001,66 +1583,188 @@ SDL_GPUTexture *Renderer_LoadTexture(const char *const path) {
 
     SDL_GPUTexture *const texture = SDL_CreateGPUTexture(gpu_device, &tex_info);
     if (!texture) {
-        SDL_DestroySurface(surface);
         return nullptr;
     }
 
-    SDL_Surface *const converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
-    if (!converted) {
-        SDL_DestroySurface(surface);
+    const SDL_Rect region = {0, 0, width, height};
+    if (!Renderer_UploadTextureRegion(copy_pass, texture, 0, 0, &region, pixels, pitch, format)) {
         SDL_ReleaseGPUTexture(gpu_device, texture);
         return nullptr;
     }
+    return texture;
+}
 
-    const Uint32 upload_size = (Uint32)(converted->w * converted->h * 4);
-    const SDL_GPUTransferBufferCreateInfo transfer_info = {
-        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-        .size = upload_size,
-    };
-    SDL_GPUTransferBuffer *const transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device, &transfer_info);
-    if (!transfer_buffer) {
-        SDL_DestroySurface(converted);
-        SDL_DestroySurface(surface);
-        SDL_ReleaseGPUTexture(gpu_device, texture);
+SDL_GPUTexture *Renderer_CreateTexture(const void *const pixels,
+                                      const int width,
+                                      const int height,
+                                      const int pitch,
+                                      const SDL_GPUTextureFormat format) {
+    if (!pixels || width <= 0 || height <= 0) {
         return nullptr;
     }
 
-    const Uint8 *const map = (Uint8 *)SDL_MapGPUTransferBuffer(gpu_device, transfer_buffer, true);
-    for (int y = 0; y < converted->h; y++) {
-        const Uint8 *const src = (const Uint8 *)converted->pixels + converted->pitch * y;
-        Uint8 *const dst = map + (Uint32)(y * converted->w * 4);
-        SDL_memcpy(dst, src, (size_t)converted->w * 4U);
-    }
-    SDL_UnmapGPUTransferBuffer(gpu_device, transfer_buffer);
-
     SDL_GPUCommandBuffer *const upload_cmd = SDL_AcquireGPUCommandBuffer(gpu_device);
+    if (!upload_cmd) {
+        return nullptr;
+    }
     SDL_GPUCopyPass *const copy = SDL_BeginGPUCopyPass(upload_cmd);
-
-    const SDL_GPUTextureTransferInfo src_info = {
-        .transfer_buffer = transfer_buffer,
-        .offset = 0,
-        .pixels_per_row = (Uint32)converted->w,
-        .rows_per_layer = (Uint32)converted->h,
-    };
-    const SDL_GPUTextureRegion dst_info = {
-        .texture = texture,
-        .w = (Uint32)converted->w,
-        .h = (Uint32)converted->h,
-        .d = 1,
-    };
-
-    SDL_UploadToGPUTexture(copy, &src_info, &dst_info, false);
+    SDL_GPUTexture *const texture = Renderer_UploadTexture(copy, pixels, width, height, pitch, format);
     SDL_EndGPUCopyPass(copy);
     SDL_SubmitGPUCommandBuffer(upload_cmd);
+    return texture;
+}
 
-    SDL_ReleaseGPUTransferBuffer(gpu_device, transfer_buffer);
-    SDL_DestroySurface(converted);
+SDL_Surface *Renderer_DecodeImage(const char *const path) {
+    // cooked blobs are already in the texture's layout, no decode
+    const char *const extension = path ? SDL_strrchr(path, '.') : nullptr;
+    if (extension && SDL_strcasecmp(extension, COOKED_TEXTURE_EXTENSION) == 0) {
+        return Renderer_MapCookedTexture(path);
+    }
+
+    SDL_Surface *const surface = IMG_Load(path);
+    if (!surface) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load image %s: %s", path, SDL_GetError());
+        return nullptr;
+    }
+
+    SDL_Surface *const converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
     SDL_DestroySurface(surface);
+    return converted;
+}
+
+SDL_GPUTexture *Renderer_LoadTextureMipmapped(
+    const char *const path, const int cell_w, const int cell_h, int *const width, int *const height) {
+    RendererMipChain chain;
+    if (!Renderer_BuildMipChain(Renderer_DecodeImage(path), cell_w, cell_h, &chain)) {
+        return nullptr;
+    }
+
+    SDL_GPUTexture *const texture = Renderer_CreateMipChainTexture(&chain);
+    if (texture && width) {
+        *width = chain.levels[0]->w;
+    }
+    if (texture && height) {
+        *height = chain.levels[0]->h;
+    }
+    Renderer_DestroyMipChain(&chain);
     return texture;
 }
 
+SDL_GPUTexture *Renderer_LoadTextureEx(const char *const path, int *const width, int *const height) {
+    return Renderer_LoadTextureMipmapped(path, 0, 0, width, height);
+}
+
+SDL_GPUTexture *Renderer_LoadTexture(const char *const path) {
+    return Renderer_LoadTextureEx(path, nullptr, nullptr);
+}
+
+SDL_GPUTexture *Renderer_LoadTextureArray(const char *const *const paths,
+                                          const int count,
+                                          const int cell_w,
+                                          const int cell_h,
+                                          int *const width,
+                                          int *const height,
+                                          SDL_Point *const sizes) {
+    MEM_TAG(MEM_TAG_RENDERER);
+    if (!paths || count <= 0) {
+        return nullptr;
+    }
+    RendererMipChain *const chains = SDL_calloc((size_t)count, sizeof(RendererMipChain));
+    if (!chains) {
+        return nullptr;
+    }
+
+    // every layer has to be decoded before the array's size is known, and its levels are the ones all sheets have
+    int layer_w = 0;
+    int layer_h = 0;
+    int levels = RENDERER_MAX_MIP_LEVELS;
+    bool ok = true;
+    for (int i = 0; i < count && ok; i++) {
+        ok = Renderer_BuildMipChain(Renderer_DecodeImage(paths[i]), cell_w, cell_h, &chains[i]);
+        if (ok) {
+            layer_w = SDL_max(layer_w, chains[i].levels[0]->w);
+            layer_h = SDL_max(layer_h, chains[i].levels[0]->h);
+            levels = SDL_min(levels, chains[i].count);
+        }
+    }
+
+    SDL_GPUTexture *texture = nullptr;
+    if (ok) {
+        const SDL_GPUTextureCreateInfo tex_info = {
+            .type = SDL_GPU_TEXTURETYPE_2D_ARRAY,
+            .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+            .width = (Uint32)layer_w,
+            .height = (Uint32)layer_h,
+            .layer_count_or_depth = (Uint32)count,
+            .num_levels = (Uint32)levels,
+            .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        };
+        texture = SDL_CreateGPUTexture(gpu_device, &tex_info);
+        if (!texture) {
+            SDL_LogError(SDL_LOG_CATEGORY_GPU,
+                         "Failed to create %dx%dx%d texture array: %s",
+                         layer_w,
+                         layer_h,
+                         count,
+                         SDL_GetError());
+        }
+    }
+
+    SDL_GPUCommandBuffer *const upload_cmd = texture ? SDL_AcquireGPUCommandBuffer(gpu_device) : nullptr;
+    if (upload_cmd) {
+        // the texels around a smaller sheet are left undefined, its UVs never reach them
+        SDL_GPUCopyPass *const copy = SDL_BeginGPUCopyPass(upload_cmd);
+        for (int i = 0; i < count && ok; i++) {
+            ok = Renderer_UploadMipChainLayer(copy, texture, (Uint32)i, &chains[i], levels);
+            if (sizes) {
+                sizes[i] = (SDL_Point){chains[i].levels[0]->w, chains[i].levels[0]->h};
+            }
+        }
+        SDL_EndGPUCopyPass(copy);
+        SDL_SubmitGPUCommandBuffer(upload_cmd);
+    }
+    ok = ok && upload_cmd;
+
+    for (int i = 0; i < count; i++) {
+        Renderer_DestroyMipChain(&chains[i]);
+    }
+    SDL_free(chains);
+
+    if (ok && texture_array_count >= RENDERER_MAX_TEXTURE_ARRAYS) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Too many texture arrays (max %u)", RENDERER_MAX_TEXTURE_ARRAYS);
+        ok = false;
+    }
+    if (!ok) {
+        Renderer_DestroyTexture(texture);
+        return nullptr;
+    }
+    texture_arrays[texture_array_count++] = texture;
+    if (width) {
+        *width = layer_w;
+    }
+    if (height) {
+        *height = layer_h;
+    }
+    return texture;
+}
+
+static bool renderer_is_texture_array(const SDL_GPUTexture *const texture) {
+    for (Uint32 i = 0; i < texture_array_count; i++) {
+        if (texture_arrays[i] == texture) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Renderer_DestroyTexture(SDL_GPUTexture *const texture) {
     if (texture) {
+        for (Uint32 i = 0; i < texture_array_count; i++) {
+            if (texture_arrays[i] == texture) {
+                texture_arrays[i] = texture_arrays[--texture_array_count];
+                break;
+            }
+        }
         SDL_ReleaseGPUTexture(gpu_device, texture);
     }
 }
@@ -1098,15 +1802,25 @@ void Renderer_BeginFrame(void) {
     if (!renderer_stream_begin_frame(&sprite_stream, current_frame_slot) ||
         !renderer_stream_begin_frame(&world_geom_stream, current_frame_slot) ||
         !renderer_stream_begin_frame(&line_stream, current_frame_slot) ||
+        !renderer_stream_begin_frame(&wireframe_stream, current_frame_slot) ||
+        !renderer_stream_begin_frame(&sdf_text_stream, current_frame_slot) ||
         !renderer_stream_begin_frame(&ui_geom_stream, current_frame_slot) ||
         !renderer_stream_begin_frame(&ui_text_vert_stream, current_frame_slot) ||
-        !renderer_stream_begin_frame(&ui_text_index_stream, current_frame_slot)) {
+        !renderer_stream_begin_frame(&ui_text_index_stream, current_frame_slot) ||
+        !renderer_stream_begin_frame(&debug_ui_vert_stream, current_frame_slot) ||
+        !renderer_stream_begin_frame(&debug_ui_index_stream, current_frame_slot) ||
+        !renderer_stream_begin_frame(&ui_block_stream, current_frame_slot)) {
         renderer_stream_end_frame(&sprite_stream);
         renderer_stream_end_frame(&world_geom_stream);
         renderer_stream_end_frame(&line_stream);
+        renderer_stream_end_frame(&wireframe_stream);
+        renderer_stream_end_frame(&sdf_text_stream);
         renderer_stream_end_frame(&ui_geom_stream);
         renderer_stream_end_frame(&ui_text_vert_stream);
         renderer_stream_end_frame(&ui_text_index_stream);
+        renderer_stream_end_frame(&debug_ui_vert_stream);
+        renderer_stream_end_frame(&debug_ui_index_stream);
+        renderer_stream_end_frame(&ui_block_stream);
         SDL_SubmitGPUCommandBuffer(cmd_buffer);
         cmd_buffer = nullptr;
         swapchain_texture = nullptr;
@@ -1117,8 +1831,18 @@ void Renderer_EndFrame(void) {
     if (!cmd_buffer) {
         return;
     }
+    PROF_ZONE("Renderer_EndFrame");
+    MEM_TAG(MEM_TAG_RENDERER);
 
+    PROF_ZONE_BEGIN("flush_queued_draws");
     renderer_flush_queued_draws();
+    PROF_ZONE_END();
+
+    Uint32 uploaded_bytes = 0;
+    for (int stream = 0; stream < RENDERER_STATS_STREAM_COUNT; stream++) {
+        uploaded_bytes += g_frame_stats.streams[stream].used_bytes;
+    }
+    PROF_counter("bytes_uploaded", uploaded_bytes);
 
     const Uint64 submit_start = SDL_GetPerformanceCounter();
     SDL_SubmitGPUCommandBuffer(cmd_buffer);
@@ -1128,11 +1852,26 @@ void Renderer_EndFrame(void) {
     swapchain_texture = nullptr;
 }
 
+// Sprites are drawn one texel per world unit, so the view projection's scale is the zoom: above one screen pixel per
+// texel the full-size level is all that is read, below it the mip sampler reads levels as small as the sprites are
+static SDL_GPUSampler *renderer_sprite_sampler(const float *const view_projection) {
+    int w = 1;
+    int h = 1;
+    if (render_window) {
+        SDL_GetWindowSizeInPixels(render_window, &w, &h);
+    }
+    const float clip_per_unit = SDL_sqrtf(view_projection[0] * view_projection[0] +
+                                          view_projection[1] * view_projection[1]);
+    const float pixels_per_texel = clip_per_unit * (float)SDL_max(w, 1) * 0.5f;
+    return pixels_per_texel < 1.0f ? mip_sampler : sampler;
+}
+
 void Renderer_SetViewProjection(const float *const viewProjMatrix) {
     if (!viewProjMatrix) {
         return;
     }
     SDL_memcpy(sprite_uniforms.viewProjection, viewProjMatrix, sizeof(float) * 16U);
+    sprite_sampler = renderer_sprite_sampler(viewProjMatrix);
 }
 
 void Renderer_SetWaterParams(const float time, const float speed, const float amplitude, const float phase) {
@@ -1142,27 +1881,40 @@ void Renderer_SetWaterParams(const float time, const float speed, const float am
     sprite_uniforms.waterParams[3] = phase;
 }
 
-void Renderer_DrawSprites(SDL_GPUTexture *const texture, const SpriteInstance *const instances, const int count) {
+// Plain and layered batches share the sprite stream, each aligned to its own stride so the shader can index it from
+// the start of the buffer
+static void renderer_queue_sprites(SDL_GPUTexture *const texture,
+                                   const void *const instances,
+                                   const Uint32 stride,
+                                   const int count,
+                                   const bool layered) {
     if (!texture || !instances || count <= 0 || !cmd_buffer || !swapchain_texture || frame_queues_flushed) {
         return;
     }
+    // the plain pipeline binds a 2D texture and the layered one an array, a mismatch is a GPU validation error
+    if (renderer_is_texture_array(texture) != layered) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER,
+                    "%s",
+                    layered ? "Layered sprites need a texture from Renderer_LoadTextureArray()"
+                            : "Texture arrays must be drawn with Renderer_DrawLayeredSprites()");
+        return;
+    }
 
-    const Uint32 upload_size = (Uint32)(sizeof(SpriteInstance) * (Uint32)count);
+    const Uint32 upload_size = stride * (Uint32)count;
     Uint32 byte_offset = 0;
-    if (!renderer_stream_write(&sprite_stream,
-                               instances,
-                               upload_size,
-                               SDL_max((Uint32)sizeof(SpriteInstance), RENDERER_STREAM_ALIGN),
-                               &byte_offset)) {
+    if (!renderer_stream_write(
+            &sprite_stream, instances, upload_size, SDL_max(stride, RENDERER_STREAM_ALIGN), &byte_offset)) {
         return;
     }
 
-    const Uint32 instance_base = (byte_offset - sprite_stream.slot_base) / (Uint32)sizeof(SpriteInstance);
+    // The storage buffer is bound from its start, so the index is relative to the buffer, not the frame slot
+    const Uint32 instance_base = byte_offset / stride;
 
     SpriteCmd *cmd = nullptr;
     if (sprite_cmd_count > 0) {
         SpriteCmd *last = &sprite_cmds[sprite_cmd_count - 1U];
-        if (last->texture == texture && SDL_memcmp(&last->uniforms, &sprite_uniforms, sizeof(SpriteUniforms)) == 0 &&
+        if (last->texture == texture && last->layered == layered && last->sampler == sprite_sampler &&
+            SDL_memcmp(&last->uniforms, &sprite_uniforms, sizeof(SpriteUniforms)) == 0 &&
             last->first_instance + last->instance_count == instance_base) {
             last->instance_count += (Uint32)count;
             cmd = last;
@@ -1179,31 +1931,169 @@ void Renderer_DrawSprites(SDL_GPUTexture *const texture, const SpriteInstance *c
         cmd->first_instance = instance_base;
         cmd->instance_count = (Uint32)count;
         cmd->uniforms = sprite_uniforms;
+        cmd->sampler = sprite_sampler;
+        cmd->layered = layered;
     }
 
     g_frame_stats.queues[RENDERER_STATS_QUEUE_SPRITE].cmd_count = sprite_cmd_count;
 }
 
-void Renderer_DrawLine(const float x1, const float y1, const float z1, const float x2, const float y2, const float z2,
-                       const SDL_FColor color) {
-    if (!cmd_buffer || !swapchain_texture || frame_queues_flushed || line_cmd_count >= RENDERER_MAX_LINE_CMDS) {
+void Renderer_DrawSprites(SDL_GPUTexture *const texture, const SpriteInstance *const instances, const int count) {
+    renderer_queue_sprites(texture, instances, (Uint32)sizeof(SpriteInstance), count, false);
+}
+
+void Renderer_DrawLayeredSprites(SDL_GPUTexture *const texture_array,
+                                 const SpriteLayerInstance *const instances,
+                                 const int count) {
+    renderer_queue_sprites(texture_array, instances, (Uint32)sizeof(SpriteLayerInstance), count, true);
+}
+
+static Uint8 renderer_color_byte(const float channel) {
+    const float clamped = channel < 0.0f ? 0.0f : (channel > 1.0f ? 1.0f : channel);
+    return (Uint8)(clamped * 255.0f + 0.5f);
+}
+
+RendererLineVertex Renderer_LineVertex(const float x, const float y, const float z, const SDL_FColor color) {
+    return (RendererLineVertex){
+        .x = x,
+        .y = y,
+        .z = z,
+        .r = renderer_color_byte(color.r),
+        .g = renderer_color_byte(color.g),
+        .b = renderer_color_byte(color.b),
+        .a = renderer_color_byte(color.a),
+    };
+}
+
+void Renderer_DrawLines(const RendererLineVertex *const vertices, const int vertex_count) {
+    if (!vertices || vertex_count < 2 || !cmd_buffer || !swapchain_texture || frame_queues_flushed) {
         return;
     }
 
-    const float vertices[6] = {x1, y1, z1, x2, y2, z2};
+    const Uint32 count = (Uint32)vertex_count & ~1U; // whole segments only
+    const Uint32 size = count * (Uint32)sizeof(RendererLineVertex);
     Uint32 byte_offset = 0;
-    if (!renderer_stream_write(&line_stream, vertices, sizeof(vertices), RENDERER_STREAM_ALIGN, &byte_offset)) {
+    if (!renderer_stream_write(&line_stream, vertices, size, (Uint32)sizeof(RendererLineVertex), &byte_offset)) {
+        return;
+    }
+
+    // Extend the previous batch when it ends right where this one starts under the same matrix
+    if (line_cmd_count > 0) {
+        LineCmd *const last = &line_cmds[line_cmd_count - 1U];
+        if (last->vertex_offset + last->vertex_count * (Uint32)sizeof(RendererLineVertex) == byte_offset &&
+            SDL_memcmp(last->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U) == 0) {
+            last->vertex_count += count;
+            return;
+        }
+    }
+    if (line_cmd_count >= RENDERER_MAX_LINE_CMDS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "Line command queue overflow");
         return;
     }
 
     LineCmd *cmd = &line_cmds[line_cmd_count++];
     cmd->vertex_offset = byte_offset;
-    cmd->color = color;
+    cmd->vertex_count = count;
     SDL_memcpy(cmd->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U);
 
     g_frame_stats.queues[RENDERER_STATS_QUEUE_LINE].cmd_count = line_cmd_count;
 }
 
+void Renderer_DrawLine(const float x1, const float y1, const float z1, const float x2, const float y2, const float z2,
+                       const SDL_FColor color) {
+    const RendererLineVertex vertices[2] = {
+        Renderer_LineVertex(x1, y1, z1, color),
+        Renderer_LineVertex(x2, y2, z2, color),
+    };
+    Renderer_DrawLines(vertices, 2);
+}
+
+void Renderer_DrawWireframes(const RendererWireframeInstance *const instances, const int count) {
+    if (!instances || count <= 0 || !cmd_buffer || !swapchain_texture || frame_queues_flushed) {
+        return;
+    }
+
+    // every segment of the largest box, the limit only guards against garbage sizes
+    float largest = 0.0f;
+    for (int i = 0; i < count; i++) {
+        const RendererWireframeInstance *const box = &instances[i];
+        largest = SDL_max(largest, box->width + box->length + box->levels);
+    }
+    Uint32 segment_count = RENDERER_WIREFRAME_MAX_SEGMENTS;
+    if (largest <= (float)((RENDERER_WIREFRAME_MAX_SEGMENTS - 3U) / 2U)) {
+        segment_count = 2U * (Uint32)SDL_ceilf(largest) + 3U;
+    } else {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER,
+                    "Wireframe box of %.0f tiles and levels clamped to %u segments",
+                    (double)largest,
+                    RENDERER_WIREFRAME_MAX_SEGMENTS);
+    }
+
+    const Uint32 size = (Uint32)count * (Uint32)sizeof(RendererWireframeInstance);
+    Uint32 byte_offset = 0;
+    if (!renderer_stream_write(
+            &wireframe_stream, instances, size, (Uint32)sizeof(RendererWireframeInstance), &byte_offset)) {
+        return;
+    }
+    const Uint32 first_instance = byte_offset / (Uint32)sizeof(RendererWireframeInstance);
+
+    if (wireframe_cmd_count > 0) {
+        WireframeCmd *const last = &wireframe_cmds[wireframe_cmd_count - 1U];
+        if (last->first_instance + last->instance_count == first_instance &&
+            SDL_memcmp(last->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U) == 0) {
+            last->instance_count += (Uint32)count;
+            last->segment_count = SDL_max(last->segment_count, segment_count);
+            return;
+        }
+    }
+    if (wireframe_cmd_count >= RENDERER_MAX_WIREFRAME_CMDS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "Wireframe command queue overflow");
+        return;
+    }
+
+    WireframeCmd *cmd = &wireframe_cmds[wireframe_cmd_count++];
+    cmd->first_instance = first_instance;
+    cmd->instance_count = (Uint32)count;
+    cmd->segment_count = segment_count;
+    SDL_memcpy(cmd->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U);
+
+    g_frame_stats.queues[RENDERER_STATS_QUEUE_WIREFRAME].cmd_count = wireframe_cmd_count;
+}
+
+void Renderer_DrawSDFGlyphs(SDL_GPUTexture *const atlas, const RendererSDFGlyph *const glyphs, const int count) {
+    if (!atlas || !glyphs || count <= 0 || !cmd_buffer || !swapchain_texture || frame_queues_flushed) {
+        return;
+    }
+
+    const Uint32 size = (Uint32)count * (Uint32)sizeof(RendererSDFGlyph);
+    Uint32 byte_offset = 0;
+    if (!renderer_stream_write(&sdf_text_stream, glyphs, size, (Uint32)sizeof(RendererSDFGlyph), &byte_offset)) {
+        return;
+    }
+    const Uint32 first_instance = byte_offset / (Uint32)sizeof(RendererSDFGlyph);
+
+    if (sdf_text_cmd_count > 0) {
+        SDFTextCmd *const last = &sdf_text_cmds[sdf_text_cmd_count - 1U];
+        if (last->atlas == atlas && last->first_instance + last->instance_count == first_instance &&
+            SDL_memcmp(last->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U) == 0) {
+            last->instance_count += (Uint32)count;
+            return;
+        }
+    }
+    if (sdf_text_cmd_count >= RENDERER_MAX_SDF_TEXT_CMDS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "SDF text command queue overflow");
+        return;
+    }
+
+    SDFTextCmd *cmd = &sdf_text_cmds[sdf_text_cmd_count++];
+    cmd->atlas = atlas;
+    cmd->first_instance = first_instance;
+    cmd->instance_count = (Uint32)count;
+    SDL_memcpy(cmd->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U);
+
+    g_frame_stats.queues[RENDERER_STATS_QUEUE_SDF_TEXT].cmd_count = sdf_text_cmd_count;
+}
+
 void Renderer_DrawGeometry(const SDL_Vertex *const vertices, const int count) {
     if (!vertices || count <= 0 || !cmd_buffer || !swapchain_texture || frame_queues_flushed) {
         return;
@@ -1224,7 +2114,7 @@ void Renderer_DrawGeometry(const SDL_Vertex *const vertices, const int count) {
     cmd->vertex_count = (Uint32)count;
     SDL_memcpy(cmd->matrix, sprite_uniforms.viewProjection, sizeof(float) * 16U);
 
-    g_frame_stats.queues[RENDERER_STATS_QUEUE_WORLD_GEOMETRY].cmd_count = world_geom_cmd_count;
+    g_frame_stats.queues[RENDERER_STATS_QUEUE_WORLD_GEOMETRY].cmd_count++;
 }
 
 void Renderer_DrawGeometryScreenSpace(const SDL_Vertex *vertices, const int count) {
@@ -1247,7 +2137,7 @@ void Renderer_DrawText(TTF_Text *text, const float x, const float y) {
             continue;
         }
 
-        const Uint32 vert_bytes = (Uint32)(sizeof(float) * 4U * (Uint32)seq->num_vertices);
+        const Uint32 vert_bytes = (Uint32)(sizeof(UITextVertex) * (Uint32)seq->num_vertices);
         const Uint32 idx_bytes = (Uint32)(sizeof(int) * (Uint32)seq->num_indices);
 
         Uint32 vert_offset = 0;
@@ -1255,12 +2145,10 @@ void Renderer_DrawText(TTF_Text *text, const float x, const float y) {
             return;
         }
 
-        float *const dst = (float *)(ui_text_vert_stream.mapped + vert_offset);
+        UITextVertex *const dst = (UITextVertex *)(ui_text_vert_stream.mapped + vert_offset);
         for (int i = 0; i < seq->num_vertices; i++) {
-            dst[i * 4 + 0] = seq->xy[i].x + x;
-            dst[i * 4 + 1] = -seq->xy[i].y + y;
-            dst[i * 4 + 2] = seq->uv[i].x;
-            dst[i * 4 + 3] = seq->uv[i].y;
+            dst[i] = (UITextVertex){
+                seq->xy[i].x + x, -seq->xy[i].y + y, seq->uv[i].x, seq->uv[i].y, 255, 255, 255, 255};
         }
 
         Uint32 idx_offset = 0;
@@ -1273,17 +2161,19 @@ void Renderer_DrawText(TTF_Text *text, const float x, const float y) {
             return;
         }
 
+        const Uint32 first_range = ui_text_ranges.count;
+        const UITextAtlasInfo atlas = {.atlas = seq->atlas_texture, .start_index = 0, .index_count = seq->num_indices};
+        if (!renderer_text_ranges_append(&ui_text_ranges, first_range, &atlas, 1)) {
+            return;
+        }
+
         UITextCmd *cmd = &ui_text_cmds[ui_text_cmd_count++];
         cmd->vertex_offset = vert_offset;
         cmd->index_offset = idx_offset;
         cmd->vertex_count = (Uint32)seq->num_vertices;
         cmd->index_count = (Uint32)seq->num_indices;
-        cmd->range_count = 1;
-        cmd->ranges[0] = (UITextRangeCmd){
-            .atlas = seq->atlas_texture,
-            .start_index = 0,
-            .index_count = (Uint32)seq->num_indices,
-        };
+        cmd->first_range = first_range;
+        cmd->range_count = ui_text_ranges.count - first_range;
 
         seq = seq->next;
     }
@@ -1314,7 +2204,7 @@ void Renderer_FlushUIGeometry(const SDL_Vertex *vertices, const int count) {
     g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_GEOMETRY].cmd_count = ui_geom_cmd_count;
 }
 
-void Renderer_FlushUIText(const float *const restrict vertices,
+void Renderer_FlushUIText(const UITextVertex *const restrict vertices,
                           const int vertex_count,
                           const int *const restrict indices,
                           const int index_count,
@@ -1331,7 +2221,7 @@ void Renderer_FlushUIText(const float *const restrict vertices,
         return;
     }
 
-    const Uint32 vert_bytes = (Uint32)(sizeof(float) * 4U * (Uint32)vertex_count);
+    const Uint32 vert_bytes = (Uint32)(sizeof(UITextVertex) * (Uint32)vertex_count);
     const Uint32 idx_bytes = (Uint32)(sizeof(int) * (Uint32)index_count);
 
     Uint32 vert_offset = 0;
@@ -1344,36 +2234,153 @@ void Renderer_FlushUIText(const float *const restrict vertices,
         return;
     }
 
+    const Uint32 first_range = ui_text_ranges.count;
+    if (!renderer_text_ranges_append(&ui_text_ranges, first_range, atlases, atlas_count)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "UI text ranges allocation failed");
+        ui_text_ranges.count = first_range;
+        return;
+    }
+
     UITextCmd *cmd = &ui_text_cmds[ui_text_cmd_count++];
     cmd->vertex_offset = vert_offset;
     cmd->index_offset = idx_offset;
     cmd->vertex_count = (Uint32)vertex_count;
     cmd->index_count = (Uint32)index_count;
+    cmd->first_range = first_range;
+    cmd->range_count = ui_text_ranges.count - first_range;
 
-    Uint32 ranges_written = 0;
-    for (int i = 0; i < atlas_count && ranges_written < RENDERER_MAX_UI_TEXT_RANGES; i++) {
-        if (!atlases[i].atlas || atlases[i].index_count <= 0) {
-            continue;
+    g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_TEXT].cmd_count = ui_text_cmd_count;
+}
+
+RendererUIBlock Renderer_CreateUIBlock(void) {
+    for (Uint32 i = 0; i < RENDERER_MAX_UI_BLOCKS; i++) {
+        if (!ui_blocks[i].live) {
+            ui_blocks[i] = (UIBlock){.live = true};
+            return i + 1U;
         }
+    }
+    SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "UI block table full (%u)", RENDERER_MAX_UI_BLOCKS);
+    return 0;
+}
 
-        cmd->ranges[ranges_written++] = (UITextRangeCmd){
-            .atlas = atlases[i].atlas,
-            .start_index = (Uint32)atlases[i].start_index,
-            .index_count = (Uint32)atlases[i].index_count,
+void Renderer_DestroyUIBlock(const RendererUIBlock block) {
+    if (block == 0 || block > RENDERER_MAX_UI_BLOCKS || !ui_blocks[block - 1U].live) {
+        return;
+    }
+    UIBlock *const b = &ui_blocks[block - 1U];
+    if (b->buffer) {
+        SDL_ReleaseGPUBuffer(gpu_device, b->buffer);
+    }
+    renderer_text_ranges_free(&b->ranges);
+    *b = (UIBlock){0};
+}
+
+bool Renderer_UpdateUIBlock(const RendererUIBlock block,
+                            const SDL_Vertex *const geometry,
+                            const int geometry_count,
+                            const UITextVertex *const text_vertices,
+                            const int text_vertex_count,
+                            const int *const text_indices,
+                            const int text_index_count,
+                            const UITextAtlasInfo *const atlases,
+                            const int atlas_count) {
+    if (block == 0 || block > RENDERER_MAX_UI_BLOCKS || !ui_blocks[block - 1U].live) {
+        return false;
+    }
+    // staged in this frame's slot of ui_block_stream, so only while the frame is recording
+    if (!cmd_buffer || !swapchain_texture || frame_queues_flushed) {
+        return false;
+    }
+    UIBlock *const b = &ui_blocks[block - 1U];
+    b->geometry_count = 0;
+    b->index_count = 0;
+    b->ranges.count = 0;
+
+    const bool has_geometry = geometry && geometry_count > 0;
+    const bool has_text = text_vertices && text_indices && text_vertex_count > 0 && text_index_count > 0;
+    const Uint32 geometry_bytes = has_geometry ? (Uint32)(sizeof(SDL_Vertex) * (Uint32)geometry_count) : 0U;
+    const Uint32 text_bytes = has_text ? (Uint32)(sizeof(UITextVertex) * (Uint32)text_vertex_count) : 0U;
+    const Uint32 index_bytes = has_text ? (Uint32)(sizeof(int) * (Uint32)text_index_count) : 0U;
+    const Uint32 text_offset = renderer_align_up(geometry_bytes, RENDERER_STREAM_ALIGN);
+    const Uint32 index_offset = renderer_align_up(text_offset + text_bytes, RENDERER_STREAM_ALIGN);
+    const Uint32 size = index_offset + index_bytes;
+    if (size == 0) {
+        return true;
+    }
+
+    if (b->capacity < size) {
+        if (b->buffer) {
+            SDL_ReleaseGPUBuffer(gpu_device, b->buffer);
+        }
+        Uint32 capacity = 4096U;
+        while (capacity < size) {
+            capacity *= 2U;
+        }
+        const SDL_GPUBufferCreateInfo buffer_info = {
+            .usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_INDEX,
+            .size = capacity,
         };
+        b->buffer = SDL_CreateGPUBuffer(gpu_device, &buffer_info);
+        b->capacity = b->buffer ? capacity : 0U;
+        if (!b->buffer) {
+            SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create UI block buffer: %s", SDL_GetError());
+            return false;
+        }
     }
-    cmd->range_count = ranges_written;
 
-    g_frame_stats.queues[RENDERER_STATS_QUEUE_UI_TEXT].cmd_count = ui_text_cmd_count;
+    // updated twice before a flush, the latest staging replaces the earlier one
+    Uint32 staged = 0;
+    if (!renderer_stream_alloc(&ui_block_stream, size, RENDERER_STREAM_ALIGN, &staged)) {
+        b->pending = false;
+        return false;
+    }
+    uint8_t *const mapped = ui_block_stream.mapped + staged;
+    if (has_geometry) {
+        SDL_memcpy(mapped, geometry, geometry_bytes);
+    }
+    if (has_text) {
+        SDL_memcpy(mapped + text_offset, text_vertices, text_bytes);
+        SDL_memcpy(mapped + index_offset, text_indices, index_bytes);
+    }
+    b->pending = true;
+    b->pending_offset = staged;
+    b->pending_size = size;
+
+    b->geometry_count = has_geometry ? (Uint32)geometry_count : 0U;
+    b->text_vertex_offset = text_offset;
+    b->index_offset = index_offset;
+    b->index_count = has_text ? (Uint32)text_index_count : 0U;
+    if (has_text && !renderer_text_ranges_append(&b->ranges, 0, atlases, atlas_count)) {
+        b->ranges.count = 0;
+        return false;
+    }
+    return true;
+}
+
+void Renderer_DrawUIBlock(const RendererUIBlock block) {
+    if (block == 0 || block > RENDERER_MAX_UI_BLOCKS || !ui_blocks[block - 1U].live || !ui_blocks[block - 1U].buffer) {
+        return;
+    }
+    if (!cmd_buffer || !swapchain_texture || frame_queues_flushed || ui_block_draw_count >= RENDERER_MAX_UI_BLOCKS) {
+        return;
+    }
+    ui_block_draws[ui_block_draw_count++] = (UIBlockDraw){
+        .block = block,
+        .geom_cmd_mark = ui_geom_cmd_count,
+        .text_cmd_mark = ui_text_cmd_count,
+    };
 }
 
 void Renderer_DrawTextureDebug(SDL_GPUTexture *texture, const float x, const float y, const float width, const float height) {
-    if (!texture || width <= 0.0f || height <= 0.0f) {
+    if (!texture || width <= 0.0f || height <= 0.0f || renderer_is_texture_array(texture)) {
         return;
     }
 
-    const float vertices[16] = {
-        x, y, 0.0f, 0.0f, x + width, y, 1.0f, 0.0f, x + width, y + height, 1.0f, 1.0f, x, y + height, 0.0f, 1.0f,
+    const UITextVertex vertices[4] = {
+        {x, y, 0.0f, 0.0f, 255, 255, 255, 255},
+        {x + width, y, 1.0f, 0.0f, 255, 255, 255, 255},
+        {x + width, y + height, 1.0f, 1.0f, 255, 255, 255, 255},
+        {x, y + height, 0.0f, 1.0f, 255, 255, 255, 255},
     };
     const int indices[6] = {0, 1, 2, 0, 2, 3};
     const UITextAtlasInfo atlas = {
@@ -1400,6 +2407,42 @@ const RendererFrameStats *Renderer_GetFrameStats(void) {
     return &g_frame_stats;
 }
 
+static const char *const renderer_stats_queue_names[] = {[RENDERER_STATS_QUEUE_SPRITE] = "sprite",
+                                                         [RENDERER_STATS_QUEUE_WORLD_GEOMETRY] = "world_geometry",
+                                                         [RENDERER_STATS_QUEUE_LINE] = "line",
+                                                         [RENDERER_STATS_QUEUE_WIREFRAME] = "wireframe",
+                                                         [RENDERER_STATS_QUEUE_SDF_TEXT] = "sdf_text",
+                                                         [RENDERER_STATS_QUEUE_UI_GEOMETRY] = "ui_geometry",
+                                                         [RENDERER_STATS_QUEUE_UI_TEXT] = "ui_text",
+                                                         [RENDERER_STATS_QUEUE_DEBUG_UI] = "debug_ui"};
+static_assert(sizeof(renderer_stats_queue_names) / sizeof(renderer_stats_queue_names[0]) ==
+                  RENDERER_STATS_QUEUE_COUNT,
+              SDL_FILE ": All renderer queues must have a stats name.");
+
+static const char *const renderer_stats_stream_names[] = {
+    [RENDERER_STATS_STREAM_SPRITE] = "sprite",
+    [RENDERER_STATS_STREAM_WORLD_GEOMETRY] = "world_geometry",
+    [RENDERER_STATS_STREAM_LINE] = "line",
+    [RENDERER_STATS_STREAM_WIREFRAME] = "wireframe",
+    [RENDERER_STATS_STREAM_SDF_TEXT] = "sdf_text",
+    [RENDERER_STATS_STREAM_UI_GEOMETRY] = "ui_geometry",
+    [RENDERER_STATS_STREAM_UI_TEXT_VERT] = "ui_text_vert",
+    [RENDERER_STATS_STREAM_UI_TEXT_INDEX] = "ui_text_index",
+    [RENDERER_STATS_STREAM_DEBUG_UI_VERT] = "debug_ui_vert",
+    [RENDERER_STATS_STREAM_DEBUG_UI_INDEX] = "debug_ui_index",
+    [RENDERER_STATS_STREAM_UI_BLOCK] = "ui_block"};
+static_assert(sizeof(renderer_stats_stream_names) / sizeof(renderer_stats_stream_names[0]) ==
+                  RENDERER_STATS_STREAM_COUNT,
+              SDL_FILE ": All renderer streams must have a stats name.");
+
+const char *Renderer_GetStatsQueueName(const RendererStatsQueueKind queue) {
+    return queue < RENDERER_STATS_QUEUE_COUNT ? renderer_stats_queue_names[queue] : "unknown";
+}
+
+const char *Renderer_GetStatsStreamName(const RendererStatsStreamKind stream) {
+    return stream < RENDERER_STATS_STREAM_COUNT ? renderer_stats_stream_names[stream] : "unknown";
+}
+
 SDL_Window *Renderer_GetWindow(void) {
     return render_window;
 }
@@ -1408,18 +2451,58 @@ SDL_GPUDevice *Renderer_GetDevice(void) {
     return gpu_device;
 }
 
-SDL_GPUCommandBuffer *Renderer_GetCommandBuffer(void) {
-    return cmd_buffer;
-}
+bool Renderer_QueueDebugUI(SDL_GPUGraphicsPipeline *const pipeline,
+                           SDL_GPUSampler *const ui_sampler,
+                           const void *const restrict vertices,
+                           const Uint32 vertex_bytes,
+                           const void *const restrict indices,
+                           const Uint32 index_bytes,
+                           const SDL_GPUIndexElementSize index_size,
+                           const RendererDebugUIDraw *const restrict draws,
+                           const Uint32 draw_count) {
+    if (!pipeline || !ui_sampler || !vertices || !indices || vertex_bytes == 0 || index_bytes == 0 || draw_count == 0) {
+        return false;
+    }
+    if (!cmd_buffer || !swapchain_texture || frame_queues_flushed) {
+        return false;
+    }
+    if (debug_ui_cmd_count >= RENDERER_MAX_DEBUG_UI_CMDS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "Debug UI command queue overflow");
+        return false;
+    }
+    if (draw_count > debug_ui_draw_capacity - debug_ui_draw_count) {
+        Uint32 capacity = debug_ui_draw_capacity ? debug_ui_draw_capacity : RENDERER_DEBUG_UI_DRAWS_INITIAL;
+        while (capacity - debug_ui_draw_count < draw_count) {
+            capacity *= 2U;
+        }
+        RendererDebugUIDraw *const grown = SDL_realloc(debug_ui_draws, sizeof(RendererDebugUIDraw) * capacity);
+        if (!grown) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_RENDER, "Out of memory queueing %u debug UI draws", draw_count);
+            return false;
+        }
+        debug_ui_draws = grown;
+        debug_ui_draw_capacity = capacity;
+    }
 
-SDL_GPUTexture *Renderer_GetSwapchainTexture(void) {
-    return swapchain_texture;
-}
+    Uint32 vertex_offset = 0;
+    Uint32 index_offset = 0;
+    if (!renderer_stream_write(&debug_ui_vert_stream, vertices, vertex_bytes, RENDERER_STREAM_ALIGN, &vertex_offset) ||
+        !renderer_stream_write(&debug_ui_index_stream, indices, index_bytes, RENDERER_STREAM_ALIGN, &index_offset)) {
+        return false;
+    }
 
-void Renderer_EndRenderPass(void) {
-    renderer_flush_queued_draws();
-}
+    SDL_memcpy(&debug_ui_draws[debug_ui_draw_count], draws, sizeof(*draws) * draw_count);
+    debug_ui_cmds[debug_ui_cmd_count++] = (DebugUICmd){
+        .pipeline = pipeline,
+        .sampler = ui_sampler,
+        .vertex_offset = vertex_offset,
+        .index_offset = index_offset,
+        .index_size = index_size,
+        .first_draw = debug_ui_draw_count,
+        .draw_count = draw_count,
+    };
+    debug_ui_draw_count += draw_count;
 
-void Renderer_ResumeRenderPass(void) {
-    // No-op with queued renderer architecture.
+    g_frame_stats.queues[RENDERER_STATS_QUEUE_DEBUG_UI].cmd_count = debug_ui_cmd_count;
+    return true;
 }
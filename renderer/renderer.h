@@ -9,6 +9,9 @@
 
 const char *getResourcePath(char *string, const char *relative_path);
 
+// Assets made by the build (cook_assets) live in cooked/ next to the executable, or in the bundle's Resources on macOS
+const char *getCookedAssetPath(char *string, const char *relative_path);
+
 /**
  * @brief Sprite instance data for GPU-batched rendering.
  *
@@ -26,12 +29,61 @@ typedef struct {
     float u, v, uw, vh;   ///< UV coordinates in texture atlas (u, v, width, height)
 } SpriteInstance;
 
+/**
+ * @brief Sprite instance drawn from a 2D texture array, 64 bytes. Must match LayeredInstanceData in sprite.metal.
+ *
+ * Sprites from different sheets of the same array share a draw call, the layer picks the sheet.
+ *
+ * @see Renderer_LoadTextureArray() and Renderer_DrawLayeredSprites().
+ */
+typedef struct {
+    SpriteInstance sprite; ///< UVs are relative to the array's layer size, not the sheet's
+    float layer;           ///< Array layer of the sheet, a whole number
+    float padding[3];
+} SpriteLayerInstance;
+
+/**
+ * @brief Line vertex with its own color, 16 bytes. Must match LineVertexInput in ui.metal.
+ */
+typedef struct {
+    float x, y, z;
+    Uint8 r, g, b, a;
+} RendererLineVertex;
+
+/**
+ * @brief One box wireframe, expanded into its edges and tile grid by the vertex shader. 32 bytes, must match
+ * WireframeInstance in wireframe.metal.
+ */
+typedef struct {
+    float x, y;                  ///< Ground-level left corner of the footprint, in world units
+    float tile_w, tile_h;        ///< Isometric tile size (tile_h is half the tile sprite height)
+    float width, length, levels; ///< Footprint in tiles along the width and length axes, height in levels
+    Uint32 color;                ///< RGBA8, red in the lowest byte
+} RendererWireframeInstance;
+
+/**
+ * @brief One glyph quad of a signed distance field atlas, 32 bytes. Must match GlyphInstance in sdf_text.metal.
+ *
+ * The atlas stores distances instead of coverage, so a glyph baked once stays sharp at any zoom. See sdf_text.h for
+ * baking fonts and laying out labels.
+ */
+typedef struct {
+    float x, y;          ///< Top-left corner in world units
+    float w, h;          ///< Quad size in world units
+    Uint16 u, v, uw, vh; ///< Atlas rectangle, normalized to 0-65535
+    Uint32 color;        ///< RGBA8, red in the lowest byte
+    float bias;          ///< Added to the sampled distance, 0 draws the baked outline, positive values embolden
+} RendererSDFGlyph;
+
 typedef enum RendererStatsQueueKind {
     RENDERER_STATS_QUEUE_SPRITE = 0,
     RENDERER_STATS_QUEUE_WORLD_GEOMETRY,
     RENDERER_STATS_QUEUE_LINE,
+    RENDERER_STATS_QUEUE_WIREFRAME,
+    RENDERER_STATS_QUEUE_SDF_TEXT,
     RENDERER_STATS_QUEUE_UI_GEOMETRY,
     RENDERER_STATS_QUEUE_UI_TEXT,
+    RENDERER_STATS_QUEUE_DEBUG_UI,
     RENDERER_STATS_QUEUE_COUNT
 } RendererStatsQueueKind;
 
@@ -39,9 +91,14 @@ typedef enum RendererStatsStreamKind {
     RENDERER_STATS_STREAM_SPRITE = 0,
     RENDERER_STATS_STREAM_WORLD_GEOMETRY,
     RENDERER_STATS_STREAM_LINE,
+    RENDERER_STATS_STREAM_WIREFRAME,
+    RENDERER_STATS_STREAM_SDF_TEXT,
     RENDERER_STATS_STREAM_UI_GEOMETRY,
     RENDERER_STATS_STREAM_UI_TEXT_VERT,
     RENDERER_STATS_STREAM_UI_TEXT_INDEX,
+    RENDERER_STATS_STREAM_DEBUG_UI_VERT,
+    RENDERER_STATS_STREAM_DEBUG_UI_INDEX,
+    RENDERER_STATS_STREAM_UI_BLOCK,
     RENDERER_STATS_STREAM_COUNT
 } RendererStatsStreamKind;
 
@@ -84,6 +141,77 @@ void Renderer_SetVSync(bool enabled);
 // For simplicity, we'll return the SDL_GPUTexture* directly for now,
 // but in a real engine you'd want a resource handle.
 SDL_GPUTexture *Renderer_LoadTexture(const char *path);
+
+// Same as Renderer_LoadTexture, also returning the image size from the same decode (either pointer may be nullptr)
+SDL_GPUTexture *Renderer_LoadTextureEx(const char *path, int *width, int *height);
+
+/**
+ * @brief Same as Renderer_LoadTextureEx, with a mip chain for drawing the image zoomed out.
+ *
+ * Each level is box filtered from the one above within `cell_w` x `cell_h` cells (a tileset's tiles), so a tile never
+ * picks up its neighbours in the sheet. Levels stop once a cell side turns odd; 0 or a size that does not divide the
+ * image gives a single level.
+ */
+SDL_GPUTexture *Renderer_LoadTextureMipmapped(const char *path, int cell_w, int cell_h, int *width, int *height);
+
+/**
+ * @brief Handle to a texture loading in the background, 0 is never a valid load.
+ *
+ * The image is decoded and converted on a loader thread and its upload is recorded in the copy pass of the next flushed
+ * frame, so loads overlap with each other and with the caller instead of blocking it on I/O, decode and a submit.
+ * A handle stops resolving once its load is released, even after its slot is reused by another load.
+ */
+typedef Uint32 RendererTextureLoad;
+
+typedef enum {
+    RENDERER_TEXTURE_LOAD_PENDING,
+    RENDERER_TEXTURE_LOAD_READY,
+    RENDERER_TEXTURE_LOAD_FAILED,
+} RendererTextureLoadStatus;
+
+// Starts loading `path`, returns 0 if the load table is full
+RendererTextureLoad Renderer_LoadTextureAsync(const char *path);
+
+// Renderer_LoadTextureAsync with the mip chain of Renderer_LoadTextureMipmapped(), built on the loader thread
+RendererTextureLoad Renderer_LoadTextureMipmappedAsync(const char *path, int cell_w, int cell_h);
+
+/**
+ * @brief Checks a load without blocking. READY returns the texture, now owned by the caller, and its size; READY and
+ * FAILED both release the handle.
+ */
+RendererTextureLoadStatus Renderer_PollTextureLoad(RendererTextureLoad load,
+                                                   SDL_GPUTexture **texture,
+                                                   int *width,
+                                                   int *height);
+
+/**
+ * @brief Blocks until the load is decoded and uploads it right away instead of waiting for a frame, for loads needed
+ * before the first frame. Same results as Renderer_PollTextureLoad(), never PENDING.
+ */
+RendererTextureLoadStatus Renderer_WaitTextureLoad(RendererTextureLoad load,
+                                                   SDL_GPUTexture **texture,
+                                                   int *width,
+                                                   int *height);
+
+// Drops a load that is no longer wanted, its texture is released if it was already uploaded
+void Renderer_CancelTextureLoad(RendererTextureLoad load);
+
+/**
+ * @brief Loads images into the layers of one 2D texture array, paths[i] going to layer i, uploaded immediately.
+ *
+ * Layers share one size, the largest image's width and height (returned in `width` and `height`), smaller images sit in
+ * the top-left corner of theirs. `sizes` (may be nullptr) receives each image's own size. Mipmaps are built per
+ * `cell_w` x `cell_h` cell as in Renderer_LoadTextureMipmapped(), the array keeps the levels every image has.
+ */
+SDL_GPUTexture *Renderer_LoadTextureArray(
+    const char *const *paths, int count, int cell_w, int cell_h, int *width, int *height, SDL_Point *sizes);
+
+/**
+ * @brief Creates a sampled 2D texture from CPU pixels in `format`, rows `pitch` bytes apart. The upload is submitted
+ * immediately.
+ */
+SDL_GPUTexture *Renderer_CreateTexture(
+    const void *pixels, int width, int height, int pitch, SDL_GPUTextureFormat format);
 void Renderer_DestroyTexture(SDL_GPUTexture *texture);
 
 void Renderer_BeginFrame(void);
@@ -124,7 +252,8 @@ void Renderer_SetWaterParams(float time, float speed, float amplitude, float pha
  * Renders multiple sprites in a single draw call for optimal performance.
  * All sprites must use the same texture.
  *
- * @param texture   The texture atlas containing all sprite images.
+ * @param texture   The texture atlas containing all sprite images. Texture arrays are skipped with a warning, they
+ *                  go through Renderer_DrawLayeredSprites().
  * @param instances Array of sprite instance data.
  * @param count     Number of sprites to draw.
  *
@@ -133,8 +262,43 @@ void Renderer_SetWaterParams(float time, float speed, float amplitude, float pha
  */
 void Renderer_DrawSprites(SDL_GPUTexture *texture, const SpriteInstance *instances, int count);
 
+/**
+ * @brief Draw a batch of sprites from a texture array, each instance choosing its layer.
+ *
+ * Same as Renderer_DrawSprites(), but the sprites may come from any sheet loaded into `texture_array`: tiles,
+ * buildings and units from different sheets all go into one instanced draw. Layered and plain sprite batches are drawn
+ * in submission order.
+ *
+ * @param texture_array A texture from Renderer_LoadTextureArray().
+ */
+void Renderer_DrawLayeredSprites(SDL_GPUTexture *texture_array, const SpriteLayerInstance *instances, int count);
+
 // Update the camera/view projection
 void Renderer_DrawLine(float x1, float y1, float z1, float x2, float y2, float z2, SDL_FColor color);
+
+/**
+ * @brief Queues a batch of world-space line segments, vertices 2n and 2n+1 form segment n (a trailing odd vertex is
+ * ignored). Uses the current view projection. Consecutive batches under the same view projection are drawn with a
+ * single draw call, so prefer this over many Renderer_DrawLine() calls for grids, paths and other debug overlays.
+ */
+void Renderer_DrawLines(const RendererLineVertex *vertices, int vertex_count);
+
+RendererLineVertex Renderer_LineVertex(float x, float y, float z, SDL_FColor color);
+
+/**
+ * @brief Queues box wireframes with the current view projection. Only the instances are uploaded, the GPU builds the
+ * edges, so the cost per box does not depend on stored geometry. Consecutive calls under the same view projection
+ * share one instanced draw call.
+ */
+void Renderer_DrawWireframes(const RendererWireframeInstance *instances, int count);
+
+/**
+ * @brief Queues distance field glyphs with the current view projection, drawn after the rest of the world and without
+ * depth test. Consecutive calls with the same atlas and view projection share one instanced draw call, so thousands of
+ * labels cost a single draw.
+ */
+void Renderer_DrawSDFGlyphs(SDL_GPUTexture *atlas, const RendererSDFGlyph *glyphs, int count);
+
 void Renderer_DrawGeometry(const SDL_Vertex *vertices, int count);
 
 TTF_TextEngine *Renderer_GetTextEngine(void);
@@ -151,6 +315,15 @@ void Renderer_DrawGeometryScreenSpace(const SDL_Vertex *vertices, int count);
 // These functions render pre-batched data efficiently.
 // Prefer using the high-level UI_* functions from ui_batch.h instead.
 
+/**
+ * @brief Screen-space text vertex with its own tint, 20 bytes. Must match TextVertexInput in ui.metal.
+ */
+typedef struct {
+    float x, y;
+    float u, v;
+    Uint8 r, g, b, a;
+} UITextVertex;
+
 // Atlas info for batched text rendering
 typedef struct {
     SDL_GPUTexture *atlas;
@@ -161,16 +334,48 @@ typedef struct {
 // Flush screen-space geometry (single draw call)
 void Renderer_FlushUIGeometry(const SDL_Vertex *vertices, int count);
 
-// Flush screen-space text (one draw call per atlas)
-void Renderer_FlushUIText(const float *vertices,
+// Flush screen-space text (one draw call per atlas range, whatever the colors). Any number of atlases, pass the indices
+// grouped by atlas (as UI_Flush does) so each atlas is a single range and a single draw.
+void Renderer_FlushUIText(const UITextVertex *vertices,
                           int vertex_count,
                           const int *indices,
                           int index_count,
                           const UITextAtlasInfo *atlases,
                           int atlas_count);
 
+/**
+ * @brief Retained screen-space geometry and text (used by UI panels, see ui.h), 0 is never a valid block.
+ *
+ * A block's content lives in its own GPU buffer and is drawn again every frame it is queued, with no CPU work and no
+ * upload until it is updated. Blocks draw after the frame's flushed UI geometry and UI text respectively.
+ */
+typedef Uint32 RendererUIBlock;
+
+RendererUIBlock Renderer_CreateUIBlock(void);
+void Renderer_DestroyUIBlock(RendererUIBlock block);
+
+/**
+ * @brief Replaces a block's content, same layout as Renderer_FlushUIGeometry() and Renderer_FlushUIText().
+ * The content is staged in the frame's upload stream and copied with the next flush, so call it between
+ * Renderer_BeginFrame() and Renderer_EndFrame().
+ * @return false outside a frame, when the staging stream is full or the GPU buffer could not be created. The block
+ * then draws nothing.
+ */
+bool Renderer_UpdateUIBlock(RendererUIBlock block,
+                            const SDL_Vertex *geometry,
+                            int geometry_count,
+                            const UITextVertex *text_vertices,
+                            int text_vertex_count,
+                            const int *text_indices,
+                            int text_index_count,
+                            const UITextAtlasInfo *atlases,
+                            int atlas_count);
+
+// Queue a block's last content for this frame's UI pass
+void Renderer_DrawUIBlock(RendererUIBlock block);
+
 /* ------------------ DEBUG UTILITIES ------------------ */
-// Debug: Draw a texture as a screen-space quad
+// Debug: Draw a texture as a screen-space quad (texture arrays are skipped)
 void Renderer_DrawTextureDebug(SDL_GPUTexture *texture, float x, float y, float width, float height);
 
 // Debug: Draw a filled colored quad using geometry pipeline (to verify rendering works)
@@ -179,5 +384,7 @@ void Renderer_DrawFilledQuadDebug(float x, float y, float width, float height, S
 void Renderer_SetPresentMode(SDL_GPUPresentMode mode);
 SDL_GPUPresentMode Renderer_GetPresentMode(void);
 const RendererFrameStats *Renderer_GetFrameStats(void);
+const char *Renderer_GetStatsQueueName(RendererStatsQueueKind queue);
+const char *Renderer_GetStatsStreamName(RendererStatsStreamKind stream);
 
 #endif // RENDERER_H
@@ -8,12 +8,86 @@
 
 SDL_Window *Renderer_GetWindow(void);
 SDL_GPUDevice *Renderer_GetDevice(void);
-SDL_GPUCommandBuffer *Renderer_GetCommandBuffer(void);
-SDL_GPUTexture *Renderer_GetSwapchainTexture(void);
 
-// Render pass management for external rendering
-// Call EndRenderPass before external GPU rendering, ResumeRenderPass after
-void Renderer_EndRenderPass(void);
-void Renderer_ResumeRenderPass(void);
+// One scissored indexed draw of a debug UI batch, first_index is relative to the batch's indices
+typedef struct RendererDebugUIDraw {
+    SDL_GPUTexture *texture; // nullptr keeps the previous draw's texture bound
+    SDL_Rect scissor;
+    Uint32 first_index;
+    Uint32 index_count;
+} RendererDebugUIDraw;
+
+// Queues an external UI batch (the Nuklear backend) into the frame's upload streams. It is drawn at the end of the UI
+// pass with the given pipeline, the screen projection pushed as vertex uniform 0, so the frame needs no extra copy or
+// render pass for it. Returns false outside of a frame or when the streams are full.
+bool Renderer_QueueDebugUI(SDL_GPUGraphicsPipeline *pipeline,
+                           SDL_GPUSampler *sampler,
+                           const void *vertices,
+                           Uint32 vertex_bytes,
+                           const void *indices,
+                           Uint32 index_bytes,
+                           SDL_GPUIndexElementSize index_size,
+                           const RendererDebugUIDraw *draws,
+                           Uint32 draw_count);
+
+// Loads `path` into a surface in SDL_PIXELFORMAT_ABGR8888, the layout of SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM. Cooked
+// .mtex blobs are mapped instead of decoded. Safe to call from any thread.
+SDL_Surface *Renderer_DecodeImage(const char *path);
+
+// Maps a cooked .mtex blob (cooked_texture.c) and returns a surface over its pixels, unmapped with the surface
+SDL_Surface *Renderer_MapCookedTexture(const char *path);
+
+// False if `image` is a cooked blob whose recorded tile grid differs from the one it is loaded with. Other images, and
+// a cell size of 0, always fit.
+bool Renderer_CookedTextureFitsGrid(SDL_Surface *image, int cell_w, int cell_h);
+
+// Records an upload of `pixels` into `region` of an existing texture's `layer` (0 unless it is an array) and mip level,
+// for textures filled piece by piece (atlases, texture arrays, mip chains)
+bool Renderer_UploadTextureRegion(SDL_GPUCopyPass *copy_pass,
+                                  SDL_GPUTexture *texture,
+                                  Uint32 layer,
+                                  Uint32 mip_level,
+                                  const SDL_Rect *region,
+                                  const void *pixels,
+                                  int pitch,
+                                  SDL_GPUTextureFormat format);
+
+// Creates a texture and records its upload into `copy_pass`, the texture is usable by anything submitted after it
+SDL_GPUTexture *Renderer_UploadTexture(
+    SDL_GPUCopyPass *copy_pass, const void *pixels, int width, int height, int pitch, SDL_GPUTextureFormat format);
+
+#define RENDERER_MAX_MIP_LEVELS 14 // 8192 texels down to 1
+
+// A decoded image and its mip levels (mipmaps.c), levels[0] being the image, each level half the previous one
+typedef struct RendererMipChain {
+    SDL_Surface *levels[RENDERER_MAX_MIP_LEVELS];
+    int count;
+} RendererMipChain;
+
+// Builds the mip levels of `image` (ABGR8888), which the chain takes ownership of, treating it as a grid of
+// cell_w x cell_h cells (a tileset's tiles): a level is only built while the cells halve into whole texels, so no level
+// mixes two cells. A cell size of 0 keeps the image as the only level. Safe to call from any thread.
+bool Renderer_BuildMipChain(SDL_Surface *image, int cell_w, int cell_h, RendererMipChain *chain);
+void Renderer_DestroyMipChain(RendererMipChain *chain);
+Uint32 Renderer_MipChainBytes(const RendererMipChain *chain);
+
+// Records the upload of the chain's first `level_count` levels into `layer` of an existing texture
+bool Renderer_UploadMipChainLayer(SDL_GPUCopyPass *copy_pass,
+                                  SDL_GPUTexture *texture,
+                                  Uint32 layer,
+                                  const RendererMipChain *chain,
+                                  int level_count);
+
+// Creates a 2D texture with one level per chain level and records its upload into `copy_pass`
+SDL_GPUTexture *Renderer_UploadMipChain(SDL_GPUCopyPass *copy_pass, const RendererMipChain *chain);
+
+// Same as Renderer_UploadMipChain, submitting the upload immediately
+SDL_GPUTexture *Renderer_CreateMipChainTexture(const RendererMipChain *chain);
+
+// Background texture loads (texture_loader.c), driven by the renderer: started by Renderer_Init, stopped by
+// Renderer_Shutdown, and decoded loads upload in each flushed frame's copy pass
+bool Renderer_TextureLoaderInit(void);
+void Renderer_TextureLoaderShutdown(void);
+void Renderer_TextureLoaderUpload(SDL_GPUCopyPass *copy_pass);
 
 #endif // RENDERER_INTERNAL_H
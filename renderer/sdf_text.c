@@ -0,0 +1,302 @@
+#include "sdf_text.h"
+
+#include "../memtrack.h"
+#include "renderer.h"
+
+#include <SDL3/SDL_log.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#define SDF_TEXT_FIRST_CODEPOINT 32U
+#define SDF_TEXT_LAST_CODEPOINT 255U // Latin-1
+#define SDF_TEXT_GLYPH_COUNT (SDF_TEXT_LAST_CODEPOINT - SDF_TEXT_FIRST_CODEPOINT + 1U)
+#define SDF_TEXT_FALLBACK_CODEPOINT '?'
+#define SDF_TEXT_CELL_PADDING 2 // keeps linear filtering from reading a neighbour cell
+#define SDF_TEXT_MIN_ATLAS_SIZE 256
+#define SDF_TEXT_MAX_ATLAS_SIZE 4096
+#define SDF_TEXT_BATCH_GLYPHS 256
+#define SDF_TEXT_OUTLINE_BIAS 0.15f // in distance units, the baked spread covers 0.5 on each side of the outline
+
+typedef struct {
+    Uint16 u, v, uw, vh; // normalized atlas rectangle
+    float w, h;          // cell size in baked pixels
+    float advance;       // baked pixels
+    bool present;
+} SDFGlyph;
+
+struct SDFFont {
+    SDL_GPUTexture *atlas;
+    float bake_size;
+    float line_height; // baked pixels
+    SDFGlyph glyphs[SDF_TEXT_GLYPH_COUNT];
+};
+
+typedef struct {
+    RendererSDFGlyph glyphs[SDF_TEXT_BATCH_GLYPHS];
+    int count;
+    SDL_GPUTexture *atlas;
+} SDFTextBatch;
+
+static Uint32 sdf_text_rgba8(const SDL_FColor color) {
+    const Uint32 r = (Uint32)(SDL_clamp(color.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+    const Uint32 g = (Uint32)(SDL_clamp(color.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+    const Uint32 b = (Uint32)(SDL_clamp(color.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+    const Uint32 a = (Uint32)(SDL_clamp(color.a, 0.0f, 1.0f) * 255.0f + 0.5f);
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+static Uint16 sdf_text_unorm16(const int texel, const int size) {
+    return (Uint16)(((Uint32)texel * 65535U + (Uint32)size / 2U) / (Uint32)size);
+}
+
+// Shelf packing in cell order: returns false if the cells do not fit in a size x size atlas
+static bool sdf_text_pack(SDL_Surface *const *const cells, const int size, SDL_Point *const positions) {
+    int x = 0;
+    int y = 0;
+    int shelf_height = 0;
+    for (Uint32 i = 0; i < SDF_TEXT_GLYPH_COUNT; i++) {
+        if (!cells[i]) {
+            continue;
+        }
+        const int w = cells[i]->w + SDF_TEXT_CELL_PADDING;
+        const int h = cells[i]->h + SDF_TEXT_CELL_PADDING;
+        if (x + w > size) {
+            x = 0;
+            y += shelf_height;
+            shelf_height = 0;
+        }
+        if (w > size || y + h > size) {
+            return false;
+        }
+        positions[i] = (SDL_Point){x, y};
+        x += w;
+        shelf_height = SDL_max(shelf_height, h);
+    }
+    return true;
+}
+
+SDFFont *SDFText_LoadFont(const char *const path, const float bake_size) {
+    MEM_TAG(MEM_TAG_RENDERER);
+    if (!path || bake_size <= 0.0f) {
+        return nullptr;
+    }
+
+    TTF_Font *const ttf = TTF_OpenFont(path, bake_size);
+    if (!ttf) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDF text: failed to open %s: %s", path, SDL_GetError());
+        return nullptr;
+    }
+    if (!TTF_SetFontSDF(ttf, true)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDF text: distance field rendering unavailable: %s", SDL_GetError());
+        TTF_CloseFont(ttf);
+        return nullptr;
+    }
+
+    SDFFont *const font = SDL_calloc(1, sizeof(SDFFont));
+    if (!font) {
+        TTF_CloseFont(ttf);
+        return nullptr;
+    }
+    font->bake_size = bake_size;
+    font->line_height = (float)TTF_GetFontHeight(ttf);
+
+    // Each glyph is rendered as its own line-high cell, so drawing a cell at the pen position reproduces SDL_ttf's
+    // layout, spread padding included
+    SDL_Surface *cells[SDF_TEXT_GLYPH_COUNT] = {0};
+    for (Uint32 i = 0; i < SDF_TEXT_GLYPH_COUNT; i++) {
+        const Uint32 codepoint = SDF_TEXT_FIRST_CODEPOINT + i;
+        int advance = 0;
+        if (!TTF_FontHasGlyph(ttf, codepoint) ||
+            !TTF_GetGlyphMetrics(ttf, codepoint, nullptr, nullptr, nullptr, nullptr, &advance)) {
+            continue;
+        }
+        font->glyphs[i].present = true;
+        font->glyphs[i].advance = (float)advance;
+        if (codepoint == ' ') {
+            continue;
+        }
+
+        SDL_Surface *const rendered = TTF_RenderGlyph_Blended(ttf, codepoint, (SDL_Color){255, 255, 255, 255});
+        if (!rendered) {
+            continue;
+        }
+        cells[i] = SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(rendered);
+    }
+    TTF_CloseFont(ttf);
+
+    SDL_Point positions[SDF_TEXT_GLYPH_COUNT] = {0};
+    int size = SDF_TEXT_MIN_ATLAS_SIZE;
+    while (size <= SDF_TEXT_MAX_ATLAS_SIZE && !sdf_text_pack(cells, size, positions)) {
+        size *= 2;
+    }
+
+    Uint8 *const pixels = size <= SDF_TEXT_MAX_ATLAS_SIZE ? SDL_calloc((size_t)size * (size_t)size, 1) : nullptr;
+    if (pixels) {
+        for (Uint32 i = 0; i < SDF_TEXT_GLYPH_COUNT; i++) {
+            const SDL_Surface *const cell = cells[i];
+            if (!cell) {
+                continue;
+            }
+            // the distance is in the alpha channel, byte 3 of RGBA32
+            for (int y = 0; y < cell->h; y++) {
+                const Uint8 *const src = (const Uint8 *)cell->pixels + (size_t)cell->pitch * (size_t)y;
+                Uint8 *const dst = pixels + (size_t)(positions[i].y + y) * (size_t)size + (size_t)positions[i].x;
+                for (int x = 0; x < cell->w; x++) {
+                    dst[x] = src[x * 4 + 3];
+                }
+            }
+
+            SDFGlyph *const glyph = &font->glyphs[i];
+            glyph->u = sdf_text_unorm16(positions[i].x, size);
+            glyph->v = sdf_text_unorm16(positions[i].y, size);
+            glyph->uw = sdf_text_unorm16(cell->w, size);
+            glyph->vh = sdf_text_unorm16(cell->h, size);
+            glyph->w = (float)cell->w;
+            glyph->h = (float)cell->h;
+        }
+        font->atlas = Renderer_CreateTexture(pixels, size, size, size, SDL_GPU_TEXTUREFORMAT_R8_UNORM);
+        SDL_free(pixels);
+    }
+
+    for (Uint32 i = 0; i < SDF_TEXT_GLYPH_COUNT; i++) {
+        SDL_DestroySurface(cells[i]);
+    }
+
+    if (!font->atlas) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDF text: failed to build the atlas for %s", path);
+        SDL_free(font);
+        return nullptr;
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+                "SDF text: baked %s at %.0f px into a %dx%d atlas",
+                path,
+                (double)bake_size,
+                size,
+                size);
+    return font;
+}
+
+void SDFText_DestroyFont(SDFFont *const font) {
+    if (!font) {
+        return;
+    }
+    Renderer_DestroyTexture(font->atlas);
+    SDL_free(font);
+}
+
+static const SDFGlyph *sdf_text_glyph(const SDFFont *const font, const Uint32 codepoint) {
+    if (codepoint >= SDF_TEXT_FIRST_CODEPOINT && codepoint <= SDF_TEXT_LAST_CODEPOINT &&
+        font->glyphs[codepoint - SDF_TEXT_FIRST_CODEPOINT].present) {
+        return &font->glyphs[codepoint - SDF_TEXT_FIRST_CODEPOINT];
+    }
+    const SDFGlyph *const fallback = &font->glyphs[SDF_TEXT_FALLBACK_CODEPOINT - SDF_TEXT_FIRST_CODEPOINT];
+    return fallback->present ? fallback : nullptr;
+}
+
+float SDFText_MeasureWidth(const SDFFont *const font, const char *const text, const float size) {
+    if (!font || !text) {
+        return 0.0f;
+    }
+    const float scale = size / font->bake_size;
+    float widest = 0.0f;
+    float pen = 0.0f;
+    const char *cursor = text;
+    Uint32 codepoint;
+    while ((codepoint = SDL_StepUTF8(&cursor, nullptr)) != 0) {
+        if (codepoint == '\n') {
+            pen = 0.0f;
+            continue;
+        }
+        const SDFGlyph *const glyph = sdf_text_glyph(font, codepoint);
+        if (glyph) {
+            pen += glyph->advance * scale;
+            widest = SDL_max(widest, pen);
+        }
+    }
+    return widest;
+}
+
+float SDFText_MeasureHeight(const SDFFont *const font, const char *const text, const float size) {
+    if (!font || !text) {
+        return 0.0f;
+    }
+    int lines = 1;
+    for (const char *c = text; *c; c++) {
+        lines += *c == '\n';
+    }
+    return (float)lines * font->line_height * (size / font->bake_size);
+}
+
+static void sdf_text_batch_flush(SDFTextBatch *const batch) {
+    Renderer_DrawSDFGlyphs(batch->atlas, batch->glyphs, batch->count);
+    batch->count = 0;
+}
+
+// One pass over the label, the outline pass and the fill pass only differ in color and bias
+static void sdf_text_emit(SDFTextBatch *const batch,
+                          const SDFFont *const font,
+                          const char *const text,
+                          const float x,
+                          const float y,
+                          const float scale,
+                          const Uint32 color,
+                          const float bias) {
+    float pen = x;
+    float line_y = y;
+    const char *cursor = text;
+    Uint32 codepoint;
+    while ((codepoint = SDL_StepUTF8(&cursor, nullptr)) != 0) {
+        if (codepoint == '\n') {
+            pen = x;
+            line_y += font->line_height * scale;
+            continue;
+        }
+        const SDFGlyph *const glyph = sdf_text_glyph(font, codepoint);
+        if (!glyph) {
+            continue;
+        }
+        if (glyph->w > 0.0f) {
+            if (batch->count == SDF_TEXT_BATCH_GLYPHS) {
+                sdf_text_batch_flush(batch);
+            }
+            batch->glyphs[batch->count++] = (RendererSDFGlyph){
+                .x = pen,
+                .y = line_y,
+                .w = glyph->w * scale,
+                .h = glyph->h * scale,
+                .u = glyph->u,
+                .v = glyph->v,
+                .uw = glyph->uw,
+                .vh = glyph->vh,
+                .color = color,
+                .bias = bias,
+            };
+        }
+        pen += glyph->advance * scale;
+    }
+}
+
+void SDFText_DrawLabel(const SDFFont *const font,
+                       const char *const text,
+                       const float x,
+                       const float y,
+                       const float size,
+                       const SDL_FColor color,
+                       const SDL_FColor outline) {
+    if (!font || !text || size <= 0.0f) {
+        return;
+    }
+
+    SDFTextBatch batch;
+    batch.count = 0;
+    batch.atlas = font->atlas;
+    const float scale = size / font->bake_size;
+    // outline glyphs first, instances draw in order within the shared draw call
+    if (outline.a > 0.0f) {
+        sdf_text_emit(&batch, font, text, x, y, scale, sdf_text_rgba8(outline), SDF_TEXT_OUTLINE_BIAS);
+    }
+    sdf_text_emit(&batch, font, text, x, y, scale, sdf_text_rgba8(color), 0.0f);
+    if (batch.count > 0) {
+        sdf_text_batch_flush(&batch);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef MISO_SDF_TEXT_H
+#define MISO_SDF_TEXT_H
+
+/* ============================================================================
+   World-Space Labels: Signed Distance Field Text
+   ============================================================================
+ */
+
+// A font is baked once into a distance field atlas (Latin-1, one glyph per cell), and labels are drawn from it at any
+// size and zoom without re-rasterizing. Coordinates and sizes are world units under the current view projection.
+//
+// Usage:
+//   SDFFont *labels = SDFText_LoadFont(path, 48.0f);
+//   SDFText_DrawLabel(labels, "Harbour", x, y, 12.0f, white, black);  // every label of a frame shares one draw call
+//   SDFText_DestroyFont(labels);
+//
+
+#include <SDL3/SDL.h>
+
+typedef struct SDFFont SDFFont;
+
+// bake_size is the pixel size glyphs are rasterized at, larger keeps thin strokes and corners when labels are big
+SDFFont *SDFText_LoadFont(const char *path, float bake_size);
+void SDFText_DestroyFont(SDFFont *font);
+
+// Width of the widest line and height of all lines of `text` drawn at `size`
+float SDFText_MeasureWidth(const SDFFont *font, const char *text, float size);
+float SDFText_MeasureHeight(const SDFFont *font, const char *text, float size);
+
+// Draws `text` with its top-left corner at (x, y), `size` being the font size in world units. Newlines start a new
+// line. An outline with non-zero alpha is drawn behind the glyphs, keeping labels readable over busy tiles.
+void SDFText_DrawLabel(
+    const SDFFont *font, const char *text, float x, float y, float size, SDL_FColor color, SDL_FColor outline);
+
+#endif // MISO_SDF_TEXT_H
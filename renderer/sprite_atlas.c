@@ -0,0 +1,379 @@
+#include "sprite_atlas.h"
+
+#include "../memtrack.h"
+#include "renderer.h"
+#include "renderer_internal.h"
+
+#include <SDL3/SDL_log.h>
+
+#define SPRITE_ATLAS_MIN_PAGE_SIZE 256
+#define SPRITE_ATLAS_MAX_PAGE_SIZE 8192 // every SDL GPU backend supports 2D textures this large
+#define SPRITE_ATLAS_MAX_PAGES 16U
+#define SPRITE_ATLAS_PADDING 1 // filled with the sprite's edge texels, filtering never reads a neighbour sprite
+#define SPRITE_ATLAS_MIN_SPRITES 64U
+
+// One segment of a page's skyline: the columns [x, x + width) are used up to row y. The segments cover the whole
+// page width, left to right, and neighbours never share a height.
+typedef struct {
+    int x, y, width;
+} SkylineNode;
+
+typedef struct {
+    SDL_GPUTexture *texture;
+    SDL_Surface *pixels; // CPU copy the sprites are packed into, ABGR8888
+    SkylineNode *skyline;
+    int skyline_count;
+    SDL_Rect dirty; // changed since the last commit, empty when w is 0
+} SpriteAtlasPage;
+
+typedef struct {
+    Uint32 page;
+    SDL_Rect rect; // without the padding
+} SpriteAtlasEntry;
+
+struct SpriteAtlas {
+    int page_size;
+    SpriteAtlasPage pages[SPRITE_ATLAS_MAX_PAGES];
+    Uint32 page_count;
+    SpriteAtlasEntry *sprites;
+    Uint32 sprite_count;
+    Uint32 sprite_capacity;
+};
+
+static void sprite_atlas_skyline_remove(SpriteAtlasPage *const page, const int index) {
+    SDL_memmove(&page->skyline[index],
+                &page->skyline[index + 1],
+                sizeof(SkylineNode) * (size_t)(page->skyline_count - index - 1));
+    page->skyline_count--;
+}
+
+// Row a w x h rectangle rests on when its left edge is at node `index`, -1 if it does not fit there
+static int sprite_atlas_skyline_fit(
+    const SpriteAtlasPage *const page, const int size, const int index, const int w, const int h) {
+    const int x = page->skyline[index].x;
+    if (x + w > size) {
+        return -1;
+    }
+    int y = 0;
+    int remaining = w;
+    for (int i = index; remaining > 0; i++) {
+        y = SDL_max(y, page->skyline[i].y);
+        if (y + h > size) {
+            return -1;
+        }
+        remaining -= page->skyline[i].width;
+    }
+    return y;
+}
+
+// Bottom-left placement: the position whose top edge ends lowest, ties going to the narrowest segment. Returns false
+// if the page has no room.
+static bool sprite_atlas_skyline_find(const SpriteAtlasPage *const page,
+                                      const int size,
+                                      const int w,
+                                      const int h,
+                                      int *const index,
+                                      SDL_Point *const position) {
+    int best_bottom = SDL_MAX_SINT32;
+    int best_width = SDL_MAX_SINT32;
+    *index = -1;
+    for (int i = 0; i < page->skyline_count; i++) {
+        const int y = sprite_atlas_skyline_fit(page, size, i, w, h);
+        if (y < 0) {
+            continue;
+        }
+        const int bottom = y + h;
+        if (bottom < best_bottom || (bottom == best_bottom && page->skyline[i].width < best_width)) {
+            best_bottom = bottom;
+            best_width = page->skyline[i].width;
+            *index = i;
+            *position = (SDL_Point){page->skyline[i].x, y};
+        }
+    }
+    return *index >= 0;
+}
+
+static void sprite_atlas_skyline_insert(SpriteAtlasPage *const page, const int index, const SDL_Rect *const rect) {
+    SDL_memmove(&page->skyline[index + 1],
+                &page->skyline[index],
+                sizeof(SkylineNode) * (size_t)(page->skyline_count - index));
+    page->skyline[index] = (SkylineNode){rect->x, rect->y + rect->h, rect->w};
+    page->skyline_count++;
+
+    // the segments now under the new one shrink from the left or disappear
+    for (int i = index + 1; i < page->skyline_count;) {
+        SkylineNode *const node = &page->skyline[i];
+        const SkylineNode *const previous = &page->skyline[i - 1];
+        const int covered = previous->x + previous->width - node->x;
+        if (covered <= 0) {
+            break;
+        }
+        node->x += covered;
+        node->width -= covered;
+        if (node->width > 0) {
+            break;
+        }
+        sprite_atlas_skyline_remove(page, i);
+    }
+
+    for (int i = 0; i + 1 < page->skyline_count;) {
+        if (page->skyline[i].y == page->skyline[i + 1].y) {
+            page->skyline[i].width += page->skyline[i + 1].width;
+            sprite_atlas_skyline_remove(page, i + 1);
+        } else {
+            i++;
+        }
+    }
+}
+
+static bool sprite_atlas_add_page(SpriteAtlas *const atlas) {
+    if (atlas->page_count >= SPRITE_ATLAS_MAX_PAGES) {
+        SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Sprite atlas: all %u pages are full", SPRITE_ATLAS_MAX_PAGES);
+        return false;
+    }
+
+    const int size = atlas->page_size;
+    SpriteAtlasPage *const page = &atlas->pages[atlas->page_count];
+    // one node per column at most, plus the one inserted before the covered ones are trimmed
+    page->skyline = SDL_malloc(sizeof(SkylineNode) * (size_t)(size + 1));
+    page->pixels = SDL_CreateSurface(size, size, SDL_PIXELFORMAT_ABGR8888); // zeroed: transparent
+    const SDL_GPUTextureCreateInfo texture_info = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+        .width = (Uint32)size,
+        .height = (Uint32)size,
+        .layer_count_or_depth = 1,
+        .num_levels = 1,
+        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+    };
+    page->texture = SDL_CreateGPUTexture(Renderer_GetDevice(), &texture_info);
+    if (!page->skyline || !page->pixels || !page->texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Sprite atlas: failed to create a %dx%d page", size, size);
+        SDL_free(page->skyline);
+        SDL_DestroySurface(page->pixels);
+        Renderer_DestroyTexture(page->texture);
+        *page = (SpriteAtlasPage){0};
+        return false;
+    }
+
+    page->skyline[0] = (SkylineNode){0, 0, size};
+    page->skyline_count = 1;
+    page->dirty = (SDL_Rect){0, 0, size, size}; // the texture starts undefined, upload the cleared page once
+    atlas->page_count++;
+    return true;
+}
+
+// Copies `source` (ABGR8888) into `rect` of the page and repeats its outermost texels into the padding around it
+static void
+sprite_atlas_blit(SpriteAtlasPage *const page, const SDL_Surface *const source, const SDL_Rect *const rect) {
+    SDL_Surface *const target = page->pixels;
+    const size_t row_bytes = sizeof(Uint32) * (size_t)rect->w;
+    for (int y = 0; y < rect->h; y++) {
+        const Uint8 *const src = (const Uint8 *)source->pixels + (size_t)source->pitch * (size_t)y;
+        Uint32 *const dst =
+            (Uint32 *)((Uint8 *)target->pixels + (size_t)target->pitch * (size_t)(rect->y + y)) + rect->x;
+        SDL_memcpy(dst, src, row_bytes);
+        for (int p = 1; p <= SPRITE_ATLAS_PADDING; p++) {
+            dst[-p] = dst[0];
+            dst[rect->w - 1 + p] = dst[rect->w - 1];
+        }
+    }
+
+    const size_t padded_bytes = sizeof(Uint32) * (size_t)(rect->w + 2 * SPRITE_ATLAS_PADDING);
+    Uint8 *const first = (Uint8 *)target->pixels + (size_t)target->pitch * (size_t)rect->y +
+                         sizeof(Uint32) * (size_t)(rect->x - SPRITE_ATLAS_PADDING);
+    Uint8 *const last = first + (size_t)target->pitch * (size_t)(rect->h - 1);
+    for (int p = 1; p <= SPRITE_ATLAS_PADDING; p++) {
+        SDL_memcpy(first - (size_t)target->pitch * (size_t)p, first, padded_bytes);
+        SDL_memcpy(last + (size_t)target->pitch * (size_t)p, last, padded_bytes);
+    }
+}
+
+static bool sprite_atlas_reserve_sprite(SpriteAtlas *const atlas) {
+    if (atlas->sprite_count < atlas->sprite_capacity) {
+        return true;
+    }
+    const Uint32 capacity = atlas->sprite_capacity ? atlas->sprite_capacity * 2U : SPRITE_ATLAS_MIN_SPRITES;
+    SpriteAtlasEntry *const sprites = SDL_realloc(atlas->sprites, sizeof(SpriteAtlasEntry) * capacity);
+    if (!sprites) {
+        return false;
+    }
+    atlas->sprites = sprites;
+    atlas->sprite_capacity = capacity;
+    return true;
+}
+
+SpriteAtlas *SpriteAtlas_Create(const int page_size) {
+    MEM_TAG(MEM_TAG_RENDERER);
+    if (!Renderer_GetDevice()) {
+        return nullptr;
+    }
+    SpriteAtlas *const atlas = SDL_calloc(1, sizeof(SpriteAtlas));
+    if (!atlas) {
+        return nullptr;
+    }
+    atlas->page_size = SDL_clamp(page_size, SPRITE_ATLAS_MIN_PAGE_SIZE, SPRITE_ATLAS_MAX_PAGE_SIZE);
+    return atlas;
+}
+
+void SpriteAtlas_Destroy(SpriteAtlas *const atlas) {
+    if (!atlas) {
+        return;
+    }
+    for (Uint32 i = 0; i < atlas->page_count; i++) {
+        Renderer_DestroyTexture(atlas->pages[i].texture);
+        SDL_DestroySurface(atlas->pages[i].pixels);
+        SDL_free(atlas->pages[i].skyline);
+    }
+    SDL_free(atlas->sprites);
+    SDL_free(atlas);
+}
+
+SpriteAtlasSprite SpriteAtlas_AddImage(SpriteAtlas *const atlas, const char *const path) {
+    if (!atlas || !path) {
+        return 0;
+    }
+    SDL_Surface *const surface = Renderer_DecodeImage(path);
+    if (!surface) {
+        return 0;
+    }
+    const SpriteAtlasSprite sprite = SpriteAtlas_AddSurface(atlas, surface);
+    SDL_DestroySurface(surface);
+    return sprite;
+}
+
+SpriteAtlasSprite SpriteAtlas_AddSurface(SpriteAtlas *const atlas, SDL_Surface *const surface) {
+    MEM_TAG(MEM_TAG_RENDERER);
+    if (!atlas || !surface || surface->w <= 0 || surface->h <= 0) {
+        return 0;
+    }
+    const int padded_w = surface->w + 2 * SPRITE_ATLAS_PADDING;
+    const int padded_h = surface->h + 2 * SPRITE_ATLAS_PADDING;
+    if (padded_w > atlas->page_size || padded_h > atlas->page_size) {
+        SDL_LogError(SDL_LOG_CATEGORY_RENDER,
+                     "Sprite atlas: %dx%d sprite does not fit a %d page",
+                     surface->w,
+                     surface->h,
+                     atlas->page_size);
+        return 0;
+    }
+    if (!sprite_atlas_reserve_sprite(atlas)) {
+        return 0;
+    }
+
+    // earlier pages first, so the gaps left in them are filled before a new page is started
+    Uint32 page_index = 0;
+    int node = -1;
+    SDL_Point position = {0};
+    while (page_index < atlas->page_count &&
+           !sprite_atlas_skyline_find(
+               &atlas->pages[page_index], atlas->page_size, padded_w, padded_h, &node, &position)) {
+        page_index++;
+    }
+    if (page_index == atlas->page_count) {
+        if (!sprite_atlas_add_page(atlas) ||
+            !sprite_atlas_skyline_find(
+                &atlas->pages[page_index], atlas->page_size, padded_w, padded_h, &node, &position)) {
+            return 0;
+        }
+    }
+
+    SDL_Surface *converted = nullptr;
+    const SDL_Surface *source = surface;
+    if (surface->format != SDL_PIXELFORMAT_ABGR8888) {
+        converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
+        if (!converted) {
+            return 0;
+        }
+        source = converted;
+    }
+
+    SpriteAtlasPage *const page = &atlas->pages[page_index];
+    const SDL_Rect padded = {position.x, position.y, padded_w, padded_h};
+    sprite_atlas_skyline_insert(page, node, &padded);
+    const SDL_Rect rect = {padded.x + SPRITE_ATLAS_PADDING, padded.y + SPRITE_ATLAS_PADDING, surface->w, surface->h};
+    sprite_atlas_blit(page, source, &rect);
+    SDL_DestroySurface(converted);
+
+    if (page->dirty.w > 0) {
+        SDL_GetRectUnion(&page->dirty, &padded, &page->dirty);
+    } else {
+        page->dirty = padded;
+    }
+
+    atlas->sprites[atlas->sprite_count++] = (SpriteAtlasEntry){.page = page_index, .rect = rect};
+    return atlas->sprite_count;
+}
+
+bool SpriteAtlas_Commit(SpriteAtlas *const atlas) {
+    if (!atlas) {
+        return false;
+    }
+    bool dirty = false;
+    for (Uint32 i = 0; i < atlas->page_count; i++) {
+        dirty = dirty || atlas->pages[i].dirty.w > 0;
+    }
+    if (!dirty) {
+        return true;
+    }
+
+    SDL_GPUCommandBuffer *const upload_cmd = SDL_AcquireGPUCommandBuffer(Renderer_GetDevice());
+    if (!upload_cmd) {
+        return false;
+    }
+    bool ok = true;
+    SDL_GPUCopyPass *const copy = SDL_BeginGPUCopyPass(upload_cmd);
+    for (Uint32 i = 0; i < atlas->page_count; i++) {
+        SpriteAtlasPage *const page = &atlas->pages[i];
+        if (page->dirty.w <= 0) {
+            continue;
+        }
+        const SDL_Surface *const pixels = page->pixels;
+        const Uint8 *const first = (const Uint8 *)pixels->pixels + (size_t)pixels->pitch * (size_t)page->dirty.y +
+                                   sizeof(Uint32) * (size_t)page->dirty.x;
+        if (Renderer_UploadTextureRegion(copy,
+                                         page->texture,
+                                         0,
+                                         0,
+                                         &page->dirty,
+                                         first,
+                                         pixels->pitch,
+                                         SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM)) {
+            page->dirty = (SDL_Rect){0};
+        } else {
+            ok = false; // stays dirty, the next commit retries
+        }
+    }
+    SDL_EndGPUCopyPass(copy);
+    SDL_SubmitGPUCommandBuffer(upload_cmd);
+    return ok;
+}
+
+bool SpriteAtlas_GetRegion(const SpriteAtlas *const atlas,
+                           const SpriteAtlasSprite sprite,
+                           SpriteAtlasRegion *const region) {
+    if (!atlas || !region || sprite == 0 || sprite > atlas->sprite_count) {
+        return false;
+    }
+    const SpriteAtlasEntry *const entry = &atlas->sprites[sprite - 1];
+    const float size = (float)atlas->page_size;
+    *region = (SpriteAtlasRegion){
+        .texture = atlas->pages[entry->page].texture,
+        .page = entry->page,
+        .u = (float)entry->rect.x / size,
+        .v = (float)entry->rect.y / size,
+        .uw = (float)entry->rect.w / size,
+        .vh = (float)entry->rect.h / size,
+        .width = entry->rect.w,
+        .height = entry->rect.h,
+    };
+    return true;
+}
+
+Uint32 SpriteAtlas_GetPageCount(const SpriteAtlas *const atlas) {
+    return atlas ? atlas->page_count : 0;
+}
+
+SDL_GPUTexture *SpriteAtlas_GetPageTexture(const SpriteAtlas *const atlas, const Uint32 page) {
+    return atlas && page < atlas->page_count ? atlas->pages[page].texture : nullptr;
+}
@@ -0,0 +1,52 @@
+#ifndef MISO_SPRITE_ATLAS_H
+#define MISO_SPRITE_ATLAS_H
+
+/* ============================================================================
+   Sprite Atlas: Runtime Packing of Sprite Images into Shared Pages
+   ============================================================================
+ */
+
+// Renderer_DrawSprites merges consecutive draws only while they use the same texture, so sprites loaded as separate
+// textures cost a draw call each. An atlas packs them into a few large pages instead (skyline bottom-left packing),
+// and every sprite on a page batches with the others.
+//
+// Usage:
+//   SpriteAtlas *atlas = SpriteAtlas_Create(2048);
+//   SpriteAtlasSprite house = SpriteAtlas_AddImage(atlas, path);
+//   SpriteAtlas_Commit(atlas);                       // uploads everything added since the last commit
+//   SpriteAtlasRegion region;
+//   SpriteAtlas_GetRegion(atlas, house, &region);   // region.texture and region.u/v/uw/vh feed SpriteInstance
+//   SpriteAtlas_Destroy(atlas);
+//
+// Pages keep a CPU copy so sprites can be added at any time, a page's texture never changes once created.
+
+#include <SDL3/SDL.h>
+
+typedef struct SpriteAtlas SpriteAtlas;
+
+// Sprite handle, 0 is invalid
+typedef Uint32 SpriteAtlasSprite;
+
+typedef struct {
+    SDL_GPUTexture *texture; ///< The page the sprite was packed into
+    Uint32 page;
+    float u, v, uw, vh; ///< Normalized rectangle in the page, as SpriteInstance expects
+    int width, height;  ///< Sprite size in pixels
+} SpriteAtlasRegion;
+
+// page_size is the width and height of each page in pixels, clamped to 256-8192
+SpriteAtlas *SpriteAtlas_Create(int page_size);
+void SpriteAtlas_Destroy(SpriteAtlas *atlas);
+
+// Packs a copy of the image, returns 0 if it cannot be decoded or is larger than a page
+SpriteAtlasSprite SpriteAtlas_AddImage(SpriteAtlas *atlas, const char *path);
+SpriteAtlasSprite SpriteAtlas_AddSurface(SpriteAtlas *atlas, SDL_Surface *surface);
+
+// Uploads the parts of the pages changed since the last commit. Sprites added since then draw garbage until it runs.
+bool SpriteAtlas_Commit(SpriteAtlas *atlas);
+
+bool SpriteAtlas_GetRegion(const SpriteAtlas *atlas, SpriteAtlasSprite sprite, SpriteAtlasRegion *region);
+Uint32 SpriteAtlas_GetPageCount(const SpriteAtlas *atlas);
+SDL_GPUTexture *SpriteAtlas_GetPageTexture(const SpriteAtlas *atlas, Uint32 page);
+
+#endif // MISO_SPRITE_ATLAS_H
@@ -0,0 +1,363 @@
+#include "renderer.h"
+
+#include "../memtrack.h"
+#include "renderer_internal.h"
+
+#include <SDL3/SDL_log.h>
+
+#define TEXTURE_LOADER_MAX_LOADS 64U
+#define TEXTURE_LOADER_MAX_WORKERS 4
+#define TEXTURE_LOADER_SLOT_BITS 8U // handle: generation above, slot index + 1 below
+#define TEXTURE_LOADER_SLOT_MASK ((1U << TEXTURE_LOADER_SLOT_BITS) - 1U)
+#define TEXTURE_LOADER_GENERATION_MASK (UINT32_MAX >> TEXTURE_LOADER_SLOT_BITS)
+static_assert(TEXTURE_LOADER_MAX_LOADS <= TEXTURE_LOADER_SLOT_MASK, "Texture load slots must fit in the handle");
+#define TEXTURE_LOADER_UPLOAD_BUDGET (32U * 1024U * 1024U) // bytes recorded per frame, the first load always goes
+
+// Workers own a load while it is QUEUED or DECODING, the render thread from DECODED on
+typedef enum {
+    TEXTURE_LOAD_FREE,
+    TEXTURE_LOAD_QUEUED,
+    TEXTURE_LOAD_DECODING,
+    TEXTURE_LOAD_DECODED, // mip chain ready, waiting for a copy pass
+    TEXTURE_LOAD_READY,   // upload recorded, waiting for the owner to poll
+    TEXTURE_LOAD_FAILED,
+} TextureLoadState;
+
+typedef struct {
+    TextureLoadState state;
+    Uint32 generation; // bumped when the slot is freed, so stale handles stop resolving
+    bool cancelled; // cancelled while DECODING, the worker frees the load when it is done
+    Uint32 sequence;
+    char *path;
+    int cell_w; // mipmaps are filtered within these cells, 0 keeps a single level
+    int cell_h;
+    RendererMipChain mips;
+    SDL_GPUTexture *texture;
+    int width;
+    int height;
+} TextureLoad;
+
+static TextureLoad loads[TEXTURE_LOADER_MAX_LOADS] = {0}; // the handle's slot - 1 indexes this
+static SDL_Mutex *loader_mutex = nullptr;
+static SDL_Condition *work_queued = nullptr;  // workers wait for QUEUED loads
+static SDL_Condition *load_decoded = nullptr; // Renderer_WaitTextureLoad waits for decodes
+static SDL_Thread *workers[TEXTURE_LOADER_MAX_WORKERS] = {0};
+static int worker_count = 0;
+static bool loader_quit = false;
+static Uint32 next_sequence = 0;
+
+static TextureLoad *texture_loader_get(const RendererTextureLoad load) {
+    const Uint32 slot = load & TEXTURE_LOADER_SLOT_MASK;
+    if (slot == 0 || slot > TEXTURE_LOADER_MAX_LOADS) {
+        return nullptr;
+    }
+    TextureLoad *const entry = &loads[slot - 1U];
+    if (entry->state == TEXTURE_LOAD_FREE || entry->generation != load >> TEXTURE_LOADER_SLOT_BITS) {
+        return nullptr;
+    }
+    return entry;
+}
+
+// Frees everything a load holds, the caller holds the mutex
+static void texture_loader_release(TextureLoad *const load) {
+    SDL_free(load->path);
+    Renderer_DestroyMipChain(&load->mips);
+    Renderer_DestroyTexture(load->texture);
+    const Uint32 generation = (load->generation + 1U) & TEXTURE_LOADER_GENERATION_MASK;
+    *load = (TextureLoad){.generation = generation};
+}
+
+// Oldest queued load, loads are decoded in the order they were started
+static TextureLoad *texture_loader_next_queued(void) {
+    TextureLoad *oldest = nullptr;
+    for (Uint32 i = 0; i < TEXTURE_LOADER_MAX_LOADS; i++) {
+        if (loads[i].state != TEXTURE_LOAD_QUEUED) {
+            continue;
+        }
+        // wrap-safe "started before"
+        if (!oldest || loads[i].sequence - oldest->sequence > UINT32_MAX / 2U) {
+            oldest = &loads[i];
+        }
+    }
+    return oldest;
+}
+
+// Decodes a QUEUED load outside the mutex, which is held on entry and on return
+static void texture_loader_decode(TextureLoad *const load) {
+    load->state = TEXTURE_LOAD_DECODING;
+    const char *const path = load->path;
+    const int cell_w = load->cell_w;
+    const int cell_h = load->cell_h;
+    SDL_UnlockMutex(loader_mutex);
+
+    RendererMipChain mips;
+    const bool decoded = Renderer_BuildMipChain(Renderer_DecodeImage(path), cell_w, cell_h, &mips);
+
+    SDL_LockMutex(loader_mutex);
+    if (load->cancelled) {
+        Renderer_DestroyMipChain(&mips);
+        texture_loader_release(load);
+    } else if (decoded) {
+        load->mips = mips;
+        load->width = mips.levels[0]->w;
+        load->height = mips.levels[0]->h;
+        load->state = TEXTURE_LOAD_DECODED;
+    } else {
+        load->state = TEXTURE_LOAD_FAILED;
+    }
+    SDL_BroadcastCondition(load_decoded);
+}
+
+static int SDLCALL texture_loader_worker(void *const data) {
+    (void)data;
+    SDL_LockMutex(loader_mutex);
+    while (!loader_quit) {
+        TextureLoad *const load = texture_loader_next_queued();
+        if (load) {
+            texture_loader_decode(load);
+        } else {
+            SDL_WaitCondition(work_queued, loader_mutex);
+        }
+    }
+    SDL_UnlockMutex(loader_mutex);
+    return 0;
+}
+
+bool Renderer_TextureLoaderInit(void) {
+    loader_mutex = SDL_CreateMutex();
+    work_queued = SDL_CreateCondition();
+    load_decoded = SDL_CreateCondition();
+    if (!loader_mutex || !work_queued || !load_decoded) {
+        SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to create the texture loader: %s", SDL_GetError());
+        Renderer_TextureLoaderShutdown();
+        return false;
+    }
+
+    // leave a core to the main thread
+    loader_quit = false;
+    const int wanted = SDL_clamp(SDL_GetNumLogicalCPUCores() - 1, 1, TEXTURE_LOADER_MAX_WORKERS);
+    for (int i = 0; i < wanted; i++) {
+        workers[worker_count] = SDL_CreateThread(texture_loader_worker, "miso_texture_loader", nullptr);
+        if (!workers[worker_count]) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_GPU, "Failed to start a texture loader thread: %s", SDL_GetError());
+            break;
+        }
+        worker_count++;
+    }
+    return worker_count > 0;
+}
+
+void Renderer_TextureLoaderShutdown(void) {
+    if (loader_mutex) {
+        SDL_LockMutex(loader_mutex);
+        loader_quit = true;
+        SDL_BroadcastCondition(work_queued);
+        SDL_UnlockMutex(loader_mutex);
+    }
+    for (int i = 0; i < worker_count; i++) {
+        SDL_WaitThread(workers[i], nullptr);
+        workers[i] = nullptr;
+    }
+    worker_count = 0;
+
+    for (Uint32 i = 0; i < TEXTURE_LOADER_MAX_LOADS; i++) {
+        if (loads[i].state != TEXTURE_LOAD_FREE) {
+            texture_loader_release(&loads[i]);
+        }
+    }
+
+    SDL_DestroyCondition(load_decoded);
+    SDL_DestroyCondition(work_queued);
+    SDL_DestroyMutex(loader_mutex);
+    load_decoded = nullptr;
+    work_queued = nullptr;
+    loader_mutex = nullptr;
+}
+
+void Renderer_TextureLoaderUpload(SDL_GPUCopyPass *const copy_pass) {
+    if (!loader_mutex) {
+        return;
+    }
+
+    // DECODED loads belong to the render thread, only the state read needs the mutex
+    TextureLoad *decoded[TEXTURE_LOADER_MAX_LOADS];
+    Uint32 decoded_count = 0;
+    SDL_LockMutex(loader_mutex);
+    for (Uint32 i = 0; i < TEXTURE_LOADER_MAX_LOADS; i++) {
+        if (loads[i].state == TEXTURE_LOAD_DECODED) {
+            decoded[decoded_count++] = &loads[i];
+        }
+    }
+    SDL_UnlockMutex(loader_mutex);
+
+    Uint32 uploaded_bytes = 0;
+    for (Uint32 i = 0; i < decoded_count; i++) {
+        TextureLoad *const load = decoded[i];
+        const Uint32 size = Renderer_MipChainBytes(&load->mips);
+        if (uploaded_bytes > 0 && uploaded_bytes + size > TEXTURE_LOADER_UPLOAD_BUDGET) {
+            break; // the rest waits for the next frames, no single frame stalls on a level's worth of uploads
+        }
+        uploaded_bytes += size;
+
+        load->texture = Renderer_UploadMipChain(copy_pass, &load->mips);
+        if (!load->texture) {
+            SDL_LogError(SDL_LOG_CATEGORY_GPU, "Failed to upload texture %s: %s", load->path, SDL_GetError());
+        }
+        Renderer_DestroyMipChain(&load->mips);
+
+        SDL_LockMutex(loader_mutex);
+        load->state = load->texture ? TEXTURE_LOAD_READY : TEXTURE_LOAD_FAILED;
+        SDL_UnlockMutex(loader_mutex);
+    }
+}
+
+RendererTextureLoad Renderer_LoadTextureAsync(const char *const path) {
+    return Renderer_LoadTextureMipmappedAsync(path, 0, 0);
+}
+
+RendererTextureLoad Renderer_LoadTextureMipmappedAsync(const char *const path, const int cell_w, const int cell_h) {
+    if (!path || !loader_mutex) {
+        return 0;
+    }
+    MEM_TAG(MEM_TAG_RENDERER);
+
+    SDL_LockMutex(loader_mutex);
+    TextureLoad *load = nullptr;
+    for (Uint32 i = 0; i < TEXTURE_LOADER_MAX_LOADS && !load; i++) {
+        if (loads[i].state == TEXTURE_LOAD_FREE) {
+            load = &loads[i];
+        }
+    }
+    char *const path_copy = load ? SDL_strdup(path) : nullptr;
+    if (!path_copy) {
+        SDL_UnlockMutex(loader_mutex);
+        SDL_LogWarn(
+            SDL_LOG_CATEGORY_GPU, "Texture load table full (%u), cannot load %s", TEXTURE_LOADER_MAX_LOADS, path);
+        return 0;
+    }
+
+    *load = (TextureLoad){
+        .state = TEXTURE_LOAD_QUEUED,
+        .generation = load->generation,
+        .sequence = next_sequence++,
+        .path = path_copy,
+        .cell_w = cell_w,
+        .cell_h = cell_h,
+    };
+    if (worker_count > 0) {
+        SDL_SignalCondition(work_queued);
+    } else {
+        texture_loader_decode(load);
+    }
+    SDL_UnlockMutex(loader_mutex);
+    return load->generation << TEXTURE_LOADER_SLOT_BITS | ((RendererTextureLoad)(load - loads) + 1U);
+}
+
+// Hands a finished load to the caller and frees its slot, the mutex is held
+static RendererTextureLoadStatus texture_loader_finish(TextureLoad *const load,
+                                                       SDL_GPUTexture **const texture,
+                                                       int *const width,
+                                                       int *const height) {
+    if (load->state == TEXTURE_LOAD_READY) {
+        if (texture) {
+            *texture = load->texture;
+            load->texture = nullptr;
+        }
+        if (width) {
+            *width = load->width;
+        }
+        if (height) {
+            *height = load->height;
+        }
+        texture_loader_release(load);
+        return RENDERER_TEXTURE_LOAD_READY;
+    }
+    if (load->state == TEXTURE_LOAD_FAILED) {
+        texture_loader_release(load);
+        return RENDERER_TEXTURE_LOAD_FAILED;
+    }
+    return RENDERER_TEXTURE_LOAD_PENDING;
+}
+
+RendererTextureLoadStatus Renderer_PollTextureLoad(const RendererTextureLoad load,
+                                                   SDL_GPUTexture **const texture,
+                                                   int *const width,
+                                                   int *const height) {
+    if (!loader_mutex) {
+        return RENDERER_TEXTURE_LOAD_FAILED;
+    }
+
+    SDL_LockMutex(loader_mutex);
+    TextureLoad *const entry = texture_loader_get(load);
+    const RendererTextureLoadStatus status =
+        entry ? texture_loader_finish(entry, texture, width, height) : RENDERER_TEXTURE_LOAD_FAILED;
+    SDL_UnlockMutex(loader_mutex);
+    return status;
+}
+
+RendererTextureLoadStatus Renderer_WaitTextureLoad(const RendererTextureLoad load,
+                                                   SDL_GPUTexture **const texture,
+                                                   int *const width,
+                                                   int *const height) {
+    if (!loader_mutex) {
+        return RENDERER_TEXTURE_LOAD_FAILED;
+    }
+
+    SDL_LockMutex(loader_mutex);
+    TextureLoad *const entry = texture_loader_get(load);
+    if (!entry) {
+        SDL_UnlockMutex(loader_mutex);
+        return RENDERER_TEXTURE_LOAD_FAILED;
+    }
+    while (entry->state == TEXTURE_LOAD_QUEUED || entry->state == TEXTURE_LOAD_DECODING) {
+        SDL_WaitCondition(load_decoded, loader_mutex);
+    }
+
+    if (entry->state != TEXTURE_LOAD_DECODED) {
+        const RendererTextureLoadStatus status = texture_loader_finish(entry, texture, width, height);
+        SDL_UnlockMutex(loader_mutex);
+        return status;
+    }
+
+    // Not worth waiting for a frame's copy pass, there may be none yet. The load leaves the table first: creating the
+    // texture blocks on the GPU and must not hold up the workers or other loads.
+    RendererMipChain mips = entry->mips;
+    const int load_w = entry->width;
+    const int load_h = entry->height;
+    entry->mips = (RendererMipChain){0};
+    texture_loader_release(entry);
+    SDL_UnlockMutex(loader_mutex);
+
+    SDL_GPUTexture *const created = Renderer_CreateMipChainTexture(&mips);
+    Renderer_DestroyMipChain(&mips);
+    if (!created) {
+        return RENDERER_TEXTURE_LOAD_FAILED;
+    }
+    if (texture) {
+        *texture = created;
+    } else {
+        Renderer_DestroyTexture(created);
+    }
+    if (width) {
+        *width = load_w;
+    }
+    if (height) {
+        *height = load_h;
+    }
+    return RENDERER_TEXTURE_LOAD_READY;
+}
+
+void Renderer_CancelTextureLoad(const RendererTextureLoad load) {
+    if (!loader_mutex) {
+        return;
+    }
+
+    SDL_LockMutex(loader_mutex);
+    TextureLoad *const entry = texture_loader_get(load);
+    if (entry && entry->state == TEXTURE_LOAD_DECODING) {
+        entry->cancelled = true;
+    } else if (entry) {
+        texture_loader_release(entry);
+    }
+    SDL_UnlockMutex(loader_mutex);
+}
@@ -4,13 +4,14 @@
 
 #include "ui.h"
 
+#include "../memtrack.h"
 #include "SDL3/SDL_render.h"
 #include "SDL3_ttf/SDL_ttf.h"
 #include "renderer.h"
 
 #define UI_GEOMETRY_INITIAL_CAPACITY 4096
 #define UI_TEXT_INITIAL_CAPACITY 2048
-#define UI_TEXT_MAX_ATLASES 8
+#define UI_TEXT_INITIAL_RUNS 64
 
 typedef struct {
     SDL_Vertex *vertices;
@@ -18,90 +19,202 @@ typedef struct {
     int capacity;
 } GeometryBatch;
 
+// Indices appended for one atlas in a row. Runs of different atlases interleave as text is queued, they are grouped
+// into one contiguous range per atlas when the batch is handed to the renderer.
 typedef struct {
-    SDL_GPUTexture *atlas;
-    int start_vertex;
-    int vertex_count;
+    int atlas; // into TextBatch.atlases
     int start_index;
     int index_count;
-} TextAtlasRange;
+} TextRun;
 
 typedef struct {
-    float *vertices; // Interleaved: x, y, u, v (4 floats per vertex)
+    UITextVertex *vertices;
     int *indices;
     int vertex_count;
     int index_count;
     int vertex_capacity;
     int index_capacity;
-    TextAtlasRange atlases[UI_TEXT_MAX_ATLASES];
+    TextRun *runs;
+    int run_count;
+    int run_capacity;
+    UITextAtlasInfo *atlases; // distinct atlases in first use order, index_count sums their runs
     int atlas_count;
-    SDL_FColor current_color;
+    int atlas_capacity;
+    int last_atlas; // most sequences reuse the previous one's atlas
+    int *grouped_indices;
+    int grouped_capacity;
 } TextBatch;
 
-// Global batch state
-static GeometryBatch g_geometry = {};
-static TextBatch g_text = {};
+struct UIPanel {
+    RendererUIBlock block;
+    Uint64 content_hash;
+    bool valid; // the block holds the content for content_hash
+    GeometryBatch geometry;
+    TextBatch text;
+};
+
+// Global batch state. UI_* calls append to g_geometry/g_text, which point at a panel's batches while it is rebuilt.
+static GeometryBatch g_immediate_geometry = {};
+static TextBatch g_immediate_text = {};
+static GeometryBatch *g_geometry = &g_immediate_geometry;
+static TextBatch *g_text = &g_immediate_text;
+static SDL_FColor g_text_color = {1.0f, 1.0f, 1.0f, 1.0f};
 static UIBatchStats g_last_stats = {0};
+static int g_panels_reused = 0;
+static int g_panels_rebuilt = 0;
 
 // ============================================================================
 // Internal Helpers
 // ============================================================================
 
 static void geometry_ensure_capacity(const int additional) {
-    const int needed = g_geometry.count + additional;
-    if (needed <= g_geometry.capacity)
+    const int needed = g_geometry->count + additional;
+    if (needed <= g_geometry->capacity)
         return;
 
-    int new_capacity = g_geometry.capacity == 0 ? UI_GEOMETRY_INITIAL_CAPACITY : g_geometry.capacity * 2;
+    int new_capacity = g_geometry->capacity == 0 ? UI_GEOMETRY_INITIAL_CAPACITY : g_geometry->capacity * 2;
     while (new_capacity < needed)
         new_capacity *= 2;
 
-    g_geometry.vertices = SDL_realloc(g_geometry.vertices, sizeof(SDL_Vertex) * (size_t)new_capacity);
-    g_geometry.capacity = new_capacity;
+    MEM_TAG(MEM_TAG_UI);
+    g_geometry->vertices = SDL_realloc(g_geometry->vertices, sizeof(SDL_Vertex) * (size_t)new_capacity);
+    g_geometry->capacity = new_capacity;
 }
 
 static void text_ensure_capacity(const int add_verts, const int add_indices) {
+    MEM_TAG(MEM_TAG_UI);
     // Vertices
-    const int needed_v = g_text.vertex_count + add_verts;
-    if (needed_v > g_text.vertex_capacity) {
-        int new_cap = g_text.vertex_capacity == 0 ? UI_TEXT_INITIAL_CAPACITY : g_text.vertex_capacity * 2;
+    const int needed_v = g_text->vertex_count + add_verts;
+    if (needed_v > g_text->vertex_capacity) {
+        int new_cap = g_text->vertex_capacity == 0 ? UI_TEXT_INITIAL_CAPACITY : g_text->vertex_capacity * 2;
         while (new_cap < needed_v)
             new_cap *= 2;
-        g_text.vertices = SDL_realloc(g_text.vertices, sizeof(float) * 4 * (size_t)new_cap);
-        g_text.vertex_capacity = new_cap;
+        g_text->vertices = SDL_realloc(g_text->vertices, sizeof(UITextVertex) * (size_t)new_cap);
+        g_text->vertex_capacity = new_cap;
     }
 
     // Indices
-    const int needed_i = g_text.index_count + add_indices;
-    if (needed_i > g_text.index_capacity) {
-        int new_cap = g_text.index_capacity == 0 ? UI_TEXT_INITIAL_CAPACITY : g_text.index_capacity * 2;
+    const int needed_i = g_text->index_count + add_indices;
+    if (needed_i > g_text->index_capacity) {
+        int new_cap = g_text->index_capacity == 0 ? UI_TEXT_INITIAL_CAPACITY : g_text->index_capacity * 2;
         while (new_cap < needed_i)
             new_cap *= 2;
-        g_text.indices = SDL_realloc(g_text.indices, sizeof(int) * (size_t)new_cap);
-        g_text.index_capacity = new_cap;
+        g_text->indices = SDL_realloc(g_text->indices, sizeof(int) * (size_t)new_cap);
+        g_text->index_capacity = new_cap;
     }
 }
 
-static TextAtlasRange *text_get_atlas_range(SDL_GPUTexture *const atlas) {
-    // Look for existing range with this atlas
-    for (int i = 0; i < g_text.atlas_count; i++) {
-        if (g_text.atlases[i].atlas == atlas)
-            return &g_text.atlases[i];
+static void geometry_batch_free(GeometryBatch *const batch) {
+    SDL_free(batch->vertices);
+    *batch = (GeometryBatch){0};
+}
+
+static void text_batch_free(TextBatch *const batch) {
+    SDL_free(batch->vertices);
+    SDL_free(batch->indices);
+    SDL_free(batch->runs);
+    SDL_free(batch->atlases);
+    SDL_free(batch->grouped_indices);
+    *batch = (TextBatch){0};
+}
+
+static void text_batch_reset(TextBatch *const batch) {
+    batch->vertex_count = 0;
+    batch->index_count = 0;
+    batch->run_count = 0;
+    batch->atlas_count = 0;
+    batch->last_atlas = 0;
+}
+
+// Capacity holding `needed` elements, doubling from `initial`
+static int text_grown_capacity(const int capacity, const int needed, const int initial) {
+    int new_capacity = capacity == 0 ? initial : capacity * 2;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+    return new_capacity;
+}
+
+// Slot of `atlas` in the batch's atlas table, added on first use. No limit: CJK text easily spans many atlas pages.
+static int text_get_atlas(SDL_GPUTexture *const atlas) {
+    if (g_text->last_atlas < g_text->atlas_count && g_text->atlases[g_text->last_atlas].atlas == atlas)
+        return g_text->last_atlas;
+
+    for (int i = 0; i < g_text->atlas_count; i++) {
+        if (g_text->atlases[i].atlas == atlas) {
+            g_text->last_atlas = i;
+            return i;
+        }
     }
 
-    // Create new range
-    if (g_text.atlas_count >= UI_TEXT_MAX_ATLASES) {
-        SDL_Log("Warning: UI text batch exceeded max atlas count!");
-        return nullptr;
+    if (g_text->atlas_count == g_text->atlas_capacity) {
+        MEM_TAG(MEM_TAG_UI);
+        const int capacity = text_grown_capacity(g_text->atlas_capacity, g_text->atlas_count + 1, 8);
+        UITextAtlasInfo *const atlases = SDL_realloc(g_text->atlases, sizeof(UITextAtlasInfo) * (size_t)capacity);
+        if (!atlases)
+            return -1;
+        g_text->atlases = atlases;
+        g_text->atlas_capacity = capacity;
     }
+    g_text->atlases[g_text->atlas_count] = (UITextAtlasInfo){.atlas = atlas, .start_index = 0, .index_count = 0};
+    g_text->last_atlas = g_text->atlas_count;
+    return g_text->atlas_count++;
+}
 
-    TextAtlasRange *range = &g_text.atlases[g_text.atlas_count++];
-    range->atlas = atlas;
-    range->start_vertex = g_text.vertex_count;
-    range->vertex_count = 0;
-    range->start_index = g_text.index_count;
-    range->index_count = 0;
-    return range;
+// Records `index_count` indices about to be appended for `atlas`, extending the last run when it has the same atlas
+static bool text_add_run(const int atlas, const int index_count) {
+    if (g_text->run_count > 0 && g_text->runs[g_text->run_count - 1].atlas == atlas) {
+        g_text->runs[g_text->run_count - 1].index_count += index_count;
+    } else {
+        if (g_text->run_count == g_text->run_capacity) {
+            MEM_TAG(MEM_TAG_UI);
+            const int capacity = text_grown_capacity(g_text->run_capacity, g_text->run_count + 1, UI_TEXT_INITIAL_RUNS);
+            TextRun *const runs = SDL_realloc(g_text->runs, sizeof(TextRun) * (size_t)capacity);
+            if (!runs)
+                return false;
+            g_text->runs = runs;
+            g_text->run_capacity = capacity;
+        }
+        g_text->runs[g_text->run_count++] =
+            (TextRun){.atlas = atlas, .start_index = g_text->index_count, .index_count = index_count};
+    }
+    g_text->atlases[atlas].index_count += index_count;
+    return true;
+}
+
+// Counting sort of the runs by atlas, so each atlas is one contiguous index range and one draw call whatever order the
+// text was queued in. Sets the atlases' start_index, returns the grouped indices (nullptr if out of memory).
+static const int *text_group_by_atlas(TextBatch *const batch) {
+    if (batch->atlas_count <= 1) {
+        // one atlas: every index is already in its only run
+        return batch->indices;
+    }
+    if (batch->index_count > batch->grouped_capacity) {
+        MEM_TAG(MEM_TAG_UI);
+        const int capacity =
+            text_grown_capacity(batch->grouped_capacity, batch->index_count, UI_TEXT_INITIAL_CAPACITY);
+        int *const grouped = SDL_realloc(batch->grouped_indices, sizeof(int) * (size_t)capacity);
+        if (!grouped)
+            return nullptr;
+        batch->grouped_indices = grouped;
+        batch->grouped_capacity = capacity;
+    }
+
+    // start_index is the atlas' offset, index_count is reused as its write cursor and ends back at its total
+    int start = 0;
+    for (int i = 0; i < batch->atlas_count; i++) {
+        batch->atlases[i].start_index = start;
+        start += batch->atlases[i].index_count;
+        batch->atlases[i].index_count = 0;
+    }
+    for (int i = 0; i < batch->run_count; i++) {
+        const TextRun *const run = &batch->runs[i];
+        UITextAtlasInfo *const atlas = &batch->atlases[run->atlas];
+        SDL_memcpy(batch->grouped_indices + atlas->start_index + atlas->index_count,
+                   batch->indices + run->start_index,
+                   sizeof(int) * (size_t)run->index_count);
+        atlas->index_count += run->index_count;
+    }
+    return batch->grouped_indices;
 }
 
 // ============================================================================
@@ -113,29 +226,104 @@ void UI_Init(void) {
     geometry_ensure_capacity(UI_GEOMETRY_INITIAL_CAPACITY);
     text_ensure_capacity(UI_TEXT_INITIAL_CAPACITY, UI_TEXT_INITIAL_CAPACITY);
 
-    g_text.current_color = (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f};
+    g_text_color = (SDL_FColor){1.0f, 1.0f, 1.0f, 1.0f};
 }
 
 void UI_Shutdown(void) {
-    if (g_geometry.vertices) {
-        SDL_free(g_geometry.vertices);
-        g_geometry.vertices = nullptr;
-        g_geometry.count = 0;
-        g_geometry.capacity = 0;
+    g_geometry = &g_immediate_geometry;
+    g_text = &g_immediate_text;
+    geometry_batch_free(&g_immediate_geometry);
+    text_batch_free(&g_immediate_text);
+}
+
+// ============================================================================
+// Public API - Retained Panels
+// ============================================================================
+
+UIPanel *UI_CreatePanel(void) {
+    MEM_TAG(MEM_TAG_UI);
+    UIPanel *const panel = SDL_calloc(1, sizeof(UIPanel));
+    if (!panel)
+        return nullptr;
+
+    panel->block = Renderer_CreateUIBlock();
+    if (!panel->block) {
+        SDL_free(panel);
+        return nullptr;
     }
-    if (g_text.vertices) {
-        SDL_free(g_text.vertices);
-        g_text.vertices = nullptr;
+    return panel;
+}
+
+void UI_DestroyPanel(UIPanel *const panel) {
+    if (!panel)
+        return;
+
+    if (g_geometry == &panel->geometry) {
+        g_geometry = &g_immediate_geometry;
+        g_text = &g_immediate_text;
     }
-    if (g_text.indices) {
-        SDL_free(g_text.indices);
-        g_text.indices = nullptr;
+    Renderer_DestroyUIBlock(panel->block);
+    geometry_batch_free(&panel->geometry);
+    text_batch_free(&panel->text);
+    SDL_free(panel);
+}
+
+bool UI_BeginPanel(UIPanel *const panel, const Uint64 content_hash) {
+    if (!panel)
+        return false;
+    if (g_geometry != &g_immediate_geometry) {
+        SDL_Log("Warning: UI panels cannot be nested!");
+        return false;
+    }
+
+    if (panel->valid && panel->content_hash == content_hash) {
+        Renderer_DrawUIBlock(panel->block);
+        g_panels_reused++;
+        return false;
     }
-    g_text.vertex_count = 0;
-    g_text.index_count = 0;
-    g_text.vertex_capacity = 0;
-    g_text.index_capacity = 0;
-    g_text.atlas_count = 0;
+
+    panel->content_hash = content_hash;
+    panel->geometry.count = 0;
+    text_batch_reset(&panel->text);
+    g_geometry = &panel->geometry;
+    g_text = &panel->text;
+    return true;
+}
+
+void UI_EndPanel(UIPanel *const panel) {
+    if (!panel || g_geometry != &panel->geometry)
+        return;
+
+    g_geometry = &g_immediate_geometry;
+    g_text = &g_immediate_text;
+
+    const int *const text_indices = text_group_by_atlas(&panel->text);
+    panel->valid = Renderer_UpdateUIBlock(panel->block,
+                                          panel->geometry.vertices,
+                                          panel->geometry.count,
+                                          panel->text.vertices,
+                                          text_indices ? panel->text.vertex_count : 0,
+                                          text_indices,
+                                          panel->text.index_count,
+                                          panel->text.atlases,
+                                          panel->text.atlas_count);
+    if (panel->valid) {
+        Renderer_DrawUIBlock(panel->block);
+    }
+    g_panels_rebuilt++;
+}
+
+Uint64 UI_HashBytes(Uint64 hash, const void *const data, const size_t size) {
+    // FNV-1a, pass 0 to start a new hash
+    if (hash == 0) {
+        hash = 14695981039346656037ULL;
+    }
+    const Uint8 *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
 }
 
 // ============================================================================
@@ -144,7 +332,7 @@ void UI_Shutdown(void) {
 
 void UI_FillRect(const float x, const float y, const float w, const float h, const SDL_FColor color) {
     geometry_ensure_capacity(6);
-    SDL_Vertex *v = g_geometry.vertices + g_geometry.count;
+    SDL_Vertex *v = g_geometry->vertices + g_geometry->count;
 
     // Two triangles for a quad
     v[0] = (SDL_Vertex){{x, y}, color, {0, 0}};
@@ -154,7 +342,7 @@ void UI_FillRect(const float x, const float y, const float w, const float h, con
     v[4] = (SDL_Vertex){{x + w, y + h}, color, {0, 0}};
     v[5] = (SDL_Vertex){{x, y + h}, color, {0, 0}};
 
-    g_geometry.count += 6;
+    g_geometry->count += 6;
 }
 
 void UI_RectOutline(
@@ -180,7 +368,7 @@ void UI_Line(
     const float ny = dx / len * thickness * 0.5f;
 
     geometry_ensure_capacity(6);
-    SDL_Vertex *v = g_geometry.vertices + g_geometry.count;
+    SDL_Vertex *v = g_geometry->vertices + g_geometry->count;
 
     v[0] = (SDL_Vertex){{x1 + nx, y1 + ny}, color, {0, 0}};
     v[1] = (SDL_Vertex){{x2 + nx, y2 + ny}, color, {0, 0}};
@@ -189,7 +377,7 @@ void UI_Line(
     v[4] = (SDL_Vertex){{x1 - nx, y1 - ny}, color, {0, 0}};
     v[5] = (SDL_Vertex){{x1 + nx, y1 + ny}, color, {0, 0}};
 
-    g_geometry.count += 6;
+    g_geometry->count += 6;
 }
 
 // ============================================================================
@@ -222,46 +410,58 @@ void UI_TextWithBackgroundEx(
 }
 
 void UI_Text(TTF_Text *const text, const float x, const float y) {
-    UI_TextColored(text, x, y, g_text.current_color);
+    UI_TextColored(text, x, y, g_text_color);
 }
 
-void UI_TextColored(TTF_Text *const text, const float x, const float y, const SDL_FColor color) {
-    (void)color; // TODO: Per-text coloring would require shader changes
+static Uint8 color_byte(const float channel) {
+    const float clamped = channel < 0.0f ? 0.0f : (channel > 1.0f ? 1.0f : channel);
+    return (Uint8)(clamped * 255.0f + 0.5f);
+}
 
+void UI_TextColored(TTF_Text *const text, const float x, const float y, const SDL_FColor color) {
     if (!text)
         return;
 
+    const Uint8 r = color_byte(color.r);
+    const Uint8 g = color_byte(color.g);
+    const Uint8 b = color_byte(color.b);
+    const Uint8 a = color_byte(color.a);
+
     const TTF_GPUAtlasDrawSequence *seq = TTF_GetGPUTextDrawData(text);
 
     while (seq) {
-        TextAtlasRange *range = text_get_atlas_range(seq->atlas_texture);
-        if (!range) {
+        const int atlas = text_get_atlas(seq->atlas_texture);
+        if (atlas < 0 || !text_add_run(atlas, seq->num_indices)) {
             seq = seq->next;
             continue;
         }
 
         text_ensure_capacity(seq->num_vertices, seq->num_indices);
 
-        // Copy vertex data with position offset and Y flip
-        float *dst = g_text.vertices + g_text.vertex_count * 4;
+        // Copy vertex data with position offset and Y flip, the tint travels with each vertex
+        UITextVertex *dst = g_text->vertices + g_text->vertex_count;
         for (int i = 0; i < seq->num_vertices; i++) {
-            dst[i * 4 + 0] = seq->xy[i].x + x;
-            dst[i * 4 + 1] = -seq->xy[i].y + y; // Flip Y for screen-space
-            dst[i * 4 + 2] = seq->uv[i].x;
-            dst[i * 4 + 3] = seq->uv[i].y;
+            dst[i] = (UITextVertex){
+                .x = seq->xy[i].x + x,
+                .y = -seq->xy[i].y + y, // Flip Y for screen-space
+                .u = seq->uv[i].x,
+                .v = seq->uv[i].y,
+                .r = r,
+                .g = g,
+                .b = b,
+                .a = a,
+            };
         }
 
         // Copy indices with offset adjustment
-        const int base_vertex = g_text.vertex_count;
-        int *idx_dst = g_text.indices + g_text.index_count;
+        const int base_vertex = g_text->vertex_count;
+        int *idx_dst = g_text->indices + g_text->index_count;
         for (int i = 0; i < seq->num_indices; i++) {
             idx_dst[i] = seq->indices[i] + base_vertex;
         }
 
-        g_text.vertex_count += seq->num_vertices;
-        g_text.index_count += seq->num_indices;
-        range->vertex_count += seq->num_vertices;
-        range->index_count += seq->num_indices;
+        g_text->vertex_count += seq->num_vertices;
+        g_text->index_count += seq->num_indices;
 
         seq = seq->next;
     }
@@ -272,36 +472,40 @@ void UI_TextColored(TTF_Text *const text, const float x, const float y, const SD
 // ============================================================================
 
 void UI_Flush(void) {
+    if (g_geometry != &g_immediate_geometry) {
+        SDL_Log("Warning: UI_Flush called inside a panel, its content is dropped!");
+        g_geometry = &g_immediate_geometry;
+        g_text = &g_immediate_text;
+    }
+    GeometryBatch *const geometry = &g_immediate_geometry;
+    TextBatch *const text = &g_immediate_text;
+
     // Record stats before flushing
-    g_last_stats.geometry_vertices = g_geometry.count;
-    g_last_stats.geometry_draw_calls = (g_geometry.count > 0) ? 1 : 0;
-    g_last_stats.text_vertices = g_text.vertex_count;
-    g_last_stats.text_indices = g_text.index_count;
-    g_last_stats.text_atlas_count = g_text.atlas_count;
-    g_last_stats.text_draw_calls = g_text.atlas_count;
+    g_last_stats.geometry_vertices = geometry->count;
+    g_last_stats.geometry_draw_calls = (geometry->count > 0) ? 1 : 0;
+    g_last_stats.text_vertices = text->vertex_count;
+    g_last_stats.text_indices = text->index_count;
+    g_last_stats.text_atlas_count = text->atlas_count;
+    g_last_stats.text_draw_calls = text->atlas_count;
+    g_last_stats.panels_reused = g_panels_reused;
+    g_last_stats.panels_rebuilt = g_panels_rebuilt;
+    g_panels_reused = 0;
+    g_panels_rebuilt = 0;
 
     // Flush geometry batch
-    if (g_geometry.count > 0) {
-        Renderer_FlushUIGeometry(g_geometry.vertices, g_geometry.count);
-        g_geometry.count = 0;
+    if (geometry->count > 0) {
+        Renderer_FlushUIGeometry(geometry->vertices, geometry->count);
+        geometry->count = 0;
     }
 
-    // Flush text batch
-    if (g_text.vertex_count > 0) {
-        // Build atlas info for renderer
-        UITextAtlasInfo atlas_info[UI_TEXT_MAX_ATLASES];
-        for (int i = 0; i < g_text.atlas_count; i++) {
-            atlas_info[i].atlas = g_text.atlases[i].atlas;
-            atlas_info[i].start_index = g_text.atlases[i].start_index;
-            atlas_info[i].index_count = g_text.atlases[i].index_count;
+    // Flush text batch, grouped into one index range per atlas
+    if (text->vertex_count > 0) {
+        const int *const indices = text_group_by_atlas(text);
+        if (indices) {
+            Renderer_FlushUIText(
+                text->vertices, text->vertex_count, indices, text->index_count, text->atlases, text->atlas_count);
         }
-
-        Renderer_FlushUIText(
-            g_text.vertices, g_text.vertex_count, g_text.indices, g_text.index_count, atlas_info, g_text.atlas_count);
-
-        g_text.vertex_count = 0;
-        g_text.index_count = 0;
-        g_text.atlas_count = 0;
+        text_batch_reset(text);
     }
 }
 
@@ -38,7 +38,7 @@ void UI_Shutdown(void);
 void UI_TextWithBackground(TTF_Text *text, float x, float y);
 void UI_TextWithBackgroundEx(TTF_Text *text, float x, float y, SDL_FColor bg_color, float padding);
 
-// Text rendering
+// Text rendering. The color is stored per vertex, mixed colors still share one draw call per atlas
 void UI_Text(TTF_Text *text, float x, float y);
 void UI_TextColored(TTF_Text *text, float x, float y, SDL_FColor color);
 
@@ -49,6 +49,33 @@ void UI_RectOutline(float x, float y, float w, float h, SDL_FColor color, float
 // Lines
 void UI_Line(float x1, float y1, float x2, float y2, SDL_FColor color, float thickness);
 
+// ============================================================================
+// Retained Panels - Reuse last frame's geometry when the content is unchanged
+// ============================================================================
+// A panel keeps its geometry and text in a GPU buffer. Hash everything the panel's content depends on (formatted
+// strings, positions, colors) and only issue its UI_* calls when the hash changed:
+//
+//   if (UI_BeginPanel(hud, UI_HashBytes(0, label, SDL_strlen(label)))) {
+//       UI_TextWithBackground(text, 10, 10);
+//       UI_EndPanel(hud);
+//   }
+//
+// An unchanged panel costs no CPU batching and no upload. Panel geometry draws after the immediate geometry and
+// panel text after the immediate text, like one more batch. Panels cannot be nested.
+
+typedef struct UIPanel UIPanel;
+
+UIPanel *UI_CreatePanel(void);
+void UI_DestroyPanel(UIPanel *panel);
+
+// Returns true if the panel must be rebuilt: issue its UI_* calls, then UI_EndPanel(). On false the previous content
+// is queued again and UI_EndPanel() must not be called.
+bool UI_BeginPanel(UIPanel *panel, Uint64 content_hash);
+void UI_EndPanel(UIPanel *panel);
+
+// FNV-1a over size bytes, chain calls by passing the previous result (0 starts a new hash)
+Uint64 UI_HashBytes(Uint64 hash, const void *data, size_t size);
+
 // ============================================================================
 // Flush API - Execute all queued commands
 // ============================================================================
@@ -65,6 +92,8 @@ typedef struct {
     int text_indices;
     int text_atlas_count;
     int text_draw_calls;
+    int panels_reused;
+    int panels_rebuilt;
 } UIBatchStats;
 
 UIBatchStats UI_GetStats(void);
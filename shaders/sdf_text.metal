@@ -0,0 +1,73 @@
+#include <metal_stdlib>
+using namespace metal;
+
+// Must match C struct RendererSDFGlyph exactly (32 bytes):
+// typedef struct {
+//   float x, y;          // top-left corner in world units
+//   float w, h;          // quad size in world units
+//   Uint16 u, v, uw, vh; // atlas rectangle, normalized to 0-65535
+//   Uint32 color;        // RGBA8, red in the lowest byte
+//   float bias;          // added to the sampled distance
+// } RendererSDFGlyph;
+struct GlyphInstance {
+    float2 origin;
+    float2 size;
+    ushort4 rect;
+    uint color;
+    float bias;
+};
+
+struct Uniforms {
+    float4x4 viewProjection;
+};
+
+struct VertexOut {
+    float4 position [[position]];
+    float2 uv;
+    float4 color;
+    float bias;
+};
+
+vertex VertexOut vertex_sdf_text(
+    uint vertexID [[vertex_id]],
+    uint instanceID [[instance_id]],
+    constant Uniforms &uniforms [[buffer(0)]],
+    const device GlyphInstance *glyphs [[buffer(1)]]
+) {
+    const GlyphInstance glyph = glyphs[instanceID];
+
+    const float2 corners[6] = {
+        float2(0.0, 0.0),
+        float2(1.0, 0.0),
+        float2(0.0, 1.0),
+        float2(0.0, 1.0),
+        float2(1.0, 0.0),
+        float2(1.0, 1.0)
+    };
+    const float2 corner = corners[vertexID];
+    const float4 rect = float4(glyph.rect) / 65535.0;
+
+    VertexOut out;
+    // z=0 like the geometry pipeline, the pipeline has no depth test
+    out.position = uniforms.viewProjection * float4(glyph.origin + corner * glyph.size, 0.0, 1.0);
+    out.uv = rect.xy + corner * rect.zw;
+    out.color = unpack_unorm4x8_to_float(glyph.color);
+    out.bias = glyph.bias;
+    return out;
+}
+
+// The atlas holds distances with the glyph outline at 0.5. Antialiasing over one screen pixel, whatever the zoom,
+// keeps edges sharp when magnified and stops them from shimmering when minified.
+fragment float4 fragment_sdf_text(
+    VertexOut in [[stage_in]],
+    texture2d<float> atlas [[texture(0)]],
+    sampler smp [[sampler(0)]]
+) {
+    const float distance = atlas.sample(smp, in.uv).r + in.bias;
+    const float width = max(fwidth(distance) * 0.5, 1e-4);
+    const float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+    if (coverage <= 0.0) {
+        discard_fragment();
+    }
+    return float4(in.color.rgb, in.color.a * coverage);
+}
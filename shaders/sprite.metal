@@ -13,6 +13,14 @@ struct InstanceData {
     float4 texRegion;     // u, v, uw, vh
 };
 
+// Must match C struct SpriteLayerInstance (64 bytes): a SpriteInstance, then the texture array layer
+struct LayeredInstanceData {
+    float4 position;
+    float4 size;
+    float4 texRegion;
+    float4 layer;         // x = texture array layer, yzw padding
+};
+
 struct Uniforms {
     float4x4 viewProjection;
     float4 waterParams;   // x=time, y=speed, z=amplitude, w=phase
@@ -23,14 +31,14 @@ struct VertexOut {
     float2 texCoord;
 };
 
-vertex VertexOut vertex_main(
-    uint vertexID [[vertex_id]],
-    uint instanceID [[instance_id]],
-    constant Uniforms &uniforms [[buffer(0)]],
-    const device InstanceData *instances [[buffer(1)]]
-) {
-    InstanceData instance = instances[instanceID];
+struct LayeredVertexOut {
+    float4 position [[position]];
+    float2 texCoord;
+    uint layer [[flat]];
+};
 
+// Shared by both sprite pipelines, they only differ in how the texture is addressed
+static VertexOut sprite_vertex(uint vertexID, InstanceData instance, constant Uniforms &uniforms) {
     // Standard quad vertices (0,0 to 1,1)
     float2 quadVerts[6] = {
         float2(0.0, 0.0),
@@ -87,6 +95,32 @@ vertex VertexOut vertex_main(
     return out;
 }
 
+vertex VertexOut vertex_main(
+    uint vertexID [[vertex_id]],
+    uint instanceID [[instance_id]],
+    constant Uniforms &uniforms [[buffer(0)]],
+    const device InstanceData *instances [[buffer(1)]]
+) {
+    return sprite_vertex(vertexID, instances[instanceID], uniforms);
+}
+
+vertex LayeredVertexOut vertex_layered(
+    uint vertexID [[vertex_id]],
+    uint instanceID [[instance_id]],
+    constant Uniforms &uniforms [[buffer(0)]],
+    const device LayeredInstanceData *instances [[buffer(1)]]
+) {
+    LayeredInstanceData instance = instances[instanceID];
+    InstanceData sprite = {instance.position, instance.size, instance.texRegion};
+    VertexOut base = sprite_vertex(vertexID, sprite, uniforms);
+
+    LayeredVertexOut out;
+    out.position = base.position;
+    out.texCoord = base.texCoord;
+    out.layer = uint(instance.layer.x + 0.5);
+    return out;
+}
+
 fragment float4 fragment_main(
     VertexOut in [[stage_in]],
     texture2d<float> spriteTexture [[texture(0)]],
@@ -98,3 +132,15 @@ fragment float4 fragment_main(
     }
     return color;
 }
+
+fragment float4 fragment_layered(
+    LayeredVertexOut in [[stage_in]],
+    texture2d_array<float> spriteTextures [[texture(0)]],
+    sampler textureSampler [[sampler(0)]]
+) {
+    float4 color = spriteTextures.sample(textureSampler, in.texCoord, in.layer);
+    if (color.a < 0.1) {
+        discard_fragment();
+    }
+    return color;
+}
@@ -4,19 +4,23 @@ using namespace metal;
 struct TextVertexInput {
     float2 position [[attribute(0)]];
     float2 uv [[attribute(1)]];
+    float4 color [[attribute(2)]];
 };
 
 struct TextVertexOut {
     float4 position [[position]];
     float2 uv;
+    float4 color;
 };
 
 struct LineVertexInput {
     float3 position [[attribute(0)]];
+    float4 color [[attribute(1)]];
 };
 
 struct LineVertexOut {
     float4 position [[position]];
+    float4 color;
 };
 
 struct Uniforms {
@@ -31,17 +35,18 @@ vertex TextVertexOut vertex_text(
     TextVertexOut out;
     out.position = uniforms.projection * float4(in.position, 0.0, 1.0);
     out.uv = in.uv;
+    out.color = in.color;
     return out;
 }
 
+// Color is per vertex, so differently tinted labels sharing an atlas stay in one draw call
 fragment float4 fragment_text(
     TextVertexOut in [[stage_in]],
     texture2d<float> atlas [[texture(0)]],
-    sampler smp [[sampler(0)]],
-    constant float4 &color [[buffer(0)]]
+    sampler smp [[sampler(0)]]
 ) {
     float4 sample = atlas.sample(smp, in.uv);
-    return sample * color;
+    return sample * in.color;
 }
 
 // Line Shader
@@ -51,12 +56,12 @@ vertex LineVertexOut vertex_line(
 ) {
     LineVertexOut out;
     out.position = uniforms.projection * float4(in.position, 1.0);
+    out.color = in.color;
     return out;
 }
 
 fragment float4 fragment_line(
-    LineVertexOut in [[stage_in]],
-    constant float4 &color [[buffer(0)]]
+    LineVertexOut in [[stage_in]]
 ) {
-    return color;
+    return in.color;
 }
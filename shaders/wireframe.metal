@@ -0,0 +1,131 @@
+#include <metal_stdlib>
+using namespace metal;
+
+// Must match C struct RendererWireframeInstance exactly (32 bytes):
+// typedef struct {
+//   float x, y;                  // ground-level left corner of the footprint
+//   float tile_w, tile_h;        // iso tile size
+//   float width, length, levels; // footprint in tiles, height in levels
+//   Uint32 color;                // RGBA8, red in the lowest byte
+// } RendererWireframeInstance;
+struct WireframeInstance {
+    float2 origin;
+    float2 tile;
+    float width;
+    float length;
+    float levels;
+    uint color;
+};
+
+struct Uniforms {
+    float4x4 viewProjection;
+};
+
+struct VertexOut {
+    float4 position [[position]];
+    float4 color;
+};
+
+constant float kThickness = 1.0; // world units, same as the old CPU-built quads
+
+// Edge `segment` of a box with the visible faces (front-width, front-length, roof) and their tile grid.
+// Collinear unit edges are merged, so a box has 2 * (width + length + levels) + 3 segments.
+static bool wireframe_segment(const WireframeInstance inst, uint segment, thread float2 &a, thread float2 &b) {
+    const uint w = uint(inst.width);
+    const uint l = uint(inst.length);
+    const uint h = uint(inst.levels);
+    const float2 dw = float2(inst.tile.x * 0.5, inst.tile.y * 0.5);  // one tile along the width
+    const float2 dl = float2(inst.tile.x * 0.5, -inst.tile.y * 0.5); // one tile along the length
+    const float2 up = float2(0.0, -inst.tile.y);                     // one level
+    const float2 o = inst.origin;
+
+    // width face: one horizontal per level, one vertical per tile
+    if (segment <= h) {
+        a = o + float(segment) * up;
+        b = a + float(w) * dw;
+        return true;
+    }
+    segment -= h + 1;
+    if (segment < w) {
+        a = o + float(segment) * dw;
+        b = a + float(h) * up;
+        return true;
+    }
+    segment -= w;
+
+    // length face, its first vertical is the shared corner
+    const float2 corner = o + float(w) * dw;
+    if (segment <= h) {
+        a = corner + float(segment) * up;
+        b = a + float(l) * dl;
+        return true;
+    }
+    segment -= h + 1;
+    if (segment <= l) {
+        a = corner + float(segment) * dl;
+        b = a + float(h) * up;
+        return true;
+    }
+    segment -= l + 1;
+
+    // roof grid, the front edges are the faces' top horizontals
+    const float2 roof = o + float(h) * up;
+    if (segment < l) {
+        a = roof + float(segment + 1) * dl;
+        b = a + float(w) * dw;
+        return true;
+    }
+    segment -= l;
+    if (segment < w) {
+        a = roof + float(segment) * dw;
+        b = a + float(l) * dl;
+        return true;
+    }
+    return false;
+}
+
+// Six vertices per segment, expanded into a quad. Every instance of a draw gets the same vertex count (the largest
+// box's), smaller boxes collapse their extra segments to a point outside the clip volume.
+vertex VertexOut vertex_wireframe(
+    uint vertexID [[vertex_id]],
+    uint instanceID [[instance_id]],
+    constant Uniforms &uniforms [[buffer(0)]],
+    const device WireframeInstance *instances [[buffer(1)]]
+) {
+    const WireframeInstance inst = instances[instanceID];
+
+    VertexOut out;
+    out.color = unpack_unorm4x8_to_float(inst.color);
+
+    float2 a;
+    float2 b;
+    const float len = wireframe_segment(inst, vertexID / 6, a, b) ? distance(a, b) : 0.0;
+    if (len < 1e-6) {
+        out.position = float4(2.0, 2.0, 2.0, 1.0);
+        return out;
+    }
+
+    // (along, side) of the quad corners: a+n, b+n, b-n, b-n, a-n, a+n
+    const float2 corners[6] = {
+        float2(0.0, 1.0),
+        float2(1.0, 1.0),
+        float2(1.0, -1.0),
+        float2(1.0, -1.0),
+        float2(0.0, -1.0),
+        float2(0.0, 1.0)
+    };
+    const float2 corner = corners[vertexID % 6];
+    const float2 dir = (b - a) / len;
+    const float2 normal = float2(-dir.y, dir.x) * (kThickness * 0.5);
+    const float2 world = mix(a, b, corner.x) + normal * corner.y;
+
+    // z=0 like the geometry pipeline
+    out.position = uniforms.viewProjection * float4(world, 0.0, 1.0);
+    return out;
+}
+
+fragment float4 fragment_wireframe(
+    VertexOut in [[stage_in]]
+) {
+    return in.color;
+}
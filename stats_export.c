@@ -0,0 +1,189 @@
+#include "stats_export.h"
+
+#include "SDL3/SDL.h"
+#include "profiler.h"
+#include "renderer/renderer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STATS_EXPORT_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+typedef struct StatsExport {
+    StatsShm *shm;
+    char name[STATS_SHM_NAME_LENGTH];
+    StatsShmSim sim;
+    StatsShmFrame staging; // built outside the seqlock so readers only ever wait for one memcpy
+    uint64_t frame_index;
+} StatsExport;
+
+static StatsExport stats_export = {0};
+
+bool STATS_exportOpen(const char *name) {
+    if (stats_export.shm) {
+        return true;
+    }
+    if (!name) {
+        name = STATS_SHM_DEFAULT_NAME;
+    }
+
+#ifdef STATS_EXPORT_POSIX
+    const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Stats export: shm_open(%s) failed", name);
+        return false;
+    }
+    if (ftruncate(fd, (off_t)sizeof(StatsShm)) != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Stats export: failed to size %s", name);
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    void *const mapping = mmap(nullptr, sizeof(StatsShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the segment alive
+    if (mapping == MAP_FAILED) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Stats export: failed to map %s", name);
+        shm_unlink(name);
+        return false;
+    }
+
+    StatsShm *const shm = mapping;
+    SDL_memset(shm, 0, sizeof(*shm));
+    shm->version = STATS_SHM_VERSION;
+    shm->size = (uint32_t)sizeof(StatsShm);
+    shm->writer_pid = (uint32_t)getpid();
+    atomic_store_explicit(&shm->sequence, 0u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    shm->magic = STATS_SHM_MAGIC; // last, readers check it first
+
+    stats_export.shm = shm;
+    stats_export.frame_index = 0;
+    SDL_strlcpy(stats_export.name, name, sizeof(stats_export.name));
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Stats export: publishing to shared memory %s", name);
+    return true;
+#else
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Stats export: shared memory is not supported on this platform");
+    return false;
+#endif
+}
+
+void STATS_exportClose(void) {
+    if (!stats_export.shm) {
+        return;
+    }
+#ifdef STATS_EXPORT_POSIX
+    munmap(stats_export.shm, sizeof(StatsShm));
+    shm_unlink(stats_export.name);
+#endif
+    stats_export.shm = nullptr;
+}
+
+bool STATS_exportIsOpen(void) {
+    return stats_export.shm != nullptr;
+}
+
+void STATS_exportSetSim(const StatsShmSim *const sim) {
+    if (sim) {
+        stats_export.sim = *sim;
+        stats_export.sim.valid = 1;
+    }
+}
+
+static void build_profiler_stats(StatsShmFrame *const frame) {
+    frame->frame_ms = PROF_getLastFrameTime();
+    PROF_getFPS(&frame->fps_min, &frame->fps_avg, &frame->fps_max);
+
+    ProfilerPercentiles percentiles;
+    if (PROF_getPercentiles(PROFILER_FRAME_TOTAL, &percentiles)) {
+        frame->p50_ms = percentiles.p50;
+        frame->p95_ms = percentiles.p95;
+        frame->p99_ms = percentiles.p99;
+        frame->p999_ms = percentiles.p999;
+        frame->max_ms = percentiles.max;
+    }
+
+    frame->category_count = 0;
+    for (ProfilerSampleCategory category = 0;
+         category < PROFILER_CATEGORY_COUNT && frame->category_count < STATS_SHM_MAX_CATEGORIES;
+         category++) {
+        StatsShmCategory *const out = &frame->categories[frame->category_count++];
+        SDL_strlcpy(out->name, PROF_getCategoryName(category), sizeof(out->name));
+        out->ms = PROF_getLastCategoryTime(category);
+        out->p99_ms = PROF_getPercentiles(category, &percentiles) ? percentiles.p99 : 0.0f;
+    }
+
+    const ProfilerLaneStats *lanes = nullptr;
+    const int lane_count = PROF_getLaneStats(&lanes);
+    frame->lane_count = 0;
+    for (int i = 0; i < lane_count && frame->lane_count < STATS_SHM_MAX_LANES; i++) {
+        StatsShmLane *const out = &frame->lanes[frame->lane_count++];
+        SDL_strlcpy(out->name, lanes[i].name, sizeof(out->name));
+        out->busy_ms = lanes[i].busy_ms;
+        out->utilization = lanes[i].utilization;
+    }
+
+    // parents come before their children, so truncating the list never leaves a dangling parent index
+    const ProfilerZoneStats *zones = nullptr;
+    const int zone_count = PROF_getZoneStats(&zones);
+    frame->zone_count = 0;
+    for (int i = 0; i < zone_count && frame->zone_count < STATS_SHM_MAX_ZONES; i++) {
+        StatsShmZone *const out = &frame->zones[frame->zone_count++];
+        SDL_strlcpy(out->name, zones[i].name, sizeof(out->name));
+        out->parent = zones[i].parent;
+        out->lane = (uint32_t)zones[i].lane;
+        out->depth = (uint32_t)zones[i].depth;
+        out->call_count = (uint32_t)zones[i].call_count;
+        out->total_ms = zones[i].total_ms;
+        out->self_ms = zones[i].self_ms;
+    }
+}
+
+static void build_renderer_stats(StatsShmFrame *const frame) {
+    const RendererFrameStats *const stats = Renderer_GetFrameStats();
+
+    frame->queue_count = 0;
+    for (RendererStatsQueueKind queue = 0;
+         queue < RENDERER_STATS_QUEUE_COUNT && frame->queue_count < STATS_SHM_MAX_QUEUES;
+         queue++) {
+        StatsShmQueue *const out = &frame->queues[frame->queue_count++];
+        SDL_strlcpy(out->name, Renderer_GetStatsQueueName(queue), sizeof(out->name));
+        out->cmd_count = stats->queues[queue].cmd_count;
+        out->draw_calls = stats->queues[queue].draw_calls;
+    }
+
+    frame->stream_count = 0;
+    for (RendererStatsStreamKind stream = 0;
+         stream < RENDERER_STATS_STREAM_COUNT && frame->stream_count < STATS_SHM_MAX_STREAMS;
+         stream++) {
+        StatsShmStream *const out = &frame->streams[frame->stream_count++];
+        SDL_strlcpy(out->name, Renderer_GetStatsStreamName(stream), sizeof(out->name));
+        out->used_bytes = stats->streams[stream].used_bytes;
+        out->peak_bytes = stats->streams[stream].peak_bytes;
+        out->capacity_bytes = stats->streams[stream].capacity_bytes;
+    }
+
+    frame->swapchain_acquire_ms = stats->timing.swapchain_acquire_ms;
+    frame->submit_ms = stats->timing.submit_ms;
+}
+
+void STATS_exportPublish(void) {
+    StatsShm *const shm = stats_export.shm;
+    if (!shm) {
+        return;
+    }
+
+    StatsShmFrame *const frame = &stats_export.staging;
+    frame->frame_index = stats_export.frame_index++;
+    build_profiler_stats(frame);
+    build_renderer_stats(frame);
+    frame->sim = stats_export.sim;
+
+    // seqlock write: odd while the frame is inconsistent
+    const uint32_t sequence = atomic_load_explicit(&shm->sequence, memory_order_relaxed);
+    atomic_store_explicit(&shm->sequence, sequence + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    SDL_memcpy(&shm->frame, frame, sizeof(*frame));
+    atomic_store_explicit(&shm->sequence, sequence + 2u, memory_order_release);
+}
@@ -0,0 +1,35 @@
+#ifndef MISO_STATS_EXPORT_H
+#define MISO_STATS_EXPORT_H
+
+#include "stats_shm.h"
+
+// Publishes per-frame profiler, renderer and sim stats to a POSIX shared-memory segment (layout in stats_shm.h) for
+// external monitors such as tools/miso_stats_reader. Publishing is plain memory writes: no syscalls, no rendering.
+
+/**
+ * Creates (or reuses) the shared-memory segment and maps it.
+ * @param name segment name starting with '/', NULL uses STATS_SHM_DEFAULT_NAME.
+ * @return false if shared memory is unavailable on this platform or the segment could not be created.
+ */
+bool STATS_exportOpen(const char *name);
+
+/**
+ * Unmaps and unlinks the segment. Readers that still have it mapped keep the last published frame.
+ */
+void STATS_exportClose(void);
+
+bool STATS_exportIsOpen(void);
+
+/**
+ * Sets the sim numbers included by the following STATS_exportPublish() calls.
+ * Publishers without a fixed-step simulation never call it and the segment's sim block stays invalid.
+ */
+void STATS_exportSetSim(const StatsShmSim *sim);
+
+/**
+ * Copies the last finished frame's stats into the segment. Call once per frame, after PROF_frameEnd().
+ * Does nothing if the segment is not open.
+ */
+void STATS_exportPublish(void);
+
+#endif //MISO_STATS_EXPORT_H
@@ -0,0 +1,137 @@
+#ifndef MISO_STATS_SHM_H
+#define MISO_STATS_SHM_H
+
+// Layout of the live stats shared-memory segment, shared by the engine (stats_export.c) and external readers
+// (tools/miso_stats_reader.c). Plain C, no SDL, so readers do not need to link against the engine.
+//
+// The writer updates the segment once per frame under a seqlock: sequence is odd while a frame is being written.
+// Readers copy the frame and retry if the sequence was odd or changed during the copy (see stats_shm_read()).
+// Bump STATS_SHM_VERSION on any layout change.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define STATS_SHM_MAGIC 0x4F53494Du // "MISO"
+#define STATS_SHM_VERSION 2u
+#define STATS_SHM_DEFAULT_NAME "/miso_stats" // keep under 31 chars, the macOS limit
+
+#define STATS_SHM_NAME_LENGTH 32
+#define STATS_SHM_MAX_CATEGORIES 16
+#define STATS_SHM_MAX_LANES 16
+#define STATS_SHM_MAX_ZONES 64
+#define STATS_SHM_MAX_QUEUES 16
+#define STATS_SHM_MAX_STREAMS 16
+
+typedef struct StatsShmCategory {
+    char name[STATS_SHM_NAME_LENGTH];
+    float ms;
+    float p99_ms;
+} StatsShmCategory;
+
+typedef struct StatsShmLane {
+    char name[STATS_SHM_NAME_LENGTH];
+    float busy_ms;
+    float utilization;
+} StatsShmLane;
+
+typedef struct StatsShmZone {
+    char name[STATS_SHM_NAME_LENGTH];
+    int32_t parent; // index into zones, -1 for roots
+    uint32_t lane;
+    uint32_t depth;
+    uint32_t call_count;
+    float total_ms;
+    float self_ms;
+} StatsShmZone;
+
+typedef struct StatsShmQueue {
+    char name[STATS_SHM_NAME_LENGTH];
+    uint32_t cmd_count;
+    uint32_t draw_calls;
+} StatsShmQueue;
+
+typedef struct StatsShmStream {
+    char name[STATS_SHM_NAME_LENGTH];
+    uint32_t used_bytes;
+    uint32_t peak_bytes;
+    uint32_t capacity_bytes;
+} StatsShmStream;
+
+typedef struct StatsShmSim {
+    uint32_t valid; // 0 when the publisher has no fixed-step simulation
+    uint32_t steps_last_frame;
+    uint64_t tick_count;
+    float sim_ms_last_frame;
+    float dropped_ms_last_frame;
+    double dropped_seconds_total;
+    uint32_t frames_dropped;
+    uint32_t behind;
+} StatsShmSim;
+
+typedef struct StatsShmFrame {
+    uint64_t frame_index; // frames published since the segment was opened
+    float frame_ms;
+    float fps_min;
+    float fps_avg;
+    float fps_max;
+    float p50_ms;
+    float p95_ms;
+    float p99_ms;
+    float p999_ms;
+    float max_ms;
+
+    uint32_t category_count;
+    uint32_t lane_count;
+    uint32_t zone_count;
+    uint32_t queue_count;
+    uint32_t stream_count;
+    StatsShmCategory categories[STATS_SHM_MAX_CATEGORIES];
+    StatsShmLane lanes[STATS_SHM_MAX_LANES];
+    StatsShmZone zones[STATS_SHM_MAX_ZONES];
+    StatsShmQueue queues[STATS_SHM_MAX_QUEUES];
+    StatsShmStream streams[STATS_SHM_MAX_STREAMS];
+
+    float swapchain_acquire_ms;
+    float submit_ms;
+    StatsShmSim sim;
+} StatsShmFrame;
+
+typedef struct StatsShm {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size; // sizeof(StatsShm) of the writer
+    uint32_t writer_pid;
+    _Atomic uint32_t sequence;
+    uint32_t reserved;
+    StatsShmFrame frame;
+} StatsShm;
+
+static inline bool stats_shm_is_compatible(const StatsShm *const shm) {
+    return shm->magic == STATS_SHM_MAGIC && shm->version == STATS_SHM_VERSION && shm->size == sizeof(StatsShm);
+}
+
+/**
+ * Copies a consistent frame out of the segment.
+ * @return false if the writer kept updating it for max_attempts tries, or nothing was published yet.
+ */
+static inline bool stats_shm_read(const StatsShm *const shm, StatsShmFrame *const out, const int max_attempts) {
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+        const uint32_t before = atomic_load_explicit(&shm->sequence, memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1u) {
+            continue;
+        }
+        memcpy(out, (const void *)&shm->frame, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&shm->sequence, memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif //MISO_STATS_SHM_H
@@ -1,56 +1,126 @@
 #include "tilemap.h"
 
+#include "../memtrack.h"
+#include "../profiler.h"
 #include "../renderer/renderer.h"
 
-#include <SDL3_image/SDL_image.h>
-
 // =============================================================================
 // Tileset Implementation
 // =============================================================================
 
+static void tileset_set_image_size(Tileset *const tileset, const int width, const int height) {
+    tileset->texture_width = (unsigned int)width;
+    tileset->texture_height = (unsigned int)height;
+    tileset->columns = (unsigned int)width / tileset->tile_width;
+    tileset->rows = (unsigned int)height / tileset->tile_height;
+    tileset->total_tiles = tileset->columns * tileset->rows;
+
+    SDL_Log("Loaded tileset: %ux%u tiles, %u columns, %u rows, %u total tiles",
+            tileset->tile_width,
+            tileset->tile_height,
+            tileset->columns,
+            tileset->rows,
+            tileset->total_tiles);
+}
+
 Tileset *Tileset_Load(const char *const image_path, const unsigned int tile_width, const unsigned int tile_height) {
-    Tileset *const tileset = SDL_malloc(sizeof(Tileset));
+    Tileset *const tileset = SDL_calloc(1, sizeof(Tileset));
     if (!tileset) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate memory for tileset");
         return nullptr;
     }
+    tileset->tile_width = tile_width;
+    tileset->tile_height = tile_height;
 
-    // Load texture via renderer
-    tileset->texture = Renderer_LoadTexture(image_path);
+    // Load texture via renderer, its size comes from the same decode, mipmapped per tile for zoomed out views
+    int width = 0;
+    int height = 0;
+    tileset->texture =
+        Renderer_LoadTextureMipmapped(image_path, (int)tile_width, (int)tile_height, &width, &height);
     if (!tileset->texture) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture from %s", image_path);
         SDL_free(tileset);
         return nullptr;
     }
 
-    // Load image to get dimensions (init time only, acceptable overhead)
-    SDL_Surface *const surface = IMG_Load(image_path);
-    if (surface) {
-        tileset->columns = (unsigned int)surface->w / tile_width;
-        tileset->rows = (unsigned int)surface->h / tile_height;
-        SDL_DestroySurface(surface);
-    } else {
-        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Could not load image for dimensions: %s", image_path);
-        tileset->columns = 0;
-        tileset->rows = 0;
-    }
+    tileset_set_image_size(tileset, width, height);
+    return tileset;
+}
 
+Tileset *Tileset_LoadAsync(const char *const image_path, const unsigned int tile_width, const unsigned int tile_height) {
+    Tileset *const tileset = SDL_calloc(1, sizeof(Tileset));
+    if (!tileset) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate memory for tileset");
+        return nullptr;
+    }
     tileset->tile_width = tile_width;
     tileset->tile_height = tile_height;
-    tileset->total_tiles = tileset->columns * tileset->rows;
-
-    SDL_Log("Loaded tileset: %ux%u tiles, %u columns, %u rows, %u total tiles",
-            tile_width,
-            tile_height,
-            tileset->columns,
-            tileset->rows,
-            tileset->total_tiles);
 
+    tileset->pending_load = Renderer_LoadTextureMipmappedAsync(image_path, (int)tile_width, (int)tile_height);
+    if (!tileset->pending_load) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to start loading %s", image_path);
+        SDL_free(tileset);
+        return nullptr;
+    }
     return tileset;
 }
 
+// Applies a settled load's result, returns whether the tileset is usable
+static bool tileset_finish_load(Tileset *const tileset,
+                                const RendererTextureLoadStatus status,
+                                SDL_GPUTexture *const texture,
+                                const int width,
+                                const int height) {
+    if (status == RENDERER_TEXTURE_LOAD_PENDING) {
+        return false;
+    }
+    tileset->pending_load = 0;
+    if (status == RENDERER_TEXTURE_LOAD_FAILED) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load tileset texture");
+        return false;
+    }
+    tileset->texture = texture;
+    tileset_set_image_size(tileset, width, height);
+    return true;
+}
+
+bool Tileset_IsReady(Tileset *const tileset) {
+    if (!tileset) {
+        return false;
+    }
+    if (!tileset->pending_load) {
+        return tileset->texture != nullptr;
+    }
+
+    SDL_GPUTexture *texture = nullptr;
+    int width = 0;
+    int height = 0;
+    const RendererTextureLoadStatus status =
+        Renderer_PollTextureLoad(tileset->pending_load, &texture, &width, &height);
+    return tileset_finish_load(tileset, status, texture, width, height);
+}
+
+bool Tileset_WaitReady(Tileset *const tileset) {
+    if (!tileset) {
+        return false;
+    }
+    if (!tileset->pending_load) {
+        return tileset->texture != nullptr;
+    }
+
+    SDL_GPUTexture *texture = nullptr;
+    int width = 0;
+    int height = 0;
+    const RendererTextureLoadStatus status =
+        Renderer_WaitTextureLoad(tileset->pending_load, &texture, &width, &height);
+    return tileset_finish_load(tileset, status, texture, width, height);
+}
+
 void Tileset_Destroy(Tileset *const tileset) {
-    if (tileset) {
+    if (tileset && !tileset->in_array) {
+        if (tileset->pending_load) {
+            Renderer_CancelTextureLoad(tileset->pending_load);
+        }
         if (tileset->texture) {
             Renderer_DestroyTexture(tileset->texture);
         }
@@ -58,6 +128,64 @@ void Tileset_Destroy(Tileset *const tileset) {
     }
 }
 
+TilesetArray *TilesetArray_Load(const char *const *const image_paths,
+                                const unsigned int count,
+                                const unsigned int tile_width,
+                                const unsigned int tile_height) {
+    MEM_TAG(MEM_TAG_TILEMAP);
+    if (!image_paths || count == 0) {
+        return nullptr;
+    }
+    TilesetArray *const array = SDL_calloc(1, sizeof(TilesetArray));
+    SDL_Point *const sizes = SDL_calloc(count, sizeof(SDL_Point));
+    if (array) {
+        array->tilesets = SDL_calloc(count, sizeof(Tileset));
+    }
+    if (!array || !sizes || !array->tilesets) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate memory for tileset array");
+        SDL_free(sizes);
+        TilesetArray_Destroy(array);
+        return nullptr;
+    }
+
+    int layer_w = 0;
+    int layer_h = 0;
+    array->texture = Renderer_LoadTextureArray(
+        image_paths, (int)count, (int)tile_width, (int)tile_height, &layer_w, &layer_h, sizes);
+    if (!array->texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture array from %u tilesets", count);
+        SDL_free(sizes);
+        TilesetArray_Destroy(array);
+        return nullptr;
+    }
+
+    array->count = count;
+    for (unsigned int i = 0; i < count; i++) {
+        Tileset *const tileset = &array->tilesets[i];
+        tileset->texture = array->texture;
+        tileset->tile_width = tile_width;
+        tileset->tile_height = tile_height;
+        tileset->layer = i;
+        tileset->in_array = true;
+        tileset_set_image_size(tileset, sizes[i].x, sizes[i].y);
+        // UVs are relative to the layer, which is only as large as the largest sheet
+        tileset->texture_width = (unsigned int)layer_w;
+        tileset->texture_height = (unsigned int)layer_h;
+    }
+    SDL_free(sizes);
+    return array;
+}
+
+void TilesetArray_Destroy(TilesetArray *const array) {
+    if (array) {
+        if (array->texture) {
+            Renderer_DestroyTexture(array->texture);
+        }
+        SDL_free(array->tilesets);
+        SDL_free(array);
+    }
+}
+
 // =============================================================================
 // Tilemap Implementation
 // =============================================================================
@@ -108,6 +236,8 @@ Tilemap *Tilemap_Create(const int width, const int height, Tileset *const tilese
     tilemap->width = width;
     tilemap->height = height;
     tilemap->tileset = tileset;
+    tilemap->instances = nullptr;
+    tilemap->instance_capacity = 0;
 
     SDL_Log("Created tilemap: %dx%d tiles", width, height);
     return tilemap;
@@ -118,6 +248,7 @@ void Tilemap_Destroy(Tilemap *const tilemap) {
         SDL_free(tilemap->tiles);
         SDL_free(tilemap->flags);
         SDL_free(tilemap->occupied);
+        SDL_free(tilemap->instances);
         SDL_free(tilemap);
     }
 }
@@ -206,10 +337,12 @@ SDL_Point Tilemap_ScreenToTile(const Tilemap *const tilemap, const float screen_
 // Rendering
 // =============================================================================
 
-void Tilemap_Render(const Tilemap *const tilemap) {
+void Tilemap_Render(Tilemap *const tilemap) {
     if (!tilemap || !tilemap->tileset || !tilemap->tileset->texture) {
         return;
     }
+    PROF_ZONE("Tilemap_Render");
+    MEM_TAG(MEM_TAG_TILEMAP);
 
     const float tile_w = (float)tilemap->tileset->tile_width;
     const float tile_h = (float)tilemap->tileset->tile_height;
@@ -220,21 +353,32 @@ void Tilemap_Render(const Tilemap *const tilemap) {
     const float start_x = ((float)(tilemap->height - 1) * iso_w) / 2.0f;
     const float start_y = 0.0f;
 
-    // Allocate instances for all tiles
+    // Instances for all tiles, with their layer when the tileset lives in a texture array. The scratch buffer is kept
+    // between frames and only grows, e.g. when the tileset moves into an array and instances get wider.
+    const bool layered = tilemap->tileset->in_array;
+    const float layer = (float)tilemap->tileset->layer;
     const int max_tiles = tilemap->width * tilemap->height;
-    SpriteInstance *const instances = SDL_malloc(sizeof(SpriteInstance) * (size_t)max_tiles);
-    if (!instances) {
-        SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to allocate sprite instances");
-        return;
+    const size_t instance_size = layered ? sizeof(SpriteLayerInstance) : sizeof(SpriteInstance);
+    const size_t instance_bytes = instance_size * (size_t)max_tiles;
+    if (tilemap->instance_capacity < instance_bytes) {
+        void *const grown = SDL_realloc(tilemap->instances, instance_bytes);
+        if (!grown) {
+            SDL_LogError(SDL_LOG_CATEGORY_RENDER, "Failed to allocate sprite instances");
+            return;
+        }
+        tilemap->instances = grown;
+        tilemap->instance_capacity = instance_bytes;
     }
+    void *const instances = tilemap->instances;
 
     int instance_count = 0;
 
     // Texture dimensions for UV calculation
-    const float tex_w = (float)(tilemap->tileset->columns * tilemap->tileset->tile_width);
-    const float tex_h = (float)(tilemap->tileset->rows * tilemap->tileset->tile_height);
+    const float tex_w = (float)tilemap->tileset->texture_width;
+    const float tex_h = (float)tilemap->tileset->texture_height;
 
     // Build sprite instances for all tiles
+    PROF_ZONE_BEGIN("build_instances");
     for (int y = 0; y < tilemap->height; y++) {
         for (int x = 0; x < tilemap->width; x++) {
             const int idx = y * tilemap->width + x;
@@ -265,22 +409,36 @@ void Tilemap_Render(const Tilemap *const tilemap) {
 
             // Tile position for wave phase calculation (passed as extra data)
             // We pack tile_x and tile_y into the unused padding fields
-            instances[instance_count++] =
-                (SpriteInstance){.x = iso_x,
-                                 .y = iso_y,
-                                 .z = depth,
-                                 .flags = is_water, // flags field: 1.0 = water, 0.0 = not water
-                                 .w = tile_w,
-                                 .h = tile_h,
-                                 .tile_x = (float)x, // for wave phase calculation
-                                 .tile_y = (float)y, // for wave phase calculation
-                                 .u = u,
-                                 .v = v,
-                                 .uw = uw,
-                                 .vh = vh};
+            const SpriteInstance instance = {.x = iso_x,
+                                             .y = iso_y,
+                                             .z = depth,
+                                             .flags = is_water, // flags field: 1.0 = water, 0.0 = not water
+                                             .w = tile_w,
+                                             .h = tile_h,
+                                             .tile_x = (float)x, // for wave phase calculation
+                                             .tile_y = (float)y, // for wave phase calculation
+                                             .u = u,
+                                             .v = v,
+                                             .uw = uw,
+                                             .vh = vh};
+            if (layered) {
+                ((SpriteLayerInstance *)instances)[instance_count++] =
+                    (SpriteLayerInstance){.sprite = instance, .layer = layer};
+            } else {
+                ((SpriteInstance *)instances)[instance_count++] = instance;
+            }
         }
     }
+    PROF_ZONE_END();
+
+    PROF_counterAdd("instances_built", instance_count);
+    PROF_counterAdd("tiles_skipped", max_tiles - instance_count);
 
-    Renderer_DrawSprites(tilemap->tileset->texture, instances, instance_count);
-    SDL_free(instances);
+    PROF_ZONE_BEGIN("submit");
+    if (layered) {
+        Renderer_DrawLayeredSprites(tilemap->tileset->texture, instances, instance_count);
+    } else {
+        Renderer_DrawSprites(tilemap->tileset->texture, instances, instance_count);
+    }
+    PROF_ZONE_END();
 }
@@ -28,12 +28,17 @@
  * left-to-right, top-to-bottom starting from 0.
  */
 typedef struct Tileset {
-    SDL_GPUTexture *texture;  ///< GPU texture handle (owned)
-    unsigned int tile_width;  ///< Width of each tile in pixels
-    unsigned int tile_height; ///< Height of each tile in pixels
-    unsigned int columns;     ///< Number of columns in the tileset image
-    unsigned int rows;        ///< Number of rows in the tileset image
-    unsigned int total_tiles; ///< Total number of tiles (columns * rows)
+    SDL_GPUTexture *texture;     ///< GPU texture handle (owned), or the shared texture array of a TilesetArray
+    unsigned int tile_width;     ///< Width of each tile in pixels
+    unsigned int tile_height;    ///< Height of each tile in pixels
+    unsigned int columns;        ///< Number of columns in the tileset image
+    unsigned int rows;           ///< Number of rows in the tileset image
+    unsigned int total_tiles;    ///< Total number of tiles (columns * rows)
+    unsigned int texture_width;  ///< Size UVs are relative to: the image's, or the array layer's for a TilesetArray
+    unsigned int texture_height;
+    unsigned int layer;          ///< Texture array layer of the image when in_array is set
+    bool in_array;               ///< Part of a TilesetArray: drawn with Renderer_DrawLayeredSprites()
+    Uint32 pending_load;         ///< RendererTextureLoad in flight for Tileset_LoadAsync(), 0 once settled
 } Tileset;
 
 /**
@@ -51,12 +56,67 @@ typedef struct Tileset {
  */
 Tileset *Tileset_Load(const char *image_path, unsigned int tile_width, unsigned int tile_height);
 
+/**
+ * @brief Start loading a tileset in the background (see Renderer_LoadTextureAsync()).
+ *
+ * The tileset is returned right away with no texture and no tiles: Tilemap_Render() skips it until
+ * Tileset_IsReady() or Tileset_WaitReady() has filled them in.
+ *
+ * @return Pointer to the pending tileset, or NULL if the load could not be started.
+ */
+Tileset *Tileset_LoadAsync(const char *image_path, unsigned int tile_width, unsigned int tile_height);
+
+/**
+ * @brief Poll a tileset started with Tileset_LoadAsync() without blocking.
+ * @return true once the texture and tile counts are in, false while loading or if the load failed.
+ */
+bool Tileset_IsReady(Tileset *tileset);
+
+/**
+ * @brief Block until a tileset started with Tileset_LoadAsync() is loaded, uploading it immediately.
+ * @return true if the tileset is usable, false if the load failed.
+ */
+bool Tileset_WaitReady(Tileset *tileset);
+
 /**
  * @brief Destroy a tileset and free its GPU resources.
  * @param tileset The tileset to destroy (may be NULL).
  */
 void Tileset_Destroy(Tileset *tileset);
 
+/**
+ * @brief Several tilesets loaded into the layers of one texture array.
+ *
+ * Every tileset of the array shares its texture, so sprites from all of them (tiles, buildings, decorations, units)
+ * can be drawn in a single instanced call with Renderer_DrawLayeredSprites(), each instance naming its tileset's
+ * layer. Tilemap_Render() does this on its own for a tilemap using one of these tilesets.
+ */
+typedef struct TilesetArray {
+    SDL_GPUTexture *texture; ///< 2D texture array, one sheet per layer (owned)
+    Tileset *tilesets;       ///< [count], tilesets[i] is image_paths[i] in layer i (owned, not for Tileset_Destroy())
+    unsigned int count;
+} TilesetArray;
+
+/**
+ * @brief Load tileset images into one texture array, all cut into tiles of the same size.
+ *
+ * @param image_paths Paths of the tileset images, image_paths[i] becomes layer i.
+ * @param count       Number of images.
+ * @return Pointer to the loaded array, or NULL on failure.
+ *
+ * @note The caller is responsible for calling TilesetArray_Destroy() when done.
+ */
+TilesetArray *TilesetArray_Load(const char *const *image_paths,
+                                unsigned int count,
+                                unsigned int tile_width,
+                                unsigned int tile_height);
+
+/**
+ * @brief Destroy a tileset array, its tilesets and its texture.
+ * @param array The array to destroy (may be NULL).
+ */
+void TilesetArray_Destroy(TilesetArray *array);
+
 // =============================================================================
 // Tilemap - isometric tile-based map
 // =============================================================================
@@ -81,12 +141,14 @@ typedef enum TileFlags {
  * [width * height] and indexed as [y * width + x].
  */
 typedef struct Tilemap {
-    int *tiles;       ///< Tile indices [width * height] (owned)
-    uint8_t *flags;   ///< Per-tile flags [width * height] (owned)
-    bool *occupied;   ///< Building occupancy [width * height] (owned)
-    int width;        ///< Map width in tiles
-    int height;       ///< Map height in tiles
-    Tileset *tileset; ///< Reference to the tileset (not owned)
+    int *tiles;               ///< Tile indices [width * height] (owned)
+    uint8_t *flags;           ///< Per-tile flags [width * height] (owned)
+    bool *occupied;           ///< Building occupancy [width * height] (owned)
+    int width;                ///< Map width in tiles
+    int height;               ///< Map height in tiles
+    Tileset *tileset;         ///< Reference to the tileset (not owned)
+    void *instances;          ///< Sprite instance scratch reused by Tilemap_Render() (owned)
+    size_t instance_capacity; ///< Size of instances in bytes
 } Tilemap;
 
 /**
@@ -207,7 +269,7 @@ SDL_Point Tilemap_ScreenToTile(const Tilemap *tilemap, float screen_x, float scr
  *
  * @see Renderer_SetWaterParams() for water animation configuration.
  */
-void Tilemap_Render(const Tilemap *tilemap);
+void Tilemap_Render(Tilemap *tilemap);
 
 // =============================================================================
 // Isometric Helpers (exposed for game code that needs them)
@@ -0,0 +1,110 @@
+// Cooks a source image into a .mtex blob (see cooked_texture.h) that the renderer maps and uploads without decoding.
+//
+// usage: asset_cook [--tile WxH] input output.mtex
+//
+// Run by the cook_assets target at build time, so the game never pays PNG decompression or pixel format conversion.
+// --tile checks the image against the tileset grid it is used with and records it in the blob.
+
+#include "../cooked_texture.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void usage(void) {
+    fprintf(stderr, "usage: asset_cook [--tile WxH] input output%s\n", COOKED_TEXTURE_EXTENSION);
+}
+
+static bool write_blob(const char *const path,
+                       const SDL_Surface *const surface,
+                       const uint32_t tile_w,
+                       const uint32_t tile_h) {
+    const uint32_t pitch = (uint32_t)surface->w * 4u;
+    const CookedTextureHeader header = {
+        .magic = COOKED_TEXTURE_MAGIC,
+        .version = COOKED_TEXTURE_VERSION,
+        .format = COOKED_TEXTURE_FORMAT_RGBA8,
+        .width = (uint32_t)surface->w,
+        .height = (uint32_t)surface->h,
+        .pitch = pitch,
+        .tile_width = tile_w,
+        .tile_height = tile_h,
+        .data_offset = COOKED_TEXTURE_DATA_ALIGN,
+        .data_size = (uint64_t)pitch * (uint64_t)surface->h,
+    };
+
+    FILE *const file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "asset_cook: cannot open %s for writing\n", path);
+        return false;
+    }
+
+    static const uint8_t padding[COOKED_TEXTURE_DATA_ALIGN] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(padding, COOKED_TEXTURE_DATA_ALIGN - sizeof(header), 1, file) == 1;
+    for (int y = 0; ok && y < surface->h; y++) {
+        // rows are written tightly packed, whatever the surface's pitch
+        const uint8_t *const row = (const uint8_t *)surface->pixels + (size_t)surface->pitch * (size_t)y;
+        ok = fwrite(row, pitch, 1, file) == 1;
+    }
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "asset_cook: failed to write %s\n", path);
+        remove(path); // never leave a truncated blob for the game to map
+    }
+    return ok;
+}
+
+int main(const int argc, char **const argv) {
+    uint32_t tile_w = 0;
+    uint32_t tile_h = 0;
+    int arg = 1;
+    if (arg < argc && SDL_strcmp(argv[arg], "--tile") == 0) {
+        if (arg + 1 >= argc || SDL_sscanf(argv[arg + 1], "%ux%u", &tile_w, &tile_h) != 2 || tile_w == 0 ||
+            tile_h == 0) {
+            usage();
+            return EXIT_FAILURE;
+        }
+        arg += 2;
+    }
+    if (argc - arg != 2) {
+        usage();
+        return EXIT_FAILURE;
+    }
+    const char *const input = argv[arg];
+    const char *const output = argv[arg + 1];
+
+    SDL_Surface *const loaded = IMG_Load(input);
+    if (!loaded) {
+        fprintf(stderr, "asset_cook: cannot load %s: %s\n", input, SDL_GetError());
+        return EXIT_FAILURE;
+    }
+    SDL_Surface *const rgba = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(loaded);
+    if (!rgba) {
+        fprintf(stderr, "asset_cook: cannot convert %s: %s\n", input, SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    if (tile_w && ((uint32_t)rgba->w % tile_w != 0 || (uint32_t)rgba->h % tile_h != 0)) {
+        fprintf(stderr,
+                "asset_cook: %s is %dx%d, not a whole number of %ux%u tiles\n",
+                input,
+                rgba->w,
+                rgba->h,
+                tile_w,
+                tile_h);
+        SDL_DestroySurface(rgba);
+        return EXIT_FAILURE;
+    }
+
+    const bool ok = write_blob(output, rgba, tile_w, tile_h);
+    if (ok) {
+        printf("asset_cook: %s -> %s (%dx%d RGBA8)\n", input, output, rgba->w, rgba->h);
+    }
+    SDL_DestroySurface(rgba);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,175 @@
+// Prints the live stats a running miso publishes to shared memory (see stats_shm.h).
+//
+// usage: miso_stats_reader [--once] [--interval ms] [name]
+//
+// Plain POSIX, it does not link against SDL or the engine and never touches the game's process beyond reading the
+// segment, so it can watch soak tests without perturbing them.
+
+#define _POSIX_C_SOURCE 200809L // shm_open, nanosleep
+
+#include "../stats_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define READ_ATTEMPTS 64
+#define ONCE_MAX_POLLS 100 // --once gives up after ~1 s without a published frame
+
+static void sleep_ms(const long ms) {
+    struct timespec duration = {.tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L};
+    while (nanosleep(&duration, &duration) != 0 && errno == EINTR) {
+    }
+}
+
+static void print_frame(const StatsShmFrame *const frame, const uint32_t writer_pid) {
+    printf("pid %u  frame %llu  %.2f ms  fps %.1f (min %.1f max %.1f)\n",
+           writer_pid,
+           (unsigned long long)frame->frame_index,
+           (double)frame->frame_ms,
+           (double)frame->fps_avg,
+           (double)frame->fps_min,
+           (double)frame->fps_max);
+    printf("  p50 %.2f  p95 %.2f  p99 %.2f  p99.9 %.2f  max %.2f ms\n",
+           (double)frame->p50_ms,
+           (double)frame->p95_ms,
+           (double)frame->p99_ms,
+           (double)frame->p999_ms,
+           (double)frame->max_ms);
+
+    printf("  categories:\n");
+    for (uint32_t i = 0; i < frame->category_count && i < STATS_SHM_MAX_CATEGORIES; i++) {
+        const StatsShmCategory *const category = &frame->categories[i];
+        printf("    %-20s %7.2f ms  p99 %7.2f\n", category->name, (double)category->ms, (double)category->p99_ms);
+    }
+
+    if (frame->sim.valid) {
+        printf("  sim: tick %llu  %u steps  %.2f ms  dropped %.2f ms (%.2f s total, %u frames)%s\n",
+               (unsigned long long)frame->sim.tick_count,
+               frame->sim.steps_last_frame,
+               (double)frame->sim.sim_ms_last_frame,
+               (double)frame->sim.dropped_ms_last_frame,
+               frame->sim.dropped_seconds_total,
+               frame->sim.frames_dropped,
+               frame->sim.behind ? "  BEHIND" : "");
+    }
+
+    printf("  lanes:\n");
+    for (uint32_t i = 0; i < frame->lane_count && i < STATS_SHM_MAX_LANES; i++) {
+        const StatsShmLane *const lane = &frame->lanes[i];
+        printf("    %-20s busy %7.2f ms (%3.0f%%)\n",
+               lane->name,
+               (double)lane->busy_ms,
+               (double)lane->utilization * 100.0);
+    }
+
+    printf("  zones:\n");
+    for (uint32_t i = 0; i < frame->zone_count && i < STATS_SHM_MAX_ZONES; i++) {
+        const StatsShmZone *const zone = &frame->zones[i];
+        printf("    %*s%-*s %7.2f ms  self %7.2f  x%u\n",
+               (int)zone->depth * 2,
+               "",
+               20 - (int)zone->depth * 2 > 0 ? 20 - (int)zone->depth * 2 : 0,
+               zone->name,
+               (double)zone->total_ms,
+               (double)zone->self_ms,
+               zone->call_count);
+    }
+
+    printf("  queues:\n");
+    for (uint32_t i = 0; i < frame->queue_count && i < STATS_SHM_MAX_QUEUES; i++) {
+        const StatsShmQueue *const queue = &frame->queues[i];
+        printf("    %-20s %5u cmds %5u draws\n", queue->name, queue->cmd_count, queue->draw_calls);
+    }
+
+    printf("  streams:\n");
+    for (uint32_t i = 0; i < frame->stream_count && i < STATS_SHM_MAX_STREAMS; i++) {
+        const StatsShmStream *const stream = &frame->streams[i];
+        printf("    %-20s %8u / %8u bytes (peak %u)\n",
+               stream->name,
+               stream->used_bytes,
+               stream->capacity_bytes,
+               stream->peak_bytes);
+    }
+    printf("  swapchain acquire %.2f ms  submit %.2f ms\n\n",
+           (double)frame->swapchain_acquire_ms,
+           (double)frame->submit_ms);
+    fflush(stdout);
+}
+
+int main(const int argc, char **const argv) {
+    const char *name = STATS_SHM_DEFAULT_NAME;
+    bool once = false;
+    long interval_ms = 500;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--once") == 0) {
+            once = true;
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval_ms = strtol(argv[++i], nullptr, 10);
+            interval_ms = interval_ms > 0 ? interval_ms : 500;
+        } else if (argv[i][0] == '/') {
+            name = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [--once] [--interval ms] [name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "no stats segment %s, is miso running with the stats export enabled?\n", name);
+        return 1;
+    }
+    struct stat segment;
+    if (fstat(fd, &segment) != 0 || segment.st_size < (off_t)sizeof(StatsShm)) {
+        fprintf(stderr, "%s is smaller than this reader's layout, rebuild the reader\n", name);
+        close(fd);
+        return 1;
+    }
+    const void *const mapping = mmap(nullptr, sizeof(StatsShm), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "failed to map %s\n", name);
+        return 1;
+    }
+
+    const StatsShm *const shm = mapping;
+    if (!stats_shm_is_compatible(shm)) {
+        fprintf(stderr,
+                "%s has an incompatible layout (version %u, size %u; expected version %u, size %zu)\n",
+                name,
+                shm->version,
+                shm->size,
+                STATS_SHM_VERSION,
+                sizeof(StatsShm));
+        munmap((void *)mapping, sizeof(StatsShm));
+        return 1;
+    }
+
+    static StatsShmFrame frame;
+    uint64_t last_index = UINT64_MAX;
+    int result = 0;
+    for (int polls = 0;; polls++) {
+        if (stats_shm_read(shm, &frame, READ_ATTEMPTS) && frame.frame_index != last_index) {
+            last_index = frame.frame_index;
+            print_frame(&frame, shm->writer_pid);
+            if (once) {
+                break;
+            }
+        }
+        if (once && polls >= ONCE_MAX_POLLS) {
+            fprintf(stderr, "nothing published to %s\n", name);
+            result = 1;
+            break;
+        }
+        sleep_ms(once ? 10 : interval_ms);
+    }
+
+    munmap((void *)mapping, sizeof(StatsShm));
+    return result;
+}